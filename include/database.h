@@ -5,14 +5,54 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include "money.h"
 
 extern sqlite3 *db;
 
 int db_init(const char *db_path);
+int db_set_profile(const char *name);      // call before db_init(): "tuned" or "safe"
+const char* db_get_profile_name(void);
 void db_close();
 const char* db_get_error();
 const char* db_payroll_get_error();
 
+// Prepared statement registry (db_init.c)
+sqlite3_stmt* db_stmt_acquire(const char *sql);
+sqlite3_stmt* db_stmt_acquire_scan(const char *sql);   // whole-table read by design
+void db_stmt_release(sqlite3_stmt *stmt);
+void db_stmt_print_stats(void);
+void db_stmt_foreach(int (*fn)(const char *sql, int scan_ok, void *ctx), void *ctx);
+
+// Query plan check (db_query_plan.c) - return the number of plans that
+// fall back to a full table scan
+int db_check_query_plans(void);          // statements in the registry
+int db_run_query_plan_check(void);       // seeds the open database and checks every hot query
+
+// Listing queries, shared with the background loader (db_async.c) and the
+// tables' virtual models (db_tree_model.c)
+extern const char db_student_list_sql[];        // db_student.c
+extern const char db_student_index_sql[];       // db_student.c, feeds student_index.c
+extern const char db_employee_list_sql[];       // db_employee.c
+extern const char db_payroll_list_sql[];        // db_payroll.c
+extern const char db_fee_summary_list_sql[];    // db_fee.c
+extern const char db_fee_summary_page_sql[];    // db_fee.c, keyset page of the above
+
+// Full-text search index (db_init.c)
+int db_create_search_index(void);
+// Builds a missing index on a worker thread (own connection); on_ready runs
+// on the main loop, or right away when there was nothing to build
+typedef void (*DbSearchIndexReadyFunc)(int ok, void *user_data);
+void db_create_search_index_async(DbSearchIndexReadyFunc on_ready, void *user_data);
+int db_search_match_expr(const char *text, char *out, size_t out_size);
+
+// Transactions (db_init.c) - return 1 on success, 0 on failure. Nested
+// calls are savepoints. A failed commit has already rolled its own level
+// back: callers must not call db_rollback_transaction() after it, or they
+// undo the enclosing transaction too.
+int db_begin_transaction(void);
+int db_commit_transaction(void);
+void db_rollback_transaction(void);
+
 /* ============================================================================
  * STUDENT MANAGEMENT - CRUD OPERATIONS
  * ============================================================================ */
@@ -40,6 +80,7 @@ int db_add_student(const char *name, const char *gender,
 int db_get_student(int student_id, Student *student);
 sqlite3_stmt* db_get_all_students();
 sqlite3_stmt* db_get_students_by_branch(const char *branch);
+sqlite3_stmt* db_search_students(const char *text);
 int db_search_student_by_rollno(const char *roll_no, Student *student);
 int db_edit_student(int student_id, const Student *student);
 int db_delete_student(int student_id);
@@ -53,8 +94,8 @@ int db_get_student_count();
 typedef struct {
     int student_id;
     char roll_no[14];
-    unsigned char *photo;   // BLOB data
-    int photo_size;         // Size of photo in bytes
+    unsigned char *photo;   // Not loaded with the card (always NULL); photos are
+    int photo_size;         // read on demand, see STUDENT PHOTOS below
     char name[100];
     char father_name[100];
     char gender[20];
@@ -73,27 +114,27 @@ typedef struct {
     char roll_no[14];   
     
     // Institute Fee
-    double institute_paid;
+    Money institute_paid;
     char institute_date[20];
     char institute_mode[20];       // DD / Cheque / Online
     
     // Hostel Fee (Optional)
-    double hostel_paid;
+    Money hostel_paid;
     char hostel_date[20];
     char hostel_mode[20];
     
     // Mess Fee (Optional)
-    double mess_paid;
+    Money mess_paid;
     char mess_date[20];
     char mess_mode[20];
     
     // Other Charges (Optional)
-    double other_paid;
+    Money other_paid;
     char other_date[20];
     char other_mode[20];
     
     // Calculated
-    double total_paid;
+    Money total_paid;
     
     char status[20];                    // Draft, Submitted,  Verified
 } FeeRecord;
@@ -107,11 +148,11 @@ typedef struct {
     int semester;
     char category[20];
     char mobile[20];
-    double institute_paid;
-    double hostel_paid;
-    double mess_paid;
-    double other_paid;
-    double total_paid;
+    Money institute_paid;
+    Money hostel_paid;
+    Money mess_paid;
+    Money other_paid;
+    Money total_paid;
     char status[20];
 } FeeTableRow;
 
@@ -121,16 +162,81 @@ typedef struct {
 
 int db_get_all_fee_summary_rows(FeeTableRow **out_rows);
 int db_search_fee_summary_by_criteria(const char *search_text, FeeTableRow **out_rows);
+int db_get_fee_summary_page(const char *after_roll_no, int limit, FeeTableRow **out_rows);
 int db_create_fee_table(void);
 int db_save_fee_record(FeeRecord *fee);
 int db_get_fee_record(const char *roll_no, FeeRecord *fee);      
 int db_update_fee_record(FeeRecord *fee);
-int db_update_fee_summary(int student_id, const char *roll_no, const FeeRecord *fee);
+int db_rebuild_fee_summary(int *out_repaired);
 int db_delete_fee_record(const char *roll_no);                   
 int db_get_student_for_card_by_roll(const char *roll_no, StudentIDCard *out_student);
 int db_get_student_card_by_id(int student_id, StudentIDCard *out_student);
 void db_free_fee_table_rows(FeeTableRow *rows);
 
+/* ============================================================================
+ * FEE SETTLEMENT IMPORT
+ * ============================================================================ */
+
+#define FEE_IMPORT_DEFAULT_BATCH 5000
+
+typedef struct {
+    int lines;
+    int accepted;
+    int rejected;
+    int batches;
+    double seconds;
+} FeeImportStats;
+
+int db_import_fee_settlement(const char *path, int batch_size, FeeImportStats *out_stats);
+
+// Shared by the importers: splits one CSV (',') or TSV ('\t') line in place
+int db_split_import_line(char *line, char delimiter, char **fields, int max_fields);
+
+/* ============================================================================
+ * STUDENT ADMISSION IMPORT
+ * ============================================================================ */
+
+#define STUDENT_IMPORT_DEFAULT_BATCH 1000
+
+typedef struct {
+    int lines;
+    int accepted;
+    int rejected;
+    int duplicates;                 // rejected for a roll_no already taken
+    int batches;
+    double seconds;
+} StudentImportStats;
+
+int db_import_students(const char *path, int batch_size, StudentImportStats *out_stats);
+
+/* ============================================================================
+ * STUDENT PHOTOS (db_photo.c)
+ * Kept out of Students in StudentPhotos, one row per student: the photo as
+ * uploaded plus a small thumbnail made once at ingest. Both are streamed
+ * through sqlite3_blob_open(), so a photo never has to be in memory whole.
+ * ============================================================================ */
+
+#define DB_PHOTO_CHUNK          (64 * 1024)         // bytes per blob read/write
+#define DB_PHOTO_MAX_BYTES      (10 * 1024 * 1024)
+
+// Receives a photo a chunk at a time; return 0 to stop early
+typedef int (*DbBlobSink)(const unsigned char *chunk, int size, void *user_data);
+
+// Stores (or replaces) a student's photo, streamed from photo_path, with
+// its thumbnail. Returns 1 on success.
+int db_save_student_photo(int student_id, const char *photo_path,
+                          const unsigned char *thumbnail, int thumbnail_size);
+
+// Thumbnail bytes as stored, for the caller to g_free(). Returns 0 if the
+// student has no photo.
+int db_get_student_thumbnail(int student_id, unsigned char **out_data, int *out_size);
+
+// Streams the full photo to sink. Returns 0 if the student has no photo,
+// or the sink stopped early.
+int db_read_student_photo(int student_id, DbBlobSink sink, void *user_data);
+
+int db_delete_student_photo(int student_id);
+
 /* ============================================================================
  * EMPLOYEE & PAYROLL STRUCTURES
  * ============================================================================ */
@@ -149,7 +255,7 @@ typedef struct {
     char email[100];               // Email (optional)
     char mobile_number[10];        // Mobile Number (10 digits)
     char address[200];             // Address
-    float base_salary;             // Base Salary
+    Money base_salary;             // Base Salary (paise)
     char status[20];               // Status
     char created_date;         // Created Date
 } Employee;
@@ -169,6 +275,7 @@ typedef struct {
 // Employee Management
 int db_add_employee(const Employee *emp);
 int db_get_all_employees(sqlite3_stmt **out_stmt);
+int db_search_employees(const char *text, sqlite3_stmt **out_stmt);
 int db_get_employee_by_id(int emp_id, Employee *emp);
 int db_update_employee(int emp_id, const Employee *emp);
 int db_delete_employee(int emp_id);
@@ -185,22 +292,22 @@ typedef struct {
     int payroll_id;
     int emp_id;
     char month_year[20];
-    double basic_salary;
-    double house_rent;
-    double medical;
-    double conveyance;
-    double dearness_allowance;
-    double performance_bonus;
-    double other_allowances;
-    double total_allowances;
-    double income_tax;
-    double provident_fund;
-    double health_insurance;
-    double loan_deduction;
-    double other_deductions;
-    double total_deductions;
-    double gross_salary;
-    double net_salary;
+    Money basic_salary;
+    Money house_rent;
+    Money medical;
+    Money conveyance;
+    Money dearness_allowance;
+    Money performance_bonus;
+    Money other_allowances;
+    Money total_allowances;
+    Money income_tax;
+    Money provident_fund;
+    Money health_insurance;
+    Money loan_deduction;
+    Money other_deductions;
+    Money total_deductions;
+    Money gross_salary;
+    Money net_salary;
     char payment_date[20];
     char payment_method[50];
     char status[20];
@@ -218,31 +325,43 @@ typedef struct {
     char from_date[20];
     char to_date[20];
     char slip_date[20];
-    double basic_salary;
-    double house_rent;
-    double medical;
-    double conveyance;
-    double dearness_allowance;
-    double performance_bonus;
-    double other_allowances;
-    double total_allowances;
-    double income_tax;
-    double provident_fund;
-    double health_insurance;
-    double loan_deduction;
-    double other_deductions;
-    double total_deductions;
-    double gross_salary;
-    double net_salary;
+    Money basic_salary;
+    Money house_rent;
+    Money medical;
+    Money conveyance;
+    Money dearness_allowance;
+    Money performance_bonus;
+    Money other_allowances;
+    Money total_allowances;
+    Money income_tax;
+    Money provident_fund;
+    Money health_insurance;
+    Money loan_deduction;
+    Money other_deductions;
+    Money total_deductions;
+    Money gross_salary;
+    Money net_salary;
     char payment_status[20];
 } SalarySlip;
 
+// One row of the PayrollSummary rollup, or the sum of a month's rows
+typedef struct {
+    int headcount;                 // payroll rows
+    int paid_count;                // of which marked Paid
+    Money total_gross;
+    Money total_deductions;
+    Money total_net;
+    Money paid_net;                // net of the Paid rows
+} PayrollSummary;
+
 /* ============================================================================
  * DATABASE INITIALIZATION & TABLES
  * ============================================================================ */
 
-int db_create_tables();
+int db_create_tables();                   // db_migrate() + search index
 int db_create_payroll_tables();
+int db_migrate(void);                     // applies pending migrations, 1 on success
+int db_get_schema_version(void);          // PRAGMA user_version, -1 on error
 
 /* ============================================================================
  * PAYROLL FUNCTIONS
@@ -257,5 +376,28 @@ sqlite3_stmt* db_get_payroll_by_month(const char *month_year);
 int db_update_payroll(const Payroll *payroll);
 int db_delete_payroll(int payroll_id);
 int db_mark_payroll_paid(int payroll_id, const char *payment_date, const char *payment_method);
+int db_add_salary_slip(const SalarySlip *slip);
+int db_get_payroll_run_employees(const char *month_year, Employee **out_employees, int *out_already_paid);
+int db_get_payroll_summary(const char *month_year, const char *department, PayrollSummary *summary);
+int db_rebuild_payroll_summary(void);
+
+/* ============================================================================
+ * DASHBOARD STATS (db_stats.c)
+ * Counters in DashboardStats, kept current by triggers (migration 9), plus
+ * the month's gross from PayrollSummary: a handful of indexed rows read.
+ * ============================================================================ */
+
+typedef struct {
+    int students;
+    int employees;
+    Money month_payroll;            // gross, all departments
+} DashboardStats;
+
+// Called on the main loop after Students, employees or payroll changed
+typedef void (*DbStatsChangedFunc)(void *user_data);
+
+int db_get_dashboard_stats(const char *month_year, DashboardStats *out_stats);
+int db_rebuild_dashboard_stats(void);      // recount from the tables
+void db_stats_watch(DbStatsChangedFunc on_changed, void *user_data);
 
 #endif  // DATABASE_H
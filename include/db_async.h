@@ -0,0 +1,60 @@
+#ifndef DB_ASYNC_H
+#define DB_ASYNC_H
+
+#include <gio/gio.h>
+#include <sqlite3.h>
+
+/* ============================================================================
+ * BACKGROUND QUERIES
+ * A query runs on a worker thread against a separate read-only connection.
+ * Its rows are copied out there and handed to the main loop in chunks, so
+ * the UI only spends time appending rows, never waiting on SQLite.
+ * ============================================================================ */
+
+#define DB_ASYNC_CHUNK_ROWS 500
+
+typedef struct {
+    int type;                       // SQLITE_INTEGER, SQLITE_FLOAT, SQLITE_TEXT or SQLITE_NULL
+    union {
+        sqlite3_int64 i;
+        double d;
+        const char *s;
+    } v;
+} DbAsyncValue;
+
+typedef struct {
+    int n_rows;
+    int n_cols;
+    DbAsyncValue *values;           // n_rows * n_cols, row by row
+    GStringChunk *strings;          // owns the text values
+} DbAsyncChunk;
+
+// Both callbacks run on the main loop. Chunks of a cancelled load are
+// dropped; on_done is always called exactly once, after the last chunk,
+// with the load's handle so the caller can tell a stale load from its
+// current one.
+typedef void (*DbAsyncRowsFunc)(const DbAsyncChunk *chunk, gpointer user_data);
+typedef void (*DbAsyncDoneFunc)(GCancellable *load, int total_rows, gboolean cancelled, gpointer user_data);
+
+// Starts a query; params is a NULL-terminated list of text parameters (may
+// be NULL). Returns the load's cancellable, owned by the caller - release it
+// with db_async_cancel() or g_object_unref() once on_done has run.
+GCancellable* db_async_query(const char *sql, const char *const *params,
+                             DbAsyncRowsFunc on_rows, DbAsyncDoneFunc on_done,
+                             gpointer user_data);
+
+void db_async_cancel(GCancellable **load);     // cancels and clears the handle
+void db_async_cancel_all(void);                // e.g. when the visible tab changes
+void db_async_shutdown(void);                  // closes the read connection
+
+// Synchronous counterpart, for callers that page through a statement
+// themselves (db_tree_model.c). Free the chunk with db_async_chunk_free().
+DbAsyncChunk* db_async_chunk_read(sqlite3_stmt *stmt, int max_rows);
+void db_async_chunk_free(DbAsyncChunk *chunk);
+
+int db_async_int(const DbAsyncChunk *chunk, int row, int col);
+sqlite3_int64 db_async_int64(const DbAsyncChunk *chunk, int row, int col);   // e.g. Money columns
+double db_async_double(const DbAsyncChunk *chunk, int row, int col);
+const char* db_async_text(const DbAsyncChunk *chunk, int row, int col);   // NULL for NULL
+
+#endif // DB_ASYNC_H
@@ -0,0 +1,92 @@
+#ifndef DB_LATENCY_H
+#define DB_LATENCY_H
+
+#include <sqlite3.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/* ============================================================================
+ * DATABASE LATENCY HISTOGRAMS (db_latency.c)
+ * Every public db_* function opens with DB_LATENCY_SCOPE(), which times
+ * the call on the monotonic clock until it returns. A sqlite3_trace_v2()
+ * profile hook times every statement a connection runs, keyed by its SQL
+ * text. Both feed log-linear histograms - 16 sub-buckets per power of two,
+ * so a reported percentile is within about 6% - updated with relaxed
+ * atomics only, from any thread. SQLite takes statement times from its
+ * VFS clock, which ticks in milliseconds on most builds; function times
+ * come from the nanosecond monotonic clock.
+ * ============================================================================ */
+
+#define DB_LATENCY_SUB_BITS     4
+#define DB_LATENCY_SUB_BUCKETS  (1 << DB_LATENCY_SUB_BITS)
+#define DB_LATENCY_BUCKETS      (DB_LATENCY_SUB_BUCKETS * 40)  // to 2^43 ns, about 2.4 h
+#define DB_LATENCY_MAX_SQL      256                             // distinct statements kept
+#define DB_LATENCY_JSON_FILE    "logs/db_latency.json"
+
+typedef struct {
+    atomic_uint_fast64_t count;
+    atomic_uint_fast64_t total_ns;
+    atomic_uint_fast64_t max_ns;
+    atomic_uint buckets[DB_LATENCY_BUCKETS];
+} DbLatencyHistogram;
+
+// One per instrumented function, declared by DB_LATENCY_SCOPE()
+typedef struct DbLatencySite {
+    const char *name;
+    atomic_int registered;
+    struct DbLatencySite *next;
+    DbLatencyHistogram hist;
+} DbLatencySite;
+
+typedef struct {
+    DbLatencySite *site;
+    int64_t start_ns;               // 0 while timing is off
+} DbLatencyScope;
+
+typedef enum {
+    DB_LATENCY_FUNCTION,
+    DB_LATENCY_STATEMENT
+} DbLatencyKind;
+
+typedef struct {
+    DbLatencyKind kind;
+    const char *name;               // function name or SQL text; lives until exit
+    uint64_t count;
+    uint64_t mean_ns;
+    uint64_t p50_ns;
+    uint64_t p99_ns;
+    uint64_t max_ns;
+} DbLatencyStats;
+
+// Monotonic nanoseconds, read whether or not timing is on
+int64_t db_latency_clock_ns(void);
+
+int64_t db_latency_now(void);
+void db_latency_scope_end(DbLatencyScope *scope);
+
+// Times the rest of the enclosing function, every return path included
+#define DB_LATENCY_SCOPE() \
+    static DbLatencySite db_latency_site_ = { .name = __func__ }; \
+    DbLatencyScope db_latency_scope_ __attribute__((cleanup(db_latency_scope_end))) = \
+        { &db_latency_site_, db_latency_now() }
+
+// Timing is on by default
+void db_latency_set_enabled(int enabled);
+int db_latency_enabled(void);
+
+// Registers the statement profile hook on a connection
+void db_latency_attach(sqlite3 *conn);
+
+// Copies up to max entries (functions first, then statements) that have
+// at least one sample. Returns the number copied.
+int db_latency_snapshot(DbLatencyStats *out, int max);
+
+// Zeroes every histogram
+void db_latency_reset(void);
+
+// Writes every histogram as JSON. Returns 1 on success.
+int db_latency_write_json(FILE *out);
+int db_latency_dump_json(const char *path);     // NULL for DB_LATENCY_JSON_FILE
+
+#endif // DB_LATENCY_H
@@ -0,0 +1,56 @@
+#ifndef DB_TREE_MODEL_H
+#define DB_TREE_MODEL_H
+
+#include <gtk/gtk.h>
+#include "db_async.h"
+
+/* ============================================================================
+ * VIRTUAL TABLE MODEL
+ * A GtkTreeModel over a listing query. The row count is taken up front; rows
+ * are read a page at a time, only when the view asks for them, and the most
+ * recently used pages are kept. Nothing is copied into the model, so a
+ * 50,000-row table costs what its visible pages cost.
+ *
+ * Rows are fixed for the model's lifetime: to show new data, build a new
+ * model and swap it into the view. Views should use fixed-height mode, or
+ * GTK measures every row and so reads every page.
+ * ============================================================================ */
+
+#define DB_TREE_MODEL_PAGE_ROWS 128
+#define DB_TREE_MODEL_CACHED_PAGES 16
+
+#define DB_TYPE_TREE_MODEL (db_tree_model_get_type())
+G_DECLARE_FINAL_TYPE(DbTreeModel, db_tree_model, DB, TREE_MODEL, GObject)
+
+// Fills one cell. value is already initialised to the column's type; row
+// indexes into page, whose columns are the query's result columns.
+typedef void (*DbTreeModelValueFunc)(const DbAsyncChunk *page, int row, int column,
+                                     GValue *value, gpointer user_data);
+
+// Runs on the main loop once the row count is known, or the count was
+// cancelled. load is the handle db_tree_model_load() returned.
+typedef void (*DbTreeModelReadyFunc)(DbTreeModel *model, GCancellable *load,
+                                     gboolean cancelled, gpointer user_data);
+
+// sql is a listing query without LIMIT/OFFSET; params is a NULL-terminated
+// list of text parameters (may be NULL). The model has no rows until loaded.
+DbTreeModel* db_tree_model_new(const char *sql, const char *const *params,
+                               int n_columns, const GType *column_types,
+                               DbTreeModelValueFunc value_func, gpointer user_data);
+
+// Optional: read a page by seeking past the previous page's last key
+// instead of by OFFSET, whenever that page has been read. keyset_sql is the
+// same listing limited to rows after :after_key, the value of the query's
+// result column key_column, which must be unique and the ORDER BY; it ends
+// in LIMIT :page_rows. Call before loading.
+void db_tree_model_set_keyset(DbTreeModel *model, const char *keyset_sql, int key_column);
+
+// Counts the rows in the background. Call before attaching the model to a
+// view. Returns the load's cancellable, owned by the caller as with
+// db_async_query(); the model is kept alive until on_ready has run.
+GCancellable* db_tree_model_load(DbTreeModel *model, DbTreeModelReadyFunc on_ready,
+                                 gpointer user_data);
+
+int db_tree_model_get_n_rows(DbTreeModel *model);
+
+#endif // DB_TREE_MODEL_H
@@ -14,6 +14,7 @@ void on_add_employee_clicked(GtkButton *button, gpointer user_data);
 void on_save_employee_clicked(GtkButton *button, gpointer user_data);
 void on_search_employee_clicked(GtkButton *button, gpointer user_data);
 void refresh_employee_list(void);
+void employee_ui_page_shown(void);      // reloads the table if a load was cut short
 void clear_employee_form(void);
 
 #endif // EMPLOYEE_UI_H
@@ -7,6 +7,7 @@
 
 // Main UI Creation
 void create_fee_ui(GtkWidget *container);
+void fee_ui_page_shown(void);      // reloads the table if a load was cut short
 
 // Button Callbacks
 void on_add_fee_clicked(GtkButton *button, gpointer data);
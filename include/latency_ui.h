@@ -0,0 +1,19 @@
+#ifndef LATENCY_UI_H
+#define LATENCY_UI_H
+
+#include <gtk/gtk.h>
+
+/* ============================================================================
+ * DATABASE LATENCY PANEL
+ * A dashboard panel listing every timed db_* function and SQL statement
+ * with its count, p50, p99 and max. Hidden until toggled with Ctrl+Shift+L;
+ * refreshes itself every second while shown.
+ * ============================================================================ */
+
+// Builds the panel; pack it, it stays hidden through gtk_widget_show_all()
+GtkWidget* latency_ui_create_panel(void);
+
+// Shows or hides the panel
+void latency_ui_toggle(void);
+
+#endif // LATENCY_UI_H
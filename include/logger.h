@@ -1,10 +1,80 @@
 #ifndef LOGGER_H
 #define LOGGER_H
 
+#include <stdatomic.h>
+
+/* ============================================================================
+ * LOGGER
+ * LOG_INFO("Loaded %d rows", n) and friends. A message below the
+ * compile-time level is compiled out; one below the runtime level costs a
+ * single comparison - its arguments are not even evaluated.
+ *
+ * Each thread formats into its own ring buffer without taking a lock. A
+ * writer thread drains the rings in message order to the console and to a
+ * rotating log file. Before log_init() and after log_shutdown() messages
+ * are written directly.
+ * ============================================================================ */
+
+typedef enum {
+    LOG_LEVEL_DEBUG = 0,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_SUCCESS,
+    LOG_LEVEL_WARNING,
+    LOG_LEVEL_ERROR,
+    LOG_LEVEL_OFF
+} LogLevel;
+
+// Lowest level built in: DEBUG in debug builds, INFO otherwise
+#ifndef LOG_COMPILE_LEVEL
+#ifdef DEBUG
+#define LOG_COMPILE_LEVEL LOG_LEVEL_DEBUG
+#else
+#define LOG_COMPILE_LEVEL LOG_LEVEL_INFO
+#endif
+#endif
+
+#define LOG_DEFAULT_FILE     "logs/college_finance.log"
+#define LOG_FILE_MAX_BYTES   (4L * 1024 * 1024)     // rotate after this much
+#define LOG_FILE_KEEP        3                      // .1 .. .3 kept
+
+extern atomic_int log_runtime_level;
+
+#define LOG_ENABLED(level) \
+    ((level) >= LOG_COMPILE_LEVEL && \
+     (int)(level) >= atomic_load_explicit(&log_runtime_level, memory_order_relaxed))
+
+#define LOG_AT(level, ...) \
+    do { if (LOG_ENABLED(level)) log_write((level), __VA_ARGS__); } while (0)
+
+#define LOG_DEBUG(...)   LOG_AT(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define LOG_INFO(...)    LOG_AT(LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOG_SUCCESS(...) LOG_AT(LOG_LEVEL_SUCCESS, __VA_ARGS__)
+#define LOG_WARNING(...) LOG_AT(LOG_LEVEL_WARNING, __VA_ARGS__)
+#define LOG_ERROR(...)   LOG_AT(LOG_LEVEL_ERROR, __VA_ARGS__)
+
+// Starts the writer thread. file_path NULL means CFMS_LOG_FILE or
+// LOG_DEFAULT_FILE; "" logs to the console only. The runtime level comes
+// from CFMS_LOG_LEVEL unless log_set_level() is called. log_shutdown() is
+// registered with atexit(). Returns 1 on success.
+int log_init(const char *file_path);
+
+// Drains every buffered message and stops the writer thread
+void log_shutdown(void);
+
+void log_set_level(LogLevel level);
+
+// "debug", "info", "success", "warning", "error" or "off"; -1 if unknown
+int log_level_from_name(const char *name);
+
+// Use the LOG_* macros rather than calling this directly
+void log_write(LogLevel level, const char *format, ...)
+    __attribute__((format(printf, 2, 3)));
+
+// Plain-message forms
 void log_info(const char *message);
 
 void log_error(const char *message);
 
 void log_debug(const char *message);
 
-#endif
\ No newline at end of file
+#endif
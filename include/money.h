@@ -0,0 +1,52 @@
+#ifndef MONEY_H
+#define MONEY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+/* ============================================================================
+ * MONEY
+ * Amounts are whole paise in a 64-bit integer, in memory and in SQLite
+ * (INTEGER columns). Sums and differences are exact; only percentages
+ * round, once, half away from zero. Convert to and from rupee text at the
+ * edges with money_parse() and money_format().
+ * ============================================================================ */
+
+typedef int64_t Money;
+
+#define MONEY_PAISE_PER_RUPEE 100
+#define MONEY_RUPEES(rupees) ((Money)(rupees) * MONEY_PAISE_PER_RUPEE)
+
+// Large enough for any Money as "-92233720368547758.08"
+#define MONEY_TEXT_SIZE 24
+
+// For printf: printf("Net " MONEY_FMT "\n", MONEY_ARGS(net)). MONEY_ARGS
+// evaluates its argument more than once - pass a variable, not a call. The
+// magnitude is taken unsigned, so INT64_MIN prints rather than overflows.
+#define MONEY_MAGNITUDE(m) ((m) < 0 ? (uint64_t)0 - (uint64_t)(m) : (uint64_t)(m))
+#define MONEY_FMT "%s%" PRIu64 ".%02d"
+#define MONEY_ARGS(m) ((m) < 0 ? "-" : ""), \
+                      (uint64_t)(MONEY_MAGNITUDE(m) / MONEY_PAISE_PER_RUPEE), \
+                      (int)(MONEY_MAGNITUDE(m) % MONEY_PAISE_PER_RUPEE)
+
+// Parses rupees such as "1500", "1500.5" or "-12.05". Surrounding spaces
+// are allowed; more than two decimals are not, unless they are zeros.
+// Returns 1 and sets *out on success, 0 on invalid or empty text.
+int money_parse(const char *text, Money *out);
+
+// Writes amount as rupees with two decimals ("1500.50") and returns buffer
+const char* money_format(Money amount, char *buffer, size_t buffer_size);
+
+// amount * basis_points / 10000, rounded half away from zero (1200 = 12%)
+Money money_percent(Money amount, int basis_points);
+
+// amount / divisor, rounded half away from zero (divisor > 0)
+Money money_divide(Money amount, int divisor);
+
+/* Bulk sums. Plain integer loops over contiguous arrays: exact in any order,
+ * so the compiler is free to vectorize them. */
+Money money_sum(const Money *values, size_t count);
+void money_add(Money *restrict totals, const Money *restrict values, size_t count);
+
+#endif // MONEY_H
@@ -0,0 +1,34 @@
+#ifndef PAYROLL_RUN_H
+#define PAYROLL_RUN_H
+
+#include "database.h"
+
+/* ============================================================================
+ * BATCH PAYROLL RUN (payroll_run.c)
+ * Pays every active employee for one month. Each employee's payroll is
+ * computed with the payroll_logic.c rules on a worker pool, then every
+ * payroll and salary_slips row is written in one transaction.
+ *
+ * Employees already on payroll for the month are skipped, so a run that
+ * failed, or left out employees whose payroll did not validate, is resumed
+ * by running it again. A dry run computes and reports without writing.
+ * ============================================================================ */
+
+typedef struct {
+    int employees;              // active employees
+    int already_paid;           // skipped, payroll for the month exists
+    int computed;               // payroll computed and validated
+    int failed;                 // did not validate, left for the next run
+    int written;                // payroll rows written (0 for a dry run)
+    Money total_gross;          // over the computed employees
+    Money total_deductions;
+    Money total_net;
+    double seconds;
+} PayrollRunStats;
+
+// month_year is "Mon-YYYY" as saved by the payroll form, e.g. "Dec-2025".
+// Returns 1 if the run completed (even with failed employees), 0 if it
+// could not start or its transaction was rolled back.
+int payroll_run_month(const char *month_year, int dry_run, PayrollRunStats *out_stats);
+
+#endif  // PAYROLL_RUN_H
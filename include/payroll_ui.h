@@ -2,6 +2,7 @@
 #define PAYROLL_UI_H
 
 #include <gtk/gtk.h>
+#include "payroll.h"
 
 /* ============================================================================
  * PAYROLL UI FUNCTION PROTOTYPES
@@ -22,6 +23,12 @@ void create_payroll_ui(GtkWidget *container);
  */
 void refresh_payroll_table();
 
+/**
+ * Reload the payroll table if its last background load was cancelled
+ * Called when the payroll page becomes visible
+ */
+void payroll_ui_page_shown(void);
+
 /**
  * Show salary slip preview dialog
  * Displays formatted salary slip with box drawing characters
@@ -0,0 +1,27 @@
+#ifndef PHOTO_CACHE_H
+#define PHOTO_CACHE_H
+
+#include <gtk/gtk.h>
+
+/* ============================================================================
+ * STUDENT PHOTO THUMBNAILS
+ * Ingest decodes a photo once to make its thumbnail and stores both (see
+ * db_save_student_photo()). Decoded thumbnails are kept in a bounded LRU,
+ * so showing the same ID cards again costs no database read or decode;
+ * students without a photo are remembered too.
+ * ============================================================================ */
+
+#define PHOTO_THUMBNAIL_SIZE    96      // px, longest side
+#define PHOTO_CACHE_CAPACITY    256     // thumbnails kept decoded
+
+// Makes the thumbnail and stores it with the photo. Returns 1 on success;
+// on failure error (if given) says why.
+int photo_ingest_file(int student_id, const char *path, char *error, size_t error_len);
+
+// The student's thumbnail, or NULL if there is none. Release with g_object_unref().
+GdkPixbuf* photo_cache_get(int student_id);
+
+void photo_cache_invalidate(int student_id);
+void photo_cache_clear(void);
+
+#endif // PHOTO_CACHE_H
@@ -0,0 +1,36 @@
+#ifndef STUDENT_INDEX_H
+#define STUDENT_INDEX_H
+
+#include <glib.h>
+
+/* ============================================================================
+ * STUDENT SEARCH INDEX (student_index.c)
+ * An in-memory prefix index over each student's roll number, mobile and the
+ * words of the name, case-folded. Keys live in one array
+ * sorted by (key, student_id), so a prefix is a binary search plus a scan
+ * of the matching run. Built once from a bulk load, then kept current one
+ * student at a time as students are added, edited and deleted.
+ * ============================================================================ */
+
+// Bulk load: clear, add every student in any order, then finish (sorts once)
+void student_index_clear(void);
+void student_index_load_row(int student_id, const char *roll_no, const char *name, const char *mobile);
+void student_index_load_done(void);
+gboolean student_index_ready(void);        // a load has finished
+
+// Incremental updates; put() adds a student or replaces its keys
+void student_index_put(int student_id, const char *roll_no, const char *name, const char *mobile);
+void student_index_remove(int student_id);
+
+int student_index_count(void);              // students indexed
+
+// Students every word of text is a prefix of one of their keys for, as a
+// set of GINT_TO_POINTER(student_id); release with g_hash_table_unref().
+// NULL when text has no words.
+GHashTable* student_index_search(const char *text);
+
+// Every indexed student_id, highest first (the student listing's order);
+// release with g_free()
+int* student_index_ids_desc(int *out_count);
+
+#endif // STUDENT_INDEX_H
@@ -3,12 +3,14 @@
 #define STUDENT_UI_H
 
 void create_student_ui(GtkWidget *container);
+void student_ui_page_shown(void);      // reloads the table if a load was cut short
 
 void on_add_student_clicked(GtkButton *button, gpointer user_data);
 
 void on_view_students_clicked(GtkButton *button, gpointer user_data);
 
 // Search functions
+void on_student_search_changed(GtkEditable *editable, gpointer user_data);   // debounced live filter
 void on_search_perform_inline(GtkButton *button, gpointer user_data);
 void on_search_clear(GtkButton *button, gpointer user_data);
 
@@ -16,5 +18,8 @@ void on_edit_student_clicked(GtkButton *button, gpointer user_data);
 
 void on_delete_student_clicked(GtkButton *button, gpointer user_data);
 
+// Photo of the selected student (photo_cache.h)
+void on_student_photo_clicked(GtkButton *button, gpointer user_data);
+
 
 #endif
\ No newline at end of file
@@ -0,0 +1,26 @@
+#ifndef TABLE_FILL_H
+#define TABLE_FILL_H
+
+#include <gtk/gtk.h>
+
+/* ============================================================================
+ * BULK LIST STORE FILL
+ * For tables that still use a GtkListStore (search results, placeholders).
+ * The store is detached from its view and left unsorted while it is
+ * refilled, so the view sees one new model instead of a row-inserted
+ * signal, and a re-layout, per row.
+ * ============================================================================ */
+
+// Adds the rows, ideally with gtk_list_store_insert_with_values()
+typedef void (*TableFillFunc)(GtkListStore *store, gpointer user_data);
+
+// Clears store, fills it with fill() and attaches it to view (replacing
+// whatever model the view had). Returns the number of rows in the store.
+int table_fill_list_store(GtkTreeView *view, GtkListStore *store,
+                          TableFillFunc fill, gpointer user_data);
+
+// Times a rows-row refresh of an attached store, row by row, against
+// table_fill_list_store(). Needs a display; returns 0 on success.
+int table_fill_benchmark(int rows);
+
+#endif // TABLE_FILL_H
@@ -0,0 +1,56 @@
+#ifndef TAX_H
+#define TAX_H
+
+#include <stddef.h>
+#include "money.h"
+
+/* ============================================================================
+ * INCOME TAX SLABS (tax.c)
+ * One slab table per financial year, compiled in and optionally replaced
+ * from a config file. Each table stores its slab lower bounds sorted, with
+ * the tax already due at each bound, so evaluating an annual salary is one
+ * pass over the bounds plus a single percentage for the top slab.
+ *
+ * Config file, one slab per line (rupees, percent):
+ *
+ *     # FY start year   slab from   rate
+ *     2025              0           0
+ *     2025              400000      5
+ *
+ * A year given in the file replaces the compiled-in table for that year.
+ * ============================================================================ */
+
+#define TAX_MAX_SLABS 12
+#define TAX_DEFAULT_CONFIG "data/tax_slabs.conf"
+
+typedef struct {
+    int fy_start;                   // 2024 = FY 2024-25 (April 2024 - March 2025)
+    int n_slabs;
+    Money lower[TAX_MAX_SLABS];     // ascending, lower[0] = 0
+    int rate_bp[TAX_MAX_SLABS];     // basis points above lower[i] (500 = 5%)
+    Money base_tax[TAX_MAX_SLABS];  // tax due on exactly lower[i]
+} TaxTable;
+
+// Builds the tables and applies config_path (NULL for TAX_DEFAULT_CONFIG; a
+// missing default file is not an error). Call once at startup, before any
+// worker threads. Returns 1 on success, 0 if the config file was rejected
+// (the compiled-in tables stay in effect).
+int tax_init(const char *config_path);
+
+// The table in force for a financial year: the latest one starting on or
+// before fy_start. The current table follows today's date.
+const TaxTable* tax_table_for_year(int fy_start);
+const TaxTable* tax_table_current(void);
+
+// Financial year of a calendar month (1-12): April starts a new one
+int tax_financial_year(int month, int year);
+
+// Annual tax on an annual salary, and the monthly share (annual / 12)
+Money tax_annual(const TaxTable *table, Money annual_salary);
+Money tax_monthly(const TaxTable *table, Money annual_salary);
+
+// Monthly tax for count annual salaries in one call
+void tax_monthly_batch(const TaxTable *table, const Money *annual_salaries,
+                       Money *monthly_tax, size_t count);
+
+#endif  // TAX_H
@@ -0,0 +1,461 @@
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sqlite3.h>
+#include "../../include/database.h"
+#include "../../include/payroll.h"
+#include "../../include/db_latency.h"
+#include "../../include/logger.h"
+
+
+// ============================================================================
+// HEADLESS BENCHMARK (make bench)
+//
+// Seeds a throwaway database under the temp directory and times the hot
+// paths of the app one call at a time: adding students, saving fee
+// records, listing and searching the fee summary, adding payroll and
+// computing net salary. Built from the database and logic sources only,
+// so it runs without GTK or a display.
+//
+// Results are JSON with one benchmark per line, so two runs (say, two
+// releases) can be compared with a plain diff.
+//
+// With --check-query-plans it runs the query plan check instead (make
+// check-plans) and exits non-zero if any hot query scans a whole table.
+// ============================================================================
+
+#define BENCH_DEFAULT_SCALE     2000
+#define BENCH_DEFAULT_REPEAT    50
+#define BENCH_FORMAT_VERSION    1
+#define BENCH_CALC_BATCH        64      // net pay takes nanoseconds; time it in batches
+
+typedef struct {
+    const char *name;
+    int64_t *samples;           // ns per op, one per timed call or batch
+    int count;
+    int capacity;
+    int64_t ops;
+    int64_t elapsed_ns;         // sum of the timed calls
+} BenchResult;
+
+enum {
+    BENCH_ADD_STUDENT,
+    BENCH_SAVE_FEE,
+    BENCH_LIST_FEES,
+    BENCH_SEARCH_FEES,
+    BENCH_ADD_PAYROLL,
+    BENCH_CALC_NET,
+    BENCH_COUNT
+};
+
+static const char *bench_names[BENCH_COUNT] = {
+    "db_add_student",
+    "db_save_fee_record",
+    "db_get_all_fee_summary_rows",
+    "db_search_fee_summary_by_criteria",
+    "db_add_payroll",
+    "payroll_calculate_net"
+};
+
+static const char *bench_branches[] = { "CSE", "ECE", "ME", "EE", "CE" };
+static const char *bench_months[] = {
+    "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
+};
+
+static void bench_result_init(BenchResult *r, const char *name, int capacity) {
+    memset(r, 0, sizeof(BenchResult));
+    r->name = name;
+    r->capacity = capacity > 0 ? capacity : 1;
+    r->samples = g_new(int64_t, r->capacity);
+}
+
+static void bench_record(BenchResult *r, int64_t elapsed_ns, int ops) {
+    if (r->count < r->capacity) {
+        r->samples[r->count++] = elapsed_ns / ops;
+    }
+    r->ops += ops;
+    r->elapsed_ns += elapsed_ns;
+}
+
+static int bench_compare_ns(const void *a, const void *b) {
+    int64_t x = *(const int64_t *)a;
+    int64_t y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest rank on the sorted samples
+static double bench_percentile_us(const BenchResult *r, int percent) {
+    if (r->count == 0) {
+        return 0.0;
+    }
+    int rank = (int)(((int64_t)r->count * percent + 99) / 100);
+    if (rank < 1) {
+        rank = 1;
+    }
+    return r->samples[rank - 1] / 1000.0;
+}
+
+static void bench_write_result(FILE *out, BenchResult *r, int last) {
+    qsort(r->samples, r->count, sizeof(int64_t), bench_compare_ns);
+
+    double seconds = r->elapsed_ns / 1e9;
+    double mean_us = r->ops > 0 ? r->elapsed_ns / 1000.0 / r->ops : 0.0;
+    double max_us = r->count > 0 ? r->samples[r->count - 1] / 1000.0 : 0.0;
+
+    fprintf(out,
+            "    {\"name\": \"%s\", \"ops\": %" PRId64 ", \"seconds\": %.6f, "
+            "\"ops_per_sec\": %.1f, \"mean_us\": %.3f, \"p50_us\": %.3f, "
+            "\"p90_us\": %.3f, \"p99_us\": %.3f, \"max_us\": %.3f}%s\n",
+            r->name, r->ops, seconds,
+            seconds > 0 ? r->ops / seconds : 0.0, mean_us,
+            bench_percentile_us(r, 50), bench_percentile_us(r, 90),
+            bench_percentile_us(r, 99), max_us,
+            last ? "" : ",");
+}
+
+static int bench_add_students(BenchResult *r, int scale, char (*rolls)[14]) {
+    for (int i = 0; i < scale; i++) {
+        char name[64], father[64], mobile[16], email[64];
+
+        snprintf(rolls[i], sizeof(rolls[i]), "2025%09u", (unsigned)(i + 1) % 1000000000u);
+        snprintf(name, sizeof(name), "Student %d", i + 1);
+        snprintf(father, sizeof(father), "Father %d", i + 1);
+        snprintf(mobile, sizeof(mobile), "9%09d", i + 1);
+        snprintf(email, sizeof(email), "s%d@college.in", i + 1);
+        int year = 1 + i % 4;
+
+        int64_t start = db_latency_clock_ns();
+        int id = db_add_student(name, i % 2 ? "Female" : "Male", father,
+                                bench_branches[i % G_N_ELEMENTS(bench_branches)],
+                                year, year * 2 - 1 + i % 2, rolls[i], "GEN", mobile, email);
+        bench_record(r, db_latency_clock_ns() - start, 1);
+
+        if (id < 0) {
+            LOG_ERROR("Benchmark seeding failed at student %d", i + 1);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int bench_save_fees(BenchResult *r, int scale, char (*rolls)[14]) {
+    for (int i = 0; i < scale; i++) {
+        FeeRecord fee;
+        memset(&fee, 0, sizeof(fee));
+
+        g_strlcpy(fee.roll_no, rolls[i], sizeof(fee.roll_no));
+        fee.institute_paid = MONEY_RUPEES(45000 + (i % 5) * 1000);
+        g_strlcpy(fee.institute_date, "15-07-2025", sizeof(fee.institute_date));
+        g_strlcpy(fee.institute_mode, "Online", sizeof(fee.institute_mode));
+        if (i % 2 == 0) {
+            fee.hostel_paid = MONEY_RUPEES(30000);
+            g_strlcpy(fee.hostel_date, "15-07-2025", sizeof(fee.hostel_date));
+            g_strlcpy(fee.hostel_mode, "DD", sizeof(fee.hostel_mode));
+        }
+        if (i % 3 == 0) {
+            fee.mess_paid = MONEY_RUPEES(18000);
+            g_strlcpy(fee.mess_date, "20-07-2025", sizeof(fee.mess_date));
+            g_strlcpy(fee.mess_mode, "Cash", sizeof(fee.mess_mode));
+        }
+        fee.total_paid = fee.institute_paid + fee.hostel_paid + fee.mess_paid;
+        g_strlcpy(fee.status, "Submitted", sizeof(fee.status));
+
+        int64_t start = db_latency_clock_ns();
+        int ok = db_save_fee_record(&fee);
+        bench_record(r, db_latency_clock_ns() - start, 1);
+
+        if (!ok) {
+            LOG_ERROR("Benchmark seeding failed at fee record %d", i + 1);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int bench_list_fees(BenchResult *r, int repeat, int scale) {
+    for (int i = 0; i < repeat; i++) {
+        FeeTableRow *rows = NULL;
+
+        int64_t start = db_latency_clock_ns();
+        int count = db_get_all_fee_summary_rows(&rows);
+        bench_record(r, db_latency_clock_ns() - start, 1);
+
+        db_free_fee_table_rows(rows);
+        if (count != scale) {
+            LOG_ERROR("Fee summary listed %d rows, expected %d", count, scale);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Alternates between a branch (many matches) and one roll number (one match)
+static int bench_search_fees(BenchResult *r, int repeat, int scale, char (*rolls)[14]) {
+    for (int i = 0; i < repeat; i++) {
+        const char *term = i % 2 ? rolls[(i * 7919) % scale]
+                                 : bench_branches[(i / 2) % G_N_ELEMENTS(bench_branches)];
+        FeeTableRow *rows = NULL;
+
+        int64_t start = db_latency_clock_ns();
+        int count = db_search_fee_summary_by_criteria(term, &rows);
+        bench_record(r, db_latency_clock_ns() - start, 1);
+
+        db_free_fee_table_rows(rows);
+        if (count <= 0) {
+            LOG_ERROR("Fee summary search for '%s' found nothing", term);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Untimed: the payroll benchmarks need employees to pay
+static int bench_seed_employees(int employees, int *emp_ids) {
+    for (int i = 0; i < employees; i++) {
+        Employee emp;
+        memset(&emp, 0, sizeof(emp));
+
+        emp.emp_no = 1000 + i + 1;
+        snprintf(emp.emp_name, sizeof(emp.emp_name), "Employee %d", i + 1);
+        g_strlcpy(emp.emp_dob, "01-01-1980", sizeof(emp.emp_dob));
+        snprintf(emp.department, sizeof(emp.department), "Dept %d", i % 8);
+        g_strlcpy(emp.designation, "Lecturer", sizeof(emp.designation));
+        g_strlcpy(emp.category, "Teaching", sizeof(emp.category));
+        g_strlcpy(emp.reporting_person_name, "Principal", sizeof(emp.reporting_person_name));
+        snprintf(emp.email, sizeof(emp.email), "e%d@college.in", i + 1);
+        // mobile_number has no room for a terminator after ten digits
+        snprintf(emp.mobile_number, sizeof(emp.mobile_number), "8%08u", (unsigned)(i + 1) % 100000000u);
+        g_strlcpy(emp.address, "Mainpuri", sizeof(emp.address));
+        emp.base_salary = MONEY_RUPEES(30000 + (i % 20) * 2500);
+        g_strlcpy(emp.status, "Active", sizeof(emp.status));
+
+        emp_ids[i] = db_add_employee(&emp);
+        if (emp_ids[i] < 0) {
+            LOG_ERROR("Benchmark seeding failed at employee %d", i + 1);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Same components as a payroll run: HRA, DA, PF and income tax
+static void bench_prepare_payroll(Payroll *p, int emp_id, Money basic, int month_index) {
+    memset(p, 0, sizeof(Payroll));
+    p->emp_id = emp_id;
+    snprintf(p->month_year, sizeof(p->month_year), "%s-%d",
+             bench_months[month_index % 12], 2025 - month_index / 12);
+    p->basic_salary = basic;
+    p->house_rent = payroll_calculate_hra(basic);
+    p->dearness_allowance = payroll_calculate_da(basic);
+    p->provident_fund = payroll_calculate_pf(basic);
+    p->income_tax = payroll_calculate_income_tax(basic * 12);
+    payroll_calculate_net(p);
+    g_strlcpy(p->payment_date, "31-07-2025", sizeof(p->payment_date));
+    g_strlcpy(p->payment_method, "Bank Transfer", sizeof(p->payment_method));
+    g_strlcpy(p->status, "Paid", sizeof(p->status));
+}
+
+// One payroll per employee per month; UNIQUE(emp_id, month_year) allows no more
+static int bench_add_payroll(BenchResult *r, int scale, int employees, const int *emp_ids) {
+    for (int i = 0; i < scale; i++) {
+        Payroll p;
+        bench_prepare_payroll(&p, emp_ids[i % employees],
+                              MONEY_RUPEES(30000 + (i % 20) * 2500), i / employees);
+
+        int64_t start = db_latency_clock_ns();
+        int id = db_add_payroll(&p);
+        bench_record(r, db_latency_clock_ns() - start, 1);
+
+        if (id < 0) {
+            LOG_ERROR("Benchmark payroll insert %d failed: %s", i + 1, db_payroll_get_error());
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void bench_calculate_net(BenchResult *r, int batches) {
+    Payroll batch[BENCH_CALC_BATCH];
+    for (int i = 0; i < BENCH_CALC_BATCH; i++) {
+        bench_prepare_payroll(&batch[i], i + 1, MONEY_RUPEES(25000 + i * 1500), 0);
+    }
+
+    volatile Money sink = 0;
+    for (int b = 0; b < batches; b++) {
+        Money total = 0;
+
+        int64_t start = db_latency_clock_ns();
+        for (int i = 0; i < BENCH_CALC_BATCH; i++) {
+            total += payroll_calculate_net(&batch[i]);
+        }
+        bench_record(r, db_latency_clock_ns() - start, BENCH_CALC_BATCH);
+
+        sink += total;
+    }
+    (void)sink;
+}
+
+static void bench_remove_database(const char *path) {
+    const char *suffixes[] = { "", "-wal", "-shm", "-journal" };
+
+    for (size_t i = 0; i < G_N_ELEMENTS(suffixes); i++) {
+        char *file = g_strconcat(path, suffixes[i], NULL);
+        g_remove(file);
+        g_free(file);
+    }
+}
+
+static void bench_usage(const char *program) {
+    fprintf(stderr,
+            "Usage: %s [--scale=N] [--repeat=N] [--db-profile=tuned|safe] [--output=FILE]\n"
+            "       %s --check-query-plans\n"
+            "  --scale=N        students, fee records and payroll rows to insert (default %d)\n"
+            "  --repeat=N       list/search queries to time (default %d)\n"
+            "  --db-profile=P   SQLite settings profile (default tuned)\n"
+            "  --output=FILE    JSON results (default stdout)\n"
+            "  --check-query-plans  fail if a hot query scans a whole table\n",
+            program, program, BENCH_DEFAULT_SCALE, BENCH_DEFAULT_REPEAT);
+}
+
+// Seeds an in-memory database and checks every hot query's plan;
+// returns the exit status
+static int bench_check_query_plans(void) {
+    if (!db_init(":memory:") || !db_create_tables()) {
+        LOG_ERROR("Query plan database init failed: %s", db_get_error());
+        db_close();
+        return 1;
+    }
+
+    int failures = db_run_query_plan_check();
+    db_close();
+    return failures > 0 ? 1 : 0;
+}
+
+int main(int argc, char *argv[]) {
+    int scale = BENCH_DEFAULT_SCALE;
+    int repeat = BENCH_DEFAULT_REPEAT;
+    const char *profile = NULL;
+    const char *output = NULL;
+    int check_plans = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--scale=", 8) == 0) {
+            scale = atoi(argv[i] + 8);
+        } else if (strncmp(argv[i], "--repeat=", 9) == 0) {
+            repeat = atoi(argv[i] + 9);
+        } else if (strncmp(argv[i], "--db-profile=", 13) == 0) {
+            profile = argv[i] + 13;
+        } else if (strncmp(argv[i], "--output=", 9) == 0) {
+            output = argv[i] + 9;
+        } else if (strcmp(argv[i], "--check-query-plans") == 0) {
+            check_plans = 1;
+        } else {
+            bench_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (scale < 1 || repeat < 1) {
+        bench_usage(argv[0]);
+        return 1;
+    }
+
+    if (check_plans) {
+        return bench_check_query_plans();
+    }
+
+    // Console only and quiet: per-row INFO lines would swamp the timings
+    log_set_level(LOG_LEVEL_WARNING);
+
+    if (profile != NULL && !db_set_profile(profile)) {
+        return 1;
+    }
+
+    GError *error = NULL;
+    char *db_path = NULL;
+    int fd = g_file_open_tmp("cfms_bench-XXXXXX.db", &db_path, &error);
+    if (fd < 0) {
+        LOG_ERROR("Cannot create benchmark database: %s", error->message);
+        g_error_free(error);
+        return 1;
+    }
+    g_close(fd, NULL);
+
+    if (!db_init(db_path) || !db_create_tables()) {
+        LOG_ERROR("Benchmark database init failed: %s", db_get_error());
+        db_close();
+        bench_remove_database(db_path);
+        g_free(db_path);
+        return 1;
+    }
+
+    int employees = MAX(10, scale / 10);
+    int calc_batches = MAX(1, scale * 10 / BENCH_CALC_BATCH);
+    char (*rolls)[14] = g_malloc0(sizeof(*rolls) * scale);
+    int *emp_ids = g_new0(int, employees);
+    BenchResult results[BENCH_COUNT];
+
+    bench_result_init(&results[BENCH_ADD_STUDENT], bench_names[BENCH_ADD_STUDENT], scale);
+    bench_result_init(&results[BENCH_SAVE_FEE], bench_names[BENCH_SAVE_FEE], scale);
+    bench_result_init(&results[BENCH_LIST_FEES], bench_names[BENCH_LIST_FEES], repeat);
+    bench_result_init(&results[BENCH_SEARCH_FEES], bench_names[BENCH_SEARCH_FEES], repeat);
+    bench_result_init(&results[BENCH_ADD_PAYROLL], bench_names[BENCH_ADD_PAYROLL], scale);
+    bench_result_init(&results[BENCH_CALC_NET], bench_names[BENCH_CALC_NET],
+                      calc_batches);
+
+    fprintf(stderr, "[BENCH] scale %d, repeat %d, database %s\n", scale, repeat, db_path);
+
+    int ok = bench_add_students(&results[BENCH_ADD_STUDENT], scale, rolls) &&
+             bench_save_fees(&results[BENCH_SAVE_FEE], scale, rolls) &&
+             bench_list_fees(&results[BENCH_LIST_FEES], repeat, scale) &&
+             bench_search_fees(&results[BENCH_SEARCH_FEES], repeat, scale, rolls) &&
+             bench_seed_employees(employees, emp_ids) &&
+             bench_add_payroll(&results[BENCH_ADD_PAYROLL], scale, employees, emp_ids);
+    if (ok) {
+        bench_calculate_net(&results[BENCH_CALC_NET], calc_batches);
+    }
+
+    const char *profile_name = db_get_profile_name();
+    db_close();
+    bench_remove_database(db_path);
+    g_free(db_path);
+    g_free(rolls);
+    g_free(emp_ids);
+
+    FILE *out = stdout;
+    if (ok && output != NULL) {
+        out = fopen(output, "w");
+        if (out == NULL) {
+            LOG_ERROR("Cannot write %s", output);
+            ok = 0;
+        }
+    }
+
+    if (ok) {
+        fprintf(out, "{\n");
+        fprintf(out, "  \"benchmark\": \"cfms_bench\",\n");
+        fprintf(out, "  \"format\": %d,\n", BENCH_FORMAT_VERSION);
+        fprintf(out, "  \"scale\": %d,\n", scale);
+        fprintf(out, "  \"repeat\": %d,\n", repeat);
+        fprintf(out, "  \"sqlite_version\": \"%s\",\n", sqlite3_libversion());
+        fprintf(out, "  \"db_profile\": \"%s\",\n", profile_name);
+        fprintf(out, "  \"results\": [\n");
+        for (int i = 0; i < BENCH_COUNT; i++) {
+            bench_write_result(out, &results[i], i == BENCH_COUNT - 1);
+        }
+        fprintf(out, "  ]\n}\n");
+
+        if (out != stdout) {
+            fclose(out);
+            fprintf(stderr, "[BENCH] Results written to %s\n", output);
+        }
+    }
+
+    for (int i = 0; i < BENCH_COUNT; i++) {
+        g_free(results[i].samples);
+    }
+    return ok ? 0 : 1;
+}
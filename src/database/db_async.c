@@ -0,0 +1,316 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sqlite3.h>
+#include <gio/gio.h>
+#include "../../include/database.h"
+#include "../../include/db_async.h"
+#include "../../include/logger.h"
+#include "../../include/db_latency.h"
+
+
+extern sqlite3 *db;
+
+
+// ============================================================================
+// BACKGROUND QUERIES
+//
+// Each load is a GTask run on GIO's worker pool. Workers share one read-only
+// connection, taken under reader_lock, so loads run one at a time and never
+// touch the main connection. Chunks and the final "done" are posted back to
+// the default main context in order, at idle priority so redraws and input
+// are handled between chunks.
+// ============================================================================
+
+typedef struct {
+    char *sql;
+    char **params;
+    char *db_path;
+    DbAsyncRowsFunc on_rows;
+    DbAsyncDoneFunc on_done;
+    gpointer user_data;
+    GCancellable *cancellable;
+    int total_rows;                 // rows delivered, main thread only
+} DbAsyncJob;
+
+typedef struct {
+    DbAsyncJob *job;
+    DbAsyncChunk *chunk;            // NULL marks the end of the load
+} DbAsyncDelivery;
+
+static GMutex reader_lock;
+static sqlite3 *reader = NULL;      // guarded by reader_lock
+static GList *active_loads = NULL;  // GCancellable*, main thread only
+
+
+static DbAsyncChunk* db_async_chunk_new(int n_cols, int capacity) {
+    DbAsyncChunk *chunk = g_new0(DbAsyncChunk, 1);
+    chunk->n_cols = n_cols;
+    chunk->values = g_new0(DbAsyncValue, (gsize)capacity * n_cols);
+    chunk->strings = g_string_chunk_new(4096);
+    return chunk;
+}
+
+void db_async_chunk_free(DbAsyncChunk *chunk) {
+    if (chunk == NULL) {
+        return;
+    }
+    g_string_chunk_free(chunk->strings);
+    g_free(chunk->values);
+    g_free(chunk);
+}
+
+static void db_async_chunk_add_row(DbAsyncChunk *chunk, sqlite3_stmt *stmt) {
+    DbAsyncValue *row = &chunk->values[(gsize)chunk->n_rows * chunk->n_cols];
+
+    for (int col = 0; col < chunk->n_cols; col++) {
+        row[col].type = sqlite3_column_type(stmt, col);
+        switch (row[col].type) {
+            case SQLITE_INTEGER:
+                row[col].v.i = sqlite3_column_int64(stmt, col);
+                break;
+            case SQLITE_FLOAT:
+                row[col].v.d = sqlite3_column_double(stmt, col);
+                break;
+            case SQLITE_NULL:
+                break;
+            default:
+                row[col].type = SQLITE_TEXT;
+                row[col].v.s = g_string_chunk_insert(chunk->strings, (const char *)sqlite3_column_text(stmt, col));
+                break;
+        }
+    }
+    chunk->n_rows++;
+}
+
+// Steps stmt for up to max_rows rows on the calling thread; the chunk may
+// hold fewer rows (none at the end of the result)
+DbAsyncChunk* db_async_chunk_read(sqlite3_stmt *stmt, int max_rows) {
+    DbAsyncChunk *chunk = db_async_chunk_new(sqlite3_column_count(stmt), max_rows);
+    int rc = SQLITE_DONE;
+
+    while (chunk->n_rows < max_rows && (rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        db_async_chunk_add_row(chunk, stmt);
+    }
+
+    if (rc != SQLITE_ROW && rc != SQLITE_DONE) {
+        LOG_ERROR("Query failed: %s", sqlite3_errmsg(sqlite3_db_handle(stmt)));
+    }
+    return chunk;
+}
+
+static void db_async_job_free(DbAsyncJob *job) {
+    g_free(job->sql);
+    g_strfreev(job->params);
+    g_free(job->db_path);
+    g_object_unref(job->cancellable);
+    g_free(job);
+}
+
+static gboolean db_async_deliver(gpointer data) {
+    DbAsyncDelivery *delivery = (DbAsyncDelivery *)data;
+    DbAsyncJob *job = delivery->job;
+    gboolean cancelled = g_cancellable_is_cancelled(job->cancellable);
+
+    if (delivery->chunk != NULL) {
+        if (!cancelled && job->on_rows != NULL) {
+            job->on_rows(delivery->chunk, job->user_data);
+            job->total_rows += delivery->chunk->n_rows;
+        }
+        db_async_chunk_free(delivery->chunk);
+    } else {
+        active_loads = g_list_remove(active_loads, job->cancellable);
+        if (job->on_done != NULL) {
+            job->on_done(job->cancellable, job->total_rows, cancelled, job->user_data);
+        }
+        db_async_job_free(job);
+    }
+
+    g_free(delivery);
+    return G_SOURCE_REMOVE;
+}
+
+static void db_async_post(DbAsyncJob *job, DbAsyncChunk *chunk) {
+    DbAsyncDelivery *delivery = g_new0(DbAsyncDelivery, 1);
+    delivery->job = job;
+    delivery->chunk = chunk;
+    g_main_context_invoke_full(NULL, G_PRIORITY_DEFAULT_IDLE, db_async_deliver, delivery, NULL);
+}
+
+// Steps the query on conn and posts its rows in chunks
+static void db_async_run_query(DbAsyncJob *job, sqlite3 *conn) {
+    sqlite3_stmt *stmt = NULL;
+
+    if (sqlite3_prepare_v2(conn, job->sql, -1, &stmt, NULL) != SQLITE_OK) {
+        LOG_ERROR("Background query failed to prepare: %s", sqlite3_errmsg(conn));
+        return;
+    }
+
+    for (int i = 0; job->params != NULL && job->params[i] != NULL; i++) {
+        sqlite3_bind_text(stmt, i + 1, job->params[i], -1, SQLITE_STATIC);
+    }
+
+    DbAsyncChunk *chunk = NULL;
+    int n_cols = sqlite3_column_count(stmt);
+    int rc;
+
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        if (chunk == NULL) {
+            chunk = db_async_chunk_new(n_cols, DB_ASYNC_CHUNK_ROWS);
+        }
+        db_async_chunk_add_row(chunk, stmt);
+
+        if (chunk->n_rows == DB_ASYNC_CHUNK_ROWS) {
+            db_async_post(job, chunk);
+            chunk = NULL;
+            if (g_cancellable_is_cancelled(job->cancellable)) {
+                break;
+            }
+        }
+    }
+
+    if (rc != SQLITE_ROW && rc != SQLITE_DONE) {
+        LOG_ERROR("Background query failed: %s", sqlite3_errmsg(conn));
+    }
+    if (chunk != NULL) {
+        db_async_post(job, chunk);
+    }
+
+    sqlite3_finalize(stmt);
+}
+
+static void db_async_worker(GTask *task, gpointer source_object, gpointer task_data,
+                            GCancellable *cancellable) {
+    (void)source_object;
+    DbAsyncJob *job = (DbAsyncJob *)task_data;
+
+    g_mutex_lock(&reader_lock);
+
+    if (!g_cancellable_is_cancelled(cancellable)) {
+        if (reader == NULL) {
+            if (sqlite3_open_v2(job->db_path, &reader, SQLITE_OPEN_READONLY, NULL) != SQLITE_OK) {
+                LOG_ERROR("Cannot open read connection: %s", sqlite3_errmsg(reader));
+                sqlite3_close(reader);
+                reader = NULL;
+            } else {
+                sqlite3_busy_timeout(reader, 5000);
+                db_latency_attach(reader);
+            }
+        }
+        if (reader != NULL) {
+            db_async_run_query(job, reader);
+        }
+    }
+
+    g_mutex_unlock(&reader_lock);
+
+    // After this the job belongs to the main loop
+    db_async_post(job, NULL);
+    g_task_return_boolean(task, TRUE);
+}
+
+GCancellable* db_async_query(const char *sql, const char *const *params,
+                             DbAsyncRowsFunc on_rows, DbAsyncDoneFunc on_done,
+                             gpointer user_data) {
+    if (db == NULL || sql == NULL) {
+        return NULL;
+    }
+
+    DbAsyncJob *job = g_new0(DbAsyncJob, 1);
+    job->sql = g_strdup(sql);
+    job->params = g_strdupv((char **)params);
+    job->on_rows = on_rows;
+    job->on_done = on_done;
+    job->user_data = user_data;
+    job->cancellable = g_cancellable_new();
+
+    GCancellable *load = g_object_ref(job->cancellable);
+    active_loads = g_list_prepend(active_loads, load);
+
+    // An in-memory database cannot be opened a second time: query it here,
+    // but still deliver from the main loop so callers see one behaviour
+    const char *path = sqlite3_db_filename(db, "main");
+    if (path == NULL || path[0] == '\0') {
+        db_async_run_query(job, db);
+        db_async_post(job, NULL);
+        return load;
+    }
+
+    job->db_path = g_strdup(path);
+
+    GTask *task = g_task_new(NULL, job->cancellable, NULL, NULL);
+    g_task_set_task_data(task, job, NULL);
+    g_task_run_in_thread(task, db_async_worker);
+    g_object_unref(task);
+
+    return load;
+}
+
+void db_async_cancel(GCancellable **load) {
+    if (load == NULL || *load == NULL) {
+        return;
+    }
+    g_cancellable_cancel(*load);
+    g_clear_object(load);
+}
+
+void db_async_cancel_all(void) {
+    for (GList *l = active_loads; l != NULL; l = l->next) {
+        g_cancellable_cancel((GCancellable *)l->data);
+    }
+}
+
+void db_async_shutdown(void) {
+    db_async_cancel_all();
+
+    g_mutex_lock(&reader_lock);
+    if (reader != NULL) {
+        sqlite3_close(reader);
+        reader = NULL;
+    }
+    g_mutex_unlock(&reader_lock);
+}
+
+
+// ============================================================================
+// CHUNK ACCESSORS
+// ============================================================================
+
+static const DbAsyncValue* db_async_value(const DbAsyncChunk *chunk, int row, int col) {
+    return &chunk->values[(gsize)row * chunk->n_cols + col];
+}
+
+int db_async_int(const DbAsyncChunk *chunk, int row, int col) {
+    const DbAsyncValue *value = db_async_value(chunk, row, col);
+    switch (value->type) {
+        case SQLITE_INTEGER: return (int)value->v.i;
+        case SQLITE_FLOAT:   return (int)value->v.d;
+        case SQLITE_TEXT:    return atoi(value->v.s);
+        default:             return 0;
+    }
+}
+
+sqlite3_int64 db_async_int64(const DbAsyncChunk *chunk, int row, int col) {
+    const DbAsyncValue *value = db_async_value(chunk, row, col);
+    switch (value->type) {
+        case SQLITE_INTEGER: return value->v.i;
+        case SQLITE_FLOAT:   return (sqlite3_int64)value->v.d;
+        case SQLITE_TEXT:    return g_ascii_strtoll(value->v.s, NULL, 10);
+        default:             return 0;
+    }
+}
+
+double db_async_double(const DbAsyncChunk *chunk, int row, int col) {
+    const DbAsyncValue *value = db_async_value(chunk, row, col);
+    switch (value->type) {
+        case SQLITE_INTEGER: return (double)value->v.i;
+        case SQLITE_FLOAT:   return value->v.d;
+        case SQLITE_TEXT:    return atof(value->v.s);
+        default:             return 0.0;
+    }
+}
+
+const char* db_async_text(const DbAsyncChunk *chunk, int row, int col) {
+    const DbAsyncValue *value = db_async_value(chunk, row, col);
+    return value->type == SQLITE_TEXT ? value->v.s : NULL;
+}
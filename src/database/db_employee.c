@@ -2,6 +2,8 @@
 #include <string.h>
 #include <sqlite3.h>
 #include "../../include/database.h"
+#include "../../include/logger.h"
+#include "../../include/db_latency.h"
 
 // External database connection (from db_init.c)
 extern sqlite3 *db;
@@ -9,8 +11,10 @@ extern sqlite3 *db;
 // ============ EMPLOYEE MANAGEMENT FUNCTIONS ============
 
 int db_add_employee(const Employee *emp) {
+    DB_LATENCY_SCOPE();
+
     if (!db || !emp) {
-        fprintf(stderr, "[ERROR] Database or Employee struct is NULL\n");
+        LOG_ERROR("Database or Employee struct is NULL");
         return -1;
     }
 
@@ -21,10 +25,10 @@ int db_add_employee(const Employee *emp) {
         "address, base_salary, status) "
         "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);";
 
-    sqlite3_stmt *stmt = NULL;
-    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, NULL);
-    if (rc != SQLITE_OK) {
-        fprintf(stderr, "[ERROR] Failed to prepare insert: %s\n", sqlite3_errmsg(db));
+    sqlite3_stmt *stmt = db_stmt_acquire(sql);
+
+    if (stmt == NULL) {
+        LOG_ERROR("Failed to prepare insert: %s", sqlite3_errmsg(db));
         return -1;
     }
 
@@ -39,37 +43,94 @@ int db_add_employee(const Employee *emp) {
     sqlite3_bind_text(stmt, 9, emp->email, -1, SQLITE_TRANSIENT);
     sqlite3_bind_text(stmt, 10, emp->mobile_number, -1, SQLITE_TRANSIENT);
     sqlite3_bind_text(stmt, 11, emp->address, -1, SQLITE_TRANSIENT);
-    sqlite3_bind_double(stmt, 12, emp->base_salary);
+    sqlite3_bind_int64(stmt, 12, emp->base_salary);
     sqlite3_bind_text(stmt, 13, emp->status, -1, SQLITE_TRANSIENT);
 
-    rc = sqlite3_step(stmt);
+    int rc = sqlite3_step(stmt);
     if (rc != SQLITE_DONE) {
-        fprintf(stderr, "[ERROR] Failed to insert employee: %s\n", sqlite3_errmsg(db));
-        sqlite3_finalize(stmt);
+        LOG_ERROR("Failed to insert employee: %s", sqlite3_errmsg(db));
+        db_stmt_release(stmt);
         return -1;
     }
 
     int emp_id = (int)sqlite3_last_insert_rowid(db);
-    sqlite3_finalize(stmt);
-    printf("[SUCCESS] Employee added with ID: %d, Name: %s\n", emp_id, emp->emp_name);
+    db_stmt_release(stmt);
+    LOG_SUCCESS("Employee added with ID: %d, Name: %s", emp_id, emp->emp_name);
     return emp_id;
 }
 
+// Employee list, newest first; also run by the background loader
+const char db_employee_list_sql[] =
+    "SELECT emp_id, emp_no, emp_name, emp_dob, department, designation, "
+    "category, reporting_person_name, reporting_person_id, email, "
+    "mobile_number, address, base_salary, status "
+    "FROM employees ORDER BY emp_id DESC;";
+
 int db_get_all_employees(sqlite3_stmt **out_stmt) {
+    DB_LATENCY_SCOPE();
+
     if (!db || !out_stmt) {
-        fprintf(stderr, "[ERROR] Database or output stmt pointer is NULL\n");
+        LOG_ERROR("Database or output stmt pointer is NULL");
         return -1;
     }
 
-    const char *sql =
-        "SELECT emp_id, emp_no, emp_name, emp_dob, department, designation, "
-        "category, reporting_person_name, reporting_person_id, email, "
-        "mobile_number, address, base_salary, status "
-        "FROM employees ORDER BY emp_id DESC;";
+    int rc = sqlite3_prepare_v2(db, db_employee_list_sql, -1, out_stmt, NULL);
+    if (rc != SQLITE_OK) {
+        LOG_ERROR("Failed to prepare select: %s", sqlite3_errmsg(db));
+        return -1;
+    }
+
+    return 0;
+}
+
+// Ranked search over name, emp_no, department, designation, mobile and email.
+// Same columns and contract as db_get_all_employees().
+int db_search_employees(const char *text, sqlite3_stmt **out_stmt) {
+    DB_LATENCY_SCOPE();
+
+    if (!db || !text || !out_stmt) {
+        LOG_ERROR("Database or output stmt pointer is NULL");
+        return -1;
+    }
+
+    char match[256];
+    int rc;
+
+    if (db_search_match_expr(text, match, sizeof(match))) {
+        const char *sql =
+            "SELECT e.emp_id, e.emp_no, e.emp_name, e.emp_dob, e.department, e.designation, "
+            "e.category, e.reporting_person_name, e.reporting_person_id, e.email, "
+            "e.mobile_number, e.address, e.base_salary, e.status "
+            "FROM EmployeeSearch "
+            "JOIN employees e ON e.emp_id = EmployeeSearch.rowid "
+            "WHERE EmployeeSearch MATCH ? "
+            "ORDER BY bm25(EmployeeSearch, 10.0, 10.0, 1.0, 1.0, 5.0, 2.0), e.emp_id DESC;";
+
+        rc = sqlite3_prepare_v2(db, sql, -1, out_stmt, NULL);
+        if (rc == SQLITE_OK) {
+            sqlite3_bind_text(*out_stmt, 1, match, -1, SQLITE_TRANSIENT);
+        }
+    } else {
+        const char *sql =
+            "SELECT emp_id, emp_no, emp_name, emp_dob, department, designation, "
+            "category, reporting_person_name, reporting_person_id, email, "
+            "mobile_number, address, base_salary, status "
+            "FROM employees "
+            "WHERE emp_name LIKE ?1 OR CAST(emp_no AS TEXT) LIKE ?1 OR department LIKE ?1 "
+            "OR designation LIKE ?1 OR mobile_number LIKE ?1 OR email LIKE ?1 "
+            "ORDER BY emp_id DESC;";
+
+        char pattern[256];
+        snprintf(pattern, sizeof(pattern), "%%%s%%", text);
+
+        rc = sqlite3_prepare_v2(db, sql, -1, out_stmt, NULL);
+        if (rc == SQLITE_OK) {
+            sqlite3_bind_text(*out_stmt, 1, pattern, -1, SQLITE_TRANSIENT);
+        }
+    }
 
-    int rc = sqlite3_prepare_v2(db, sql, -1, out_stmt, NULL);
     if (rc != SQLITE_OK) {
-        fprintf(stderr, "[ERROR] Failed to prepare select: %s\n", sqlite3_errmsg(db));
+        LOG_ERROR("Failed to prepare search: %s", sqlite3_errmsg(db));
         return -1;
     }
 
@@ -77,8 +138,10 @@ int db_get_all_employees(sqlite3_stmt **out_stmt) {
 }
 
 int db_get_employee_by_id(int emp_id, Employee *emp) {
+    DB_LATENCY_SCOPE();
+
     if (!db || !emp || emp_id <= 0) {
-        fprintf(stderr, "[ERROR] Invalid database or employee ID\n");
+        LOG_ERROR("Invalid database or employee ID");
         return -1;
     }
 
@@ -88,10 +151,10 @@ int db_get_employee_by_id(int emp_id, Employee *emp) {
         "mobile_number, address, base_salary, status "
         "FROM employees WHERE emp_id = ?;";
 
-    sqlite3_stmt *stmt = NULL;
-    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, NULL);
-    if (rc != SQLITE_OK) {
-        fprintf(stderr, "[ERROR] Failed to prepare select: %s\n", sqlite3_errmsg(db));
+    sqlite3_stmt *stmt = db_stmt_acquire(sql);
+
+    if (stmt == NULL) {
+        LOG_ERROR("Failed to prepare select: %s", sqlite3_errmsg(db));
         return -1;
     }
 
@@ -110,20 +173,22 @@ int db_get_employee_by_id(int emp_id, Employee *emp) {
         strncpy(emp->email, (const char *)sqlite3_column_text(stmt, 9), sizeof(emp->email) - 1);
         strncpy(emp->mobile_number, (const char *)sqlite3_column_text(stmt, 10), sizeof(emp->mobile_number) - 1);
         strncpy(emp->address, (const char *)sqlite3_column_text(stmt, 11), sizeof(emp->address) - 1);
-        emp->base_salary = sqlite3_column_double(stmt, 12);
+        emp->base_salary = sqlite3_column_int64(stmt, 12);
         strncpy(emp->status, (const char *)sqlite3_column_text(stmt, 13), sizeof(emp->status) - 1);
 
-        sqlite3_finalize(stmt);
+        db_stmt_release(stmt);
         return emp->emp_id;
     }
 
-    sqlite3_finalize(stmt);
+    db_stmt_release(stmt);
     return -1;
 }
 
 int db_update_employee(int emp_id, const Employee *emp) {
+    DB_LATENCY_SCOPE();
+
     if (!db || !emp || emp_id <= 0) {
-        fprintf(stderr, "[ERROR] Invalid database or employee ID\n");
+        LOG_ERROR("Invalid database or employee ID");
         return -1;
     }
 
@@ -134,10 +199,10 @@ int db_update_employee(int emp_id, const Employee *emp) {
         "address=?, base_salary=?, status=? "
         "WHERE emp_id=?;";
 
-    sqlite3_stmt *stmt = NULL;
-    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, NULL);
-    if (rc != SQLITE_OK) {
-        fprintf(stderr, "[ERROR] Failed to prepare update: %s\n", sqlite3_errmsg(db));
+    sqlite3_stmt *stmt = db_stmt_acquire(sql);
+
+    if (stmt == NULL) {
+        LOG_ERROR("Failed to prepare update: %s", sqlite3_errmsg(db));
         return -1;
     }
 
@@ -152,60 +217,65 @@ int db_update_employee(int emp_id, const Employee *emp) {
     sqlite3_bind_text(stmt, 9, emp->email, -1, SQLITE_TRANSIENT);
     sqlite3_bind_text(stmt, 10, emp->mobile_number, -1, SQLITE_TRANSIENT);
     sqlite3_bind_text(stmt, 11, emp->address, -1, SQLITE_TRANSIENT);
-    sqlite3_bind_double(stmt, 12, emp->base_salary);
+    sqlite3_bind_int64(stmt, 12, emp->base_salary);
     sqlite3_bind_text(stmt, 13, emp->status, -1, SQLITE_TRANSIENT);
     sqlite3_bind_int(stmt, 14, emp_id);
 
-    rc = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
+    int rc = sqlite3_step(stmt);
+    db_stmt_release(stmt);
 
     if (rc != SQLITE_DONE) {
-        fprintf(stderr, "[ERROR] Failed to update employee\n");
+        LOG_ERROR("Failed to update employee");
         return -1;
     }
 
-    printf("[SUCCESS] Employee %d updated\n", emp_id);
+    LOG_SUCCESS("Employee %d updated", emp_id);
     return emp_id;
 }
 
 int db_delete_employee(int emp_id) {
+    DB_LATENCY_SCOPE();
+
     if (!db || emp_id <= 0) {
-        fprintf(stderr, "[ERROR] Invalid database or employee ID\n");
+        LOG_ERROR("Invalid database or employee ID");
         return -1;
     }
 
     const char *sql = "DELETE FROM employees WHERE emp_id=?;";
-    sqlite3_stmt *stmt = NULL;
-    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, NULL);
-    if (rc != SQLITE_OK) {
-        fprintf(stderr, "[ERROR] Failed to prepare delete: %s\n", sqlite3_errmsg(db));
+    sqlite3_stmt *stmt = db_stmt_acquire(sql);
+    if (stmt == NULL) {
+        LOG_ERROR("Failed to prepare delete: %s", sqlite3_errmsg(db));
         return -1;
     }
 
     sqlite3_bind_int(stmt, 1, emp_id);
-    rc = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
+    int rc = sqlite3_step(stmt);
+    db_stmt_release(stmt);
 
     if (rc != SQLITE_DONE) {
-        fprintf(stderr, "[ERROR] Failed to delete employee\n");
+        LOG_ERROR("Failed to delete employee");
         return -1;
     }
 
-    printf("[SUCCESS] Employee %d deleted\n", emp_id);
+    LOG_SUCCESS("Employee %d deleted", emp_id);
     return emp_id;
 }
 
 int db_get_employee_count(void) {
+    DB_LATENCY_SCOPE();
+
     if (!db) {
-        printf("[ERROR] Database not connected\n");
+        LOG_ERROR("Database not connected");
         return 0;
     }
 
     const char *sql = "SELECT COUNT(*) FROM employees;";
     sqlite3_stmt *stmt = NULL;
 
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
-        printf("[ERROR] Failed to prepare count statement: %s\n", sqlite3_errmsg(db));
+    stmt = db_stmt_acquire(sql);
+
+    if (stmt == NULL) {
+        LOG_ERROR("Failed to prepare count statement: %s", sqlite3_errmsg(db));
         return 0;
     }
 
@@ -214,16 +284,18 @@ int db_get_employee_count(void) {
         count = sqlite3_column_int(stmt, 0);
     }
 
-    sqlite3_finalize(stmt);
-    printf("[INFO] Total employees in database: %d\n", count);
+    db_stmt_release(stmt);
+    LOG_INFO("Total employees in database: %d", count);
     return count;
 }
 
 // ============ BANK DETAILS FUNCTIONS ============
 
 int db_add_bank_details(const BankDetails *bank) {
+    DB_LATENCY_SCOPE();
+
     if (!db || !bank) {
-        fprintf(stderr, "[ERROR] Database or BankDetails struct is NULL\n");
+        LOG_ERROR("Database or BankDetails struct is NULL");
         return -1;
     }
 
@@ -232,10 +304,10 @@ int db_add_bank_details(const BankDetails *bank) {
         "emp_id, account_holder_name, account_number, bank_name, ifsc_code, bank_address) "
         "VALUES (?, ?, ?, ?, ?, ?);";
 
-    sqlite3_stmt *stmt = NULL;
-    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, NULL);
-    if (rc != SQLITE_OK) {
-        fprintf(stderr, "[ERROR] Failed to prepare bank insert: %s\n", sqlite3_errmsg(db));
+    sqlite3_stmt *stmt = db_stmt_acquire(sql);
+
+    if (stmt == NULL) {
+        LOG_ERROR("Failed to prepare bank insert: %s", sqlite3_errmsg(db));
         return -1;
     }
 
@@ -246,22 +318,24 @@ int db_add_bank_details(const BankDetails *bank) {
     sqlite3_bind_text(stmt, 5, bank->ifsc_code, -1, SQLITE_TRANSIENT);
     sqlite3_bind_text(stmt, 6, bank->bank_address, -1, SQLITE_TRANSIENT);
 
-    rc = sqlite3_step(stmt);
+    int rc = sqlite3_step(stmt);
     if (rc != SQLITE_DONE) {
-        fprintf(stderr, "[ERROR] Failed to insert bank details: %s\n", sqlite3_errmsg(db));
-        sqlite3_finalize(stmt);
+        LOG_ERROR("Failed to insert bank details: %s", sqlite3_errmsg(db));
+        db_stmt_release(stmt);
         return -1;
     }
 
     int bank_id = (int)sqlite3_last_insert_rowid(db);
-    sqlite3_finalize(stmt);
-    printf("[SUCCESS] Bank details added for employee %d\n", bank->emp_id);
+    db_stmt_release(stmt);
+    LOG_SUCCESS("Bank details added for employee %d", bank->emp_id);
     return bank_id;
 }
 
 int db_get_bank_details(int emp_id, BankDetails *bank) {
+    DB_LATENCY_SCOPE();
+
     if (!db || !bank || emp_id <= 0) {
-        fprintf(stderr, "[ERROR] Invalid database or employee ID\n");
+        LOG_ERROR("Invalid database or employee ID");
         return -1;
     }
 
@@ -270,10 +344,10 @@ int db_get_bank_details(int emp_id, BankDetails *bank) {
         "bank_name, ifsc_code, bank_address "
         "FROM bank_details WHERE emp_id = ?;";
 
-    sqlite3_stmt *stmt = NULL;
-    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, NULL);
-    if (rc != SQLITE_OK) {
-        fprintf(stderr, "[ERROR] Failed to prepare bank select: %s\n", sqlite3_errmsg(db));
+    sqlite3_stmt *stmt = db_stmt_acquire(sql);
+
+    if (stmt == NULL) {
+        LOG_ERROR("Failed to prepare bank select: %s", sqlite3_errmsg(db));
         return -1;
     }
 
@@ -288,17 +362,19 @@ int db_get_bank_details(int emp_id, BankDetails *bank) {
         strncpy(bank->ifsc_code, (const char *)sqlite3_column_text(stmt, 5), sizeof(bank->ifsc_code) - 1);
         strncpy(bank->bank_address, (const char *)sqlite3_column_text(stmt, 6), sizeof(bank->bank_address) - 1);
 
-        sqlite3_finalize(stmt);
+        db_stmt_release(stmt);
         return bank->bank_id;
     }
 
-    sqlite3_finalize(stmt);
+    db_stmt_release(stmt);
     return -1;
 }
 
 int db_update_bank_details(int emp_id, const BankDetails *bank) {
+    DB_LATENCY_SCOPE();
+
     if (!db || !bank || emp_id <= 0) {
-        fprintf(stderr, "[ERROR] Invalid database or employee ID\n");
+        LOG_ERROR("Invalid database or employee ID");
         return -1;
     }
 
@@ -308,10 +384,10 @@ int db_update_bank_details(int emp_id, const BankDetails *bank) {
         "ifsc_code=?, bank_address=? "
         "WHERE emp_id=?;";
 
-    sqlite3_stmt *stmt = NULL;
-    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, NULL);
-    if (rc != SQLITE_OK) {
-        fprintf(stderr, "[ERROR] Failed to prepare bank update: %s\n", sqlite3_errmsg(db));
+    sqlite3_stmt *stmt = db_stmt_acquire(sql);
+
+    if (stmt == NULL) {
+        LOG_ERROR("Failed to prepare bank update: %s", sqlite3_errmsg(db));
         return -1;
     }
 
@@ -322,41 +398,42 @@ int db_update_bank_details(int emp_id, const BankDetails *bank) {
     sqlite3_bind_text(stmt, 5, bank->bank_address, -1, SQLITE_TRANSIENT);
     sqlite3_bind_int(stmt, 6, emp_id);
 
-    rc = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
+    int rc = sqlite3_step(stmt);
+    db_stmt_release(stmt);
 
     if (rc != SQLITE_DONE) {
-        fprintf(stderr, "[ERROR] Failed to update bank details\n");
+        LOG_ERROR("Failed to update bank details");
         return -1;
     }
 
-    printf("[SUCCESS] Bank details updated for employee %d\n", emp_id);
+    LOG_SUCCESS("Bank details updated for employee %d", emp_id);
     return emp_id;
 }
 
 int db_delete_bank_details(int emp_id) {
+    DB_LATENCY_SCOPE();
+
     if (!db || emp_id <= 0) {
-        fprintf(stderr, "[ERROR] Invalid database or employee ID\n");
+        LOG_ERROR("Invalid database or employee ID");
         return -1;
     }
 
     const char *sql = "DELETE FROM bank_details WHERE emp_id=?;";
-    sqlite3_stmt *stmt = NULL;
-    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, NULL);
-    if (rc != SQLITE_OK) {
-        fprintf(stderr, "[ERROR] Failed to prepare bank delete: %s\n", sqlite3_errmsg(db));
+    sqlite3_stmt *stmt = db_stmt_acquire(sql);
+    if (stmt == NULL) {
+        LOG_ERROR("Failed to prepare bank delete: %s", sqlite3_errmsg(db));
         return -1;
     }
 
     sqlite3_bind_int(stmt, 1, emp_id);
-    rc = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
+    int rc = sqlite3_step(stmt);
+    db_stmt_release(stmt);
 
     if (rc != SQLITE_DONE) {
-        fprintf(stderr, "[ERROR] Failed to delete bank details\n");
+        LOG_ERROR("Failed to delete bank details");
         return -1;
     }
 
-    printf("[SUCCESS] Bank details deleted for employee %d\n", emp_id);
+    LOG_SUCCESS("Bank details deleted for employee %d", emp_id);
     return emp_id;
 }
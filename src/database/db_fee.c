@@ -4,6 +4,8 @@
 #include <sqlite3.h>
 #include <glib.h>                    // ✅ REQUIRED: For g_strlcpy()
 #include "../../include/database.h"
+#include "../../include/logger.h"
+#include "../../include/db_latency.h"
 
 
 extern sqlite3 *db;
@@ -14,58 +16,31 @@ extern sqlite3 *db;
 // ============================================================================
 
 
-int db_get_all_fee_summary_rows(FeeTableRow **out_rows) {
-    if (!db || !out_rows) return 0;
+#define FEE_ROWS_INITIAL_CAPACITY 256
 
-    const char *query = 
-        "SELECT "
-        "    s.student_id, "
-        "    s.name, "
-        "    s.roll_no, "
-        "    s.branch, "
-        "    s.year, "
-        "    s.semester, "
-        "    s.category, "
-        "    s.mobile, "
-        "    COALESCE(fs.institute_paid, 0) as institute_paid, "
-        "    COALESCE(fs.hostel_paid, 0) as hostel_paid, "
-        "    COALESCE(fs.mess_paid, 0) as mess_paid, "
-        "    COALESCE(fs.other_paid, 0) as other_paid, "
-        "    COALESCE(fs.total_paid, 0) as total_paid "
-        "FROM Students s "
-        "LEFT JOIN FeeSummary fs ON s.student_id = fs.student_id "
-        "ORDER BY s.roll_no ASC";
-
-    sqlite3_stmt *stmt;
-    if (sqlite3_prepare_v2(db, query, -1, &stmt, NULL) != SQLITE_OK) {
-        fprintf(stderr, "[ERROR] Failed to prepare query: %s\n", sqlite3_errmsg(db));
-        return 0;
-    }
-
-    // Count rows
+// Steps a fee summary query once, filling a growable row buffer.
+// Returns the row count; *out_rows is NULL when there are no rows.
+static int db_collect_fee_rows(sqlite3_stmt *stmt, FeeTableRow **out_rows) {
+    FeeTableRow *rows = NULL;
+    int capacity = 0;
     int row_count = 0;
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        row_count++;
-    }
-
-    if (row_count == 0) {
-        sqlite3_finalize(stmt);
-        *out_rows = NULL;
-        return 0;
-    }
 
-    sqlite3_reset(stmt);
+    *out_rows = NULL;
 
-    *out_rows = (FeeTableRow *)malloc(row_count * sizeof(FeeTableRow));
-    if (*out_rows == NULL) {
-        fprintf(stderr, "[ERROR] Memory allocation failed\n");
-        sqlite3_finalize(stmt);
-        return 0;
-    }
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        if (row_count == capacity) {
+            int new_capacity = capacity ? capacity * 2 : FEE_ROWS_INITIAL_CAPACITY;
+            FeeTableRow *grown = (FeeTableRow *)realloc(rows, new_capacity * sizeof(FeeTableRow));
+            if (grown == NULL) {
+                LOG_ERROR("Memory allocation failed");
+                free(rows);
+                return 0;
+            }
+            rows = grown;
+            capacity = new_capacity;
+        }
 
-    int index = 0;
-    while (sqlite3_step(stmt) == SQLITE_ROW && index < row_count) {
-        FeeTableRow *row = &(*out_rows)[index];
+        FeeTableRow *row = &rows[row_count];
 
         row->student_id = sqlite3_column_int(stmt, 0);
         
@@ -87,27 +62,93 @@ int db_get_all_fee_summary_rows(FeeTableRow **out_rows) {
         const char *mobile = (const char *)sqlite3_column_text(stmt, 7);
         g_strlcpy(row->mobile, mobile ? mobile : "", sizeof(row->mobile));
         
-        row->institute_paid = sqlite3_column_double(stmt, 8);
-        row->hostel_paid = sqlite3_column_double(stmt, 9);
-        row->mess_paid = sqlite3_column_double(stmt, 10);
-        row->other_paid = sqlite3_column_double(stmt, 11);
-        row->total_paid = sqlite3_column_double(stmt, 12);
+        row->institute_paid = sqlite3_column_int64(stmt, 8);
+        row->hostel_paid = sqlite3_column_int64(stmt, 9);
+        row->mess_paid = sqlite3_column_int64(stmt, 10);
+        row->other_paid = sqlite3_column_int64(stmt, 11);
+        row->total_paid = sqlite3_column_int64(stmt, 12);
 
         strcpy(row->status, "Active");
 
-        index++;
+        row_count++;
+    }
+
+    *out_rows = rows;
+    return row_count;
+}
+
+
+// The whole fee table in roll_no order; also paged by the fee tab's table
+// model. Columns are in FeeTableRow order (see db_collect_fee_rows).
+const char db_fee_summary_list_sql[] =
+    "SELECT "
+    "    s.student_id, "
+    "    s.name, "
+    "    s.roll_no, "
+    "    s.branch, "
+    "    s.year, "
+    "    s.semester, "
+    "    s.category, "
+    "    s.mobile, "
+    "    COALESCE(fs.institute_paid, 0) as institute_paid, "
+    "    COALESCE(fs.hostel_paid, 0) as hostel_paid, "
+    "    COALESCE(fs.mess_paid, 0) as mess_paid, "
+    "    COALESCE(fs.other_paid, 0) as other_paid, "
+    "    COALESCE(fs.total_paid, 0) as total_paid "
+    "FROM Students s "
+    "LEFT JOIN FeeSummary fs ON s.student_id = fs.student_id "
+    "ORDER BY s.roll_no ASC";
+
+int db_get_all_fee_summary_rows(FeeTableRow **out_rows) {
+    DB_LATENCY_SCOPE();
+
+    if (!db || !out_rows) return 0;
+
+    sqlite3_stmt *stmt;
+    stmt = db_stmt_acquire(db_fee_summary_list_sql);
+    if (stmt == NULL) {
+        LOG_ERROR("Failed to prepare query: %s", sqlite3_errmsg(db));
+        return 0;
     }
 
-    sqlite3_finalize(stmt);
-    printf("[INFO] Retrieved %d fee summary rows\n", row_count);
+    int row_count = db_collect_fee_rows(stmt, out_rows);
+
+    db_stmt_release(stmt);
+    LOG_INFO("Retrieved %d fee summary rows", row_count);
     return row_count;
 }
 
 
 int db_search_fee_summary_by_criteria(const char *search_text, FeeTableRow **out_rows) {
+    DB_LATENCY_SCOPE();
+
     if (!db || !out_rows || !search_text) return 0;
 
-    const char *query = 
+    // Indexed path: StudentSearch covers name, roll_no, branch, father_name
+    // and mobile; best matches first
+    const char *fts_query = 
+        "SELECT "
+        "    s.student_id, "
+        "    s.name, "
+        "    s.roll_no, "
+        "    s.branch, "
+        "    s.year, "
+        "    s.semester, "
+        "    s.category, "
+        "    s.mobile, "
+        "    COALESCE(fs.institute_paid, 0), "
+        "    COALESCE(fs.hostel_paid, 0), "
+        "    COALESCE(fs.mess_paid, 0), "
+        "    COALESCE(fs.other_paid, 0), "
+        "    COALESCE(fs.total_paid, 0) "
+        "FROM StudentSearch "
+        "JOIN Students s ON s.student_id = StudentSearch.rowid "
+        "LEFT JOIN FeeSummary fs ON s.student_id = fs.student_id "
+        "WHERE StudentSearch MATCH ? "
+        "ORDER BY bm25(StudentSearch, 5.0, 10.0, 1.0, 2.0, 5.0), s.roll_no ASC";
+
+    // Fallback for short input or a build without FTS5
+    const char *like_query = 
         "SELECT "
         "    s.student_id, "
         "    s.name, "
@@ -124,87 +165,84 @@ int db_search_fee_summary_by_criteria(const char *search_text, FeeTableRow **out
         "    COALESCE(fs.total_paid, 0) "
         "FROM Students s "
         "LEFT JOIN FeeSummary fs ON s.student_id = fs.student_id "
-        "WHERE s.name LIKE ? OR s.roll_no LIKE ? OR s.branch LIKE ? "
+        "WHERE s.name LIKE ?1 OR s.roll_no LIKE ?1 OR s.branch LIKE ?1 "
         "ORDER BY s.roll_no ASC";
 
-    sqlite3_stmt *stmt;
-    if (sqlite3_prepare_v2(db, query, -1, &stmt, NULL) != SQLITE_OK) {
-        fprintf(stderr, "[ERROR] Failed to prepare search: %s\n", sqlite3_errmsg(db));
-        return 0;
-    }
-
     char pattern[512];
-    snprintf(pattern, sizeof(pattern), "%%%s%%", search_text);
-
-    sqlite3_bind_text(stmt, 1, pattern, -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 2, pattern, -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 3, pattern, -1, SQLITE_TRANSIENT);
-
-    int row_count = 0;
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        row_count++;
+    int use_fts = db_search_match_expr(search_text, pattern, sizeof(pattern));
+    if (!use_fts) {
+        snprintf(pattern, sizeof(pattern), "%%%s%%", search_text);
     }
 
-    if (row_count == 0) {
-        sqlite3_finalize(stmt);
-        *out_rows = NULL;
+    sqlite3_stmt *stmt;
+    stmt = use_fts ? db_stmt_acquire(fts_query) : db_stmt_acquire_scan(like_query);
+    if (stmt == NULL) {
+        LOG_ERROR("Failed to prepare search: %s", sqlite3_errmsg(db));
         return 0;
     }
 
-    sqlite3_reset(stmt);
     sqlite3_bind_text(stmt, 1, pattern, -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 2, pattern, -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 3, pattern, -1, SQLITE_TRANSIENT);
 
-    *out_rows = (FeeTableRow *)malloc(row_count * sizeof(FeeTableRow));
-    if (*out_rows == NULL) {
-        fprintf(stderr, "[ERROR] Memory allocation failed\n");
-        sqlite3_finalize(stmt);
-        return 0;
-    }
+    int row_count = db_collect_fee_rows(stmt, out_rows);
 
-    int index = 0;
-    while (sqlite3_step(stmt) == SQLITE_ROW && index < row_count) {
-        FeeTableRow *row = &(*out_rows)[index];
+    db_stmt_release(stmt);
+    LOG_INFO("Found %d matching records", row_count);
+    return row_count;
+}
 
-        row->student_id = sqlite3_column_int(stmt, 0);
-        
-        const char *name = (const char *)sqlite3_column_text(stmt, 1);
-        g_strlcpy(row->student_name, name ? name : "", sizeof(row->student_name));
-        
-        const char *roll_no = (const char *)sqlite3_column_text(stmt, 2);
-        g_strlcpy(row->roll_no, roll_no ? roll_no : "", sizeof(row->roll_no));
-        
-        const char *branch = (const char *)sqlite3_column_text(stmt, 3);
-        g_strlcpy(row->branch, branch ? branch : "", sizeof(row->branch));
-        
-        row->year = sqlite3_column_int(stmt, 4);
-        row->semester = sqlite3_column_int(stmt, 5);
-        
-        const char *category = (const char *)sqlite3_column_text(stmt, 6);
-        g_strlcpy(row->category, category ? category : "", sizeof(row->category));
-        
-        const char *mobile = (const char *)sqlite3_column_text(stmt, 7);
-        g_strlcpy(row->mobile, mobile ? mobile : "", sizeof(row->mobile));
-        
-        row->institute_paid = sqlite3_column_double(stmt, 8);
-        row->hostel_paid = sqlite3_column_double(stmt, 9);
-        row->mess_paid = sqlite3_column_double(stmt, 10);
-        row->other_paid = sqlite3_column_double(stmt, 11);
-        row->total_paid = sqlite3_column_double(stmt, 12);
 
-        strcpy(row->status, "Active");
+// Keyset pagination: up to :page_rows rows after :after_key in roll_no
+// order. Uses the UNIQUE index on Students.roll_no, so a page costs the
+// same no matter how deep it is. Shared with the fee tab's table model.
+const char db_fee_summary_page_sql[] =
+    "SELECT "
+    "    s.student_id, "
+    "    s.name, "
+    "    s.roll_no, "
+    "    s.branch, "
+    "    s.year, "
+    "    s.semester, "
+    "    s.category, "
+    "    s.mobile, "
+    "    COALESCE(fs.institute_paid, 0), "
+    "    COALESCE(fs.hostel_paid, 0), "
+    "    COALESCE(fs.mess_paid, 0), "
+    "    COALESCE(fs.other_paid, 0), "
+    "    COALESCE(fs.total_paid, 0) "
+    "FROM Students s "
+    "LEFT JOIN FeeSummary fs ON s.student_id = fs.student_id "
+    "WHERE s.roll_no > :after_key "
+    "ORDER BY s.roll_no ASC "
+    "LIMIT :page_rows";
+
+// Returns up to `limit` rows with roll_no greater than after_roll_no (NULL
+// or "" for the first page)
+int db_get_fee_summary_page(const char *after_roll_no, int limit, FeeTableRow **out_rows) {
+    DB_LATENCY_SCOPE();
+
+    if (!db || !out_rows || limit <= 0) return 0;
 
-        index++;
+    sqlite3_stmt *stmt;
+    stmt = db_stmt_acquire(db_fee_summary_page_sql);
+    if (stmt == NULL) {
+        LOG_ERROR("Failed to prepare page query: %s", sqlite3_errmsg(db));
+        return 0;
     }
 
-    sqlite3_finalize(stmt);
-    printf("[INFO] Found %d matching records\n", row_count);
+    sqlite3_bind_text(stmt, sqlite3_bind_parameter_index(stmt, ":after_key"),
+                      after_roll_no ? after_roll_no : "", -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(stmt, sqlite3_bind_parameter_index(stmt, ":page_rows"), limit);
+
+    int row_count = db_collect_fee_rows(stmt, out_rows);
+
+    db_stmt_release(stmt);
     return row_count;
 }
 
 
 int db_get_fee_record(const char *roll_no, FeeRecord *out_fee) {
+    DB_LATENCY_SCOPE();
+
     if (!db || !roll_no || !out_fee) return 0;
 
     const char *query = 
@@ -217,8 +255,9 @@ int db_get_fee_record(const char *roll_no, FeeRecord *out_fee) {
         "FROM Fees WHERE roll_no = ?";
 
     sqlite3_stmt *stmt;
-    if (sqlite3_prepare_v2(db, query, -1, &stmt, NULL) != SQLITE_OK) {
-        fprintf(stderr, "[ERROR] Failed to prepare fee query: %s\n", sqlite3_errmsg(db));
+    stmt = db_stmt_acquire(query);
+    if (stmt == NULL) {
+        LOG_ERROR("Failed to prepare fee query: %s", sqlite3_errmsg(db));
         return 0;
     }
 
@@ -232,35 +271,36 @@ int db_get_fee_record(const char *roll_no, FeeRecord *out_fee) {
         g_strlcpy(out_fee->roll_no, rn ? rn : "", sizeof(out_fee->roll_no));
 
         // Set paid amounts
-        out_fee->institute_paid = sqlite3_column_double(stmt, 3);
-        out_fee->hostel_paid = sqlite3_column_double(stmt, 4);
-        out_fee->mess_paid = sqlite3_column_double(stmt, 5);
-        out_fee->other_paid = sqlite3_column_double(stmt, 6);
+        out_fee->institute_paid = sqlite3_column_int64(stmt, 3);
+        out_fee->hostel_paid = sqlite3_column_int64(stmt, 4);
+        out_fee->mess_paid = sqlite3_column_int64(stmt, 5);
+        out_fee->other_paid = sqlite3_column_int64(stmt, 6);
 
         // Calculate total
         out_fee->total_paid = out_fee->institute_paid + out_fee->hostel_paid + 
                              out_fee->mess_paid + out_fee->other_paid;
 
-        sqlite3_finalize(stmt);
-        printf("[INFO] Fee record found for: %s\n", roll_no);
+        db_stmt_release(stmt);
+        LOG_INFO("Fee record found for: %s", roll_no);
         return 1;
     }
 
-    sqlite3_finalize(stmt);
-    printf("[INFO] No fee record found for: %s\n", roll_no);
+    db_stmt_release(stmt);
+    LOG_INFO("No fee record found for: %s", roll_no);
     return 0;
 }
 
 
-int db_save_fee_record(FeeRecord *fee) {
-    if (!db || !fee) return 0;
-
+// Inserts the fee rows; caller owns the transaction
+static int db_save_fee_record_locked(FeeRecord *fee) {
     // Get student_id
     const char *get_student_query = "SELECT student_id FROM Students WHERE roll_no = ?";
     sqlite3_stmt *stmt;
     
-    if (sqlite3_prepare_v2(db, get_student_query, -1, &stmt, NULL) != SQLITE_OK) {
-        fprintf(stderr, "[ERROR] Failed to prepare student query: %s\n", sqlite3_errmsg(db));
+    stmt = db_stmt_acquire(get_student_query);
+    
+    if (stmt == NULL) {
+        LOG_ERROR("Failed to prepare student query: %s", sqlite3_errmsg(db));
         return 0;
     }
 
@@ -270,10 +310,10 @@ int db_save_fee_record(FeeRecord *fee) {
     if (sqlite3_step(stmt) == SQLITE_ROW) {
         student_id = sqlite3_column_int(stmt, 0);
     }
-    sqlite3_finalize(stmt);
+    db_stmt_release(stmt);
 
     if (student_id < 0) {
-        fprintf(stderr, "[ERROR] Student not found for roll_no: %s\n", fee->roll_no);
+        LOG_ERROR("Student not found for roll_no: %s", fee->roll_no);
         return 0;
     }
 
@@ -282,8 +322,10 @@ int db_save_fee_record(FeeRecord *fee) {
         "INSERT INTO Fees (student_id, roll_no, fee_type, paid_amount, paid_date, payment_mode, status, record_status) "
         "VALUES (?, ?, ?, ?, ?, ?, ?, ?)";
 
-    if (sqlite3_prepare_v2(db, insert_query, -1, &stmt, NULL) != SQLITE_OK) {
-        fprintf(stderr, "[ERROR] Failed to prepare insert: %s\n", sqlite3_errmsg(db));
+    stmt = db_stmt_acquire(insert_query);
+
+    if (stmt == NULL) {
+        LOG_ERROR("Failed to prepare insert: %s", sqlite3_errmsg(db));
         return 0;
     }
 
@@ -294,14 +336,14 @@ int db_save_fee_record(FeeRecord *fee) {
         sqlite3_bind_int(stmt, 1, student_id);
         sqlite3_bind_text(stmt, 2, fee->roll_no, -1, SQLITE_TRANSIENT);
         sqlite3_bind_text(stmt, 3, "Institute", -1, SQLITE_STATIC);
-        sqlite3_bind_double(stmt, 4, fee->institute_paid);
+        sqlite3_bind_int64(stmt, 4, fee->institute_paid);
         sqlite3_bind_text(stmt, 5, fee->institute_date, -1, SQLITE_TRANSIENT);
         sqlite3_bind_text(stmt, 6, fee->institute_mode, -1, SQLITE_TRANSIENT);
         sqlite3_bind_text(stmt, 7, "Paid", -1, SQLITE_STATIC);
         sqlite3_bind_int(stmt, 8, 1);  // record_status: 1 = Submitted
 
         if (sqlite3_step(stmt) != SQLITE_DONE) {
-            fprintf(stderr, "[ERROR] Failed to insert institute fee\n");
+            LOG_ERROR("Failed to insert institute fee");
             success = 0;
         }
         sqlite3_reset(stmt);
@@ -312,14 +354,14 @@ int db_save_fee_record(FeeRecord *fee) {
         sqlite3_bind_int(stmt, 1, student_id);
         sqlite3_bind_text(stmt, 2, fee->roll_no, -1, SQLITE_TRANSIENT);
         sqlite3_bind_text(stmt, 3, "Hostel", -1, SQLITE_STATIC);
-        sqlite3_bind_double(stmt, 4, fee->hostel_paid);
+        sqlite3_bind_int64(stmt, 4, fee->hostel_paid);
         sqlite3_bind_text(stmt, 5, fee->hostel_date, -1, SQLITE_TRANSIENT);
         sqlite3_bind_text(stmt, 6, fee->hostel_mode, -1, SQLITE_TRANSIENT);
         sqlite3_bind_text(stmt, 7, "Paid", -1, SQLITE_STATIC);
         sqlite3_bind_int(stmt, 8, 1);
 
         if (sqlite3_step(stmt) != SQLITE_DONE) {
-            fprintf(stderr, "[ERROR] Failed to insert hostel fee\n");
+            LOG_ERROR("Failed to insert hostel fee");
             success = 0;
         }
         sqlite3_reset(stmt);
@@ -330,14 +372,14 @@ int db_save_fee_record(FeeRecord *fee) {
         sqlite3_bind_int(stmt, 1, student_id);
         sqlite3_bind_text(stmt, 2, fee->roll_no, -1, SQLITE_TRANSIENT);
         sqlite3_bind_text(stmt, 3, "Mess", -1, SQLITE_STATIC);
-        sqlite3_bind_double(stmt, 4, fee->mess_paid);
+        sqlite3_bind_int64(stmt, 4, fee->mess_paid);
         sqlite3_bind_text(stmt, 5, fee->mess_date, -1, SQLITE_TRANSIENT);
         sqlite3_bind_text(stmt, 6, fee->mess_mode, -1, SQLITE_TRANSIENT);
         sqlite3_bind_text(stmt, 7, "Paid", -1, SQLITE_STATIC);
         sqlite3_bind_int(stmt, 8, 1);
 
         if (sqlite3_step(stmt) != SQLITE_DONE) {
-            fprintf(stderr, "[ERROR] Failed to insert mess fee\n");
+            LOG_ERROR("Failed to insert mess fee");
             success = 0;
         }
         sqlite3_reset(stmt);
@@ -348,36 +390,62 @@ int db_save_fee_record(FeeRecord *fee) {
         sqlite3_bind_int(stmt, 1, student_id);
         sqlite3_bind_text(stmt, 2, fee->roll_no, -1, SQLITE_TRANSIENT);
         sqlite3_bind_text(stmt, 3, "Other", -1, SQLITE_STATIC);
-        sqlite3_bind_double(stmt, 4, fee->other_paid);
+        sqlite3_bind_int64(stmt, 4, fee->other_paid);
         sqlite3_bind_text(stmt, 5, fee->other_date, -1, SQLITE_TRANSIENT);
         sqlite3_bind_text(stmt, 6, fee->other_mode, -1, SQLITE_TRANSIENT);
         sqlite3_bind_text(stmt, 7, "Paid", -1, SQLITE_STATIC);
         sqlite3_bind_int(stmt, 8, 1);
 
         if (sqlite3_step(stmt) != SQLITE_DONE) {
-            fprintf(stderr, "[ERROR] Failed to insert other fee\n");
+            LOG_ERROR("Failed to insert other fee");
             success = 0;
         }
     }
 
-    sqlite3_finalize(stmt);
+    db_stmt_release(stmt);
+
+    // FeeSummary is updated by the fees_summary_* triggers
+    return success;
+}
+
 
-    if (success) {
-        db_update_fee_summary(student_id, fee->roll_no, fee);
+int db_save_fee_record(FeeRecord *fee) {
+    DB_LATENCY_SCOPE();
+
+    if (!db || !fee) return 0;
+
+    // One transaction for the ledger rows and the summary: a single commit,
+    // and a failure anywhere leaves neither table touched
+    if (!db_begin_transaction()) {
+        return 0;
     }
 
-    return success;
+    if (!db_save_fee_record_locked(fee)) {
+        db_rollback_transaction();
+        return 0;
+    }
+
+    return db_commit_transaction();
 }
 
 
 int db_update_fee_record(FeeRecord *fee) {
+    DB_LATENCY_SCOPE();
+
     if (!db || !fee) return 0;
 
+    if (!db_begin_transaction()) {
+        return 0;
+    }
+
     const char *get_student_query = "SELECT student_id FROM Students WHERE roll_no = ?";
     sqlite3_stmt *stmt;
     
-    if (sqlite3_prepare_v2(db, get_student_query, -1, &stmt, NULL) != SQLITE_OK) {
-        fprintf(stderr, "[ERROR] Failed to prepare student query\n");
+    stmt = db_stmt_acquire(get_student_query);
+    
+    if (stmt == NULL) {
+        LOG_ERROR("Failed to prepare student query");
+        db_rollback_transaction();
         return 0;
     }
 
@@ -387,18 +455,22 @@ int db_update_fee_record(FeeRecord *fee) {
     if (sqlite3_step(stmt) == SQLITE_ROW) {
         student_id = sqlite3_column_int(stmt, 0);
     }
-    sqlite3_finalize(stmt);
+    db_stmt_release(stmt);
 
     if (student_id < 0) {
-        fprintf(stderr, "[ERROR] Student not found\n");
+        LOG_ERROR("Student not found");
+        db_rollback_transaction();
         return 0;
     }
 
     // Delete old records
     const char *delete_query = "DELETE FROM Fees WHERE student_id = ? AND roll_no = ?";
     
-    if (sqlite3_prepare_v2(db, delete_query, -1, &stmt, NULL) != SQLITE_OK) {
-        fprintf(stderr, "[ERROR] Failed to prepare delete\n");
+    stmt = db_stmt_acquire(delete_query);
+    
+    if (stmt == NULL) {
+        LOG_ERROR("Failed to prepare delete");
+        db_rollback_transaction();
         return 0;
     }
 
@@ -406,87 +478,127 @@ int db_update_fee_record(FeeRecord *fee) {
     sqlite3_bind_text(stmt, 2, fee->roll_no, -1, SQLITE_TRANSIENT);
     
     if (sqlite3_step(stmt) != SQLITE_DONE) {
-        fprintf(stderr, "[ERROR] Failed to delete old records\n");
-        sqlite3_finalize(stmt);
+        LOG_ERROR("Failed to delete old records");
+        db_stmt_release(stmt);
+        db_rollback_transaction();
         return 0;
     }
-    sqlite3_finalize(stmt);
+    db_stmt_release(stmt);
 
-    return db_save_fee_record(fee);
+    if (!db_save_fee_record_locked(fee)) {
+        db_rollback_transaction();
+        return 0;
+    }
+
+    return db_commit_transaction();
 }
 
 
-int db_update_fee_summary(int student_id, const char *roll_no, const FeeRecord *fee) {
-    if (!db || !roll_no) return 0;
+// Recomputes FeeSummary from the Fees ledger and repairs any row that has
+// drifted. Returns 1 on success; *out_repaired (if given) receives the
+// number of summary rows that were inserted or corrected.
+int db_rebuild_fee_summary(int *out_repaired) {
+    DB_LATENCY_SCOPE();
+
+    if (!db) return 0;
 
     const char *upsert_query = 
         "INSERT INTO FeeSummary (student_id, roll_no, institute_paid, hostel_paid, mess_paid, other_paid, total_paid, updated_at) "
-        "VALUES (?, ?, ?, ?, ?, ?, ?, CURRENT_TIMESTAMP) "
+        "SELECT student_id, MIN(roll_no), "
+        "    SUM(CASE WHEN fee_type = 'Institute' THEN COALESCE(paid_amount, 0) ELSE 0 END), "
+        "    SUM(CASE WHEN fee_type = 'Hostel' THEN COALESCE(paid_amount, 0) ELSE 0 END), "
+        "    SUM(CASE WHEN fee_type = 'Mess' THEN COALESCE(paid_amount, 0) ELSE 0 END), "
+        "    SUM(CASE WHEN fee_type = 'Other' THEN COALESCE(paid_amount, 0) ELSE 0 END), "
+        "    SUM(COALESCE(paid_amount, 0)), CURRENT_TIMESTAMP "
+        "FROM Fees WHERE 1 GROUP BY student_id "
         "ON CONFLICT(student_id) DO UPDATE SET "
         "  institute_paid = excluded.institute_paid, "
         "  hostel_paid = excluded.hostel_paid, "
         "  mess_paid = excluded.mess_paid, "
         "  other_paid = excluded.other_paid, "
         "  total_paid = excluded.total_paid, "
-        "  updated_at = CURRENT_TIMESTAMP";
-
-    sqlite3_stmt *stmt;
-    if (sqlite3_prepare_v2(db, upsert_query, -1, &stmt, NULL) != SQLITE_OK) {
-        fprintf(stderr, "[ERROR] Failed to prepare fee summary query\n");
+        "  updated_at = CURRENT_TIMESTAMP "
+        "WHERE institute_paid <> excluded.institute_paid "
+        "   OR hostel_paid <> excluded.hostel_paid "
+        "   OR mess_paid <> excluded.mess_paid "
+        "   OR other_paid <> excluded.other_paid "
+        "   OR total_paid <> excluded.total_paid";
+
+    // Summaries whose ledger rows are all gone
+    const char *orphan_query = 
+        "UPDATE FeeSummary SET institute_paid = 0, hostel_paid = 0, mess_paid = 0, "
+        "other_paid = 0, total_paid = 0, updated_at = CURRENT_TIMESTAMP "
+        "WHERE student_id NOT IN (SELECT student_id FROM Fees) "
+        "AND (institute_paid <> 0 OR hostel_paid <> 0 OR mess_paid <> 0 OR other_paid <> 0 OR total_paid <> 0)";
+
+    if (!db_begin_transaction()) {
         return 0;
     }
 
-    double total = fee->institute_paid + fee->hostel_paid + fee->mess_paid + fee->other_paid;
+    int repaired = 0;
+    const char *queries[] = { upsert_query, orphan_query };
 
-    sqlite3_bind_int(stmt, 1, student_id);
-    sqlite3_bind_text(stmt, 2, roll_no, -1, SQLITE_TRANSIENT);
-    sqlite3_bind_double(stmt, 3, fee->institute_paid);
-    sqlite3_bind_double(stmt, 4, fee->hostel_paid);
-    sqlite3_bind_double(stmt, 5, fee->mess_paid);
-    sqlite3_bind_double(stmt, 6, fee->other_paid);
-    sqlite3_bind_double(stmt, 7, total);
+    // Both read every summary or ledger row by design
+    for (int i = 0; i < 2; i++) {
+        sqlite3_stmt *stmt = db_stmt_acquire_scan(queries[i]);
+        if (stmt == NULL) {
+            LOG_ERROR("Failed to prepare fee summary rebuild: %s", sqlite3_errmsg(db));
+            db_rollback_transaction();
+            return 0;
+        }
 
-    int result = sqlite3_step(stmt) == SQLITE_DONE ? 1 : 0;
+        if (sqlite3_step(stmt) != SQLITE_DONE) {
+            LOG_ERROR("Fee summary rebuild failed: %s", sqlite3_errmsg(db));
+            db_stmt_release(stmt);
+            db_rollback_transaction();
+            return 0;
+        }
 
-    if (!result) {
-        fprintf(stderr, "[ERROR] Failed to update fee summary\n");
+        repaired += sqlite3_changes(db);
+        db_stmt_release(stmt);
     }
 
-    sqlite3_finalize(stmt);
-    return result;
+    if (!db_commit_transaction()) {
+        return 0;
+    }
+
+    if (repaired > 0) {
+        LOG_WARNING("Fee summary rebuild repaired %d row(s)", repaired);
+    } else {
+        LOG_INFO("Fee summary verified: no drift");
+    }
+
+    if (out_repaired) {
+        *out_repaired = repaired;
+    }
+    return 1;
 }
 
 
 int db_delete_fee_record(const char *roll_no) {
+    DB_LATENCY_SCOPE();
+
     if (!db || !roll_no) return 0;
 
+    // The fees_summary_ad trigger takes each deleted row off FeeSummary
     const char *delete_query = "DELETE FROM Fees WHERE roll_no = ?";
 
     sqlite3_stmt *stmt;
-    if (sqlite3_prepare_v2(db, delete_query, -1, &stmt, NULL) != SQLITE_OK) {
-        fprintf(stderr, "[ERROR] Failed to prepare delete: %s\n", sqlite3_errmsg(db));
+    stmt = db_stmt_acquire(delete_query);
+    if (stmt == NULL) {
+        LOG_ERROR("Failed to prepare delete: %s", sqlite3_errmsg(db));
         return 0;
     }
 
     sqlite3_bind_text(stmt, 1, roll_no, -1, SQLITE_TRANSIENT);
 
     int result = sqlite3_step(stmt) == SQLITE_DONE ? 1 : 0;
-    sqlite3_finalize(stmt);
+    db_stmt_release(stmt);
 
     if (result) {
-        printf("[INFO] Fee record deleted for: %s\n", roll_no);
-        
-        // Also delete from fee summary
-        const char *summary_delete = "DELETE FROM FeeSummary WHERE roll_no = ?";
-        if (sqlite3_prepare_v2(db, summary_delete, -1, &stmt, NULL) != SQLITE_OK) {
-            fprintf(stderr, "[ERROR] Failed to delete fee summary\n");
-            return result;
-        }
-        sqlite3_bind_text(stmt, 1, roll_no, -1, SQLITE_TRANSIENT);
-        sqlite3_step(stmt);
-        sqlite3_finalize(stmt);
+        LOG_INFO("Fee record deleted for: %s", roll_no);
     } else {
-        fprintf(stderr, "[ERROR] Failed to delete fee record for: %s\n", roll_no);
+        LOG_ERROR("Failed to delete fee record for: %s", roll_no);
     }
 
     return result;
@@ -494,6 +606,8 @@ int db_delete_fee_record(const char *roll_no) {
 
 
 int db_get_student_for_card_by_roll(const char *roll_no, StudentIDCard *out_student) {
+    DB_LATENCY_SCOPE();
+
     if (!db || !roll_no || !out_student) return 0;
 
     const char *query = 
@@ -501,8 +615,9 @@ int db_get_student_for_card_by_roll(const char *roll_no, StudentIDCard *out_stud
         "FROM Students WHERE roll_no = ? LIMIT 1";
 
     sqlite3_stmt *stmt;
-    if (sqlite3_prepare_v2(db, query, -1, &stmt, NULL) != SQLITE_OK) {
-        fprintf(stderr, "[ERROR] Failed to prepare student query\n");
+    stmt = db_stmt_acquire(query);
+    if (stmt == NULL) {
+        LOG_ERROR("Failed to prepare student query");
         return 0;
     }
 
@@ -510,6 +625,8 @@ int db_get_student_for_card_by_roll(const char *roll_no, StudentIDCard *out_stud
 
     if (sqlite3_step(stmt) == SQLITE_ROW) {
         out_student->student_id = sqlite3_column_int(stmt, 0);
+        out_student->photo = NULL;
+        out_student->photo_size = 0;
         
         const char *name = (const char *)sqlite3_column_text(stmt, 1);
         g_strlcpy(out_student->name, name ? name : "", sizeof(out_student->name));
@@ -538,17 +655,19 @@ int db_get_student_for_card_by_roll(const char *roll_no, StudentIDCard *out_stud
         const char *gender = (const char *)sqlite3_column_text(stmt, 10);
         g_strlcpy(out_student->gender, gender ? gender : "", sizeof(out_student->gender));
 
-        sqlite3_finalize(stmt);
-        printf("[INFO] Student found: %s\n", out_student->name);
+        db_stmt_release(stmt);
+        LOG_INFO("Student found: %s", out_student->name);
         return 1;
     }
 
-    sqlite3_finalize(stmt);
+    db_stmt_release(stmt);
     return 0;
 }
 
 
 int db_get_student_card_by_id(int student_id, StudentIDCard *out_student) {
+    DB_LATENCY_SCOPE();
+
     if (!db || !out_student) return 0;
 
     const char *query = 
@@ -556,8 +675,9 @@ int db_get_student_card_by_id(int student_id, StudentIDCard *out_student) {
         "FROM Students WHERE student_id = ? LIMIT 1";
 
     sqlite3_stmt *stmt;
-    if (sqlite3_prepare_v2(db, query, -1, &stmt, NULL) != SQLITE_OK) {
-        fprintf(stderr, "[ERROR] Failed to prepare student query\n");
+    stmt = db_stmt_acquire(query);
+    if (stmt == NULL) {
+        LOG_ERROR("Failed to prepare student query");
         return 0;
     }
 
@@ -565,6 +685,8 @@ int db_get_student_card_by_id(int student_id, StudentIDCard *out_student) {
 
     if (sqlite3_step(stmt) == SQLITE_ROW) {
         out_student->student_id = sqlite3_column_int(stmt, 0);
+        out_student->photo = NULL;
+        out_student->photo_size = 0;
         
         const char *name = (const char *)sqlite3_column_text(stmt, 1);
         g_strlcpy(out_student->name, name ? name : "", sizeof(out_student->name));
@@ -593,12 +715,12 @@ int db_get_student_card_by_id(int student_id, StudentIDCard *out_student) {
         const char *gender = (const char *)sqlite3_column_text(stmt, 10);
         g_strlcpy(out_student->gender, gender ? gender : "", sizeof(out_student->gender));
 
-        sqlite3_finalize(stmt);
-        printf("[INFO] Student card loaded: %s\n", out_student->name);
+        db_stmt_release(stmt);
+        LOG_INFO("Student card loaded: %s", out_student->name);
         return 1;
     }
 
-    sqlite3_finalize(stmt);
+    db_stmt_release(stmt);
     return 0;
 }
 
@@ -610,44 +732,18 @@ int db_get_student_card_by_id(int student_id, StudentIDCard *out_student) {
 void db_free_fee_table_rows(FeeTableRow *rows) {
     if (rows) {
         free(rows);
-        printf("[INFO] Fee table rows freed\n");
+        LOG_INFO("Fee table rows freed");
     }
 }
 
 
+// FeeSummary is created by the schema migrations in db_init.c
 int db_create_fee_table(void) {
+    DB_LATENCY_SCOPE();
+
     if (!db) {
-        fprintf(stderr, "[ERROR] Database not initialized\n");
+        LOG_ERROR("Database not initialized");
         return 0;
     }
-
-    const char *fee_tables[] = {
-        "CREATE TABLE IF NOT EXISTS FeeSummary ("
-        "    summary_id INTEGER PRIMARY KEY AUTOINCREMENT,"
-        "    student_id INTEGER NOT NULL,"
-        "    roll_no TEXT NOT NULL,"
-        "    institute_paid REAL DEFAULT 0.0,"
-        "    hostel_paid REAL DEFAULT 0.0,"
-        "    mess_paid REAL DEFAULT 0.0,"
-        "    other_paid REAL DEFAULT 0.0,"
-        "    total_paid REAL DEFAULT 0.0,"
-        "    updated_at DATETIME DEFAULT CURRENT_TIMESTAMP,"
-        "    FOREIGN KEY(student_id) REFERENCES Students(student_id)"
-        ")",
-        NULL
-    };
-
-    for (int i = 0; fee_tables[i] != NULL; i++) {
-        char *err = NULL;
-        int rc = sqlite3_exec(db, fee_tables[i], NULL, NULL, &err);
-
-        if (rc != SQLITE_OK) {
-            fprintf(stderr, "[ERROR] Failed to create fee table: %s\n", err);
-            sqlite3_free(err);
-            return 0;
-        }
-    }
-
-    printf("[INFO] Fee tables created successfully\n");
-    return 1;
-}
\ No newline at end of file
+    return db_migrate();
+}
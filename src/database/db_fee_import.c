@@ -0,0 +1,446 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <sqlite3.h>
+#include <glib.h>
+#include "../../include/database.h"
+#include "../../include/validators.h"
+#include "../../include/logger.h"
+#include "../../include/db_latency.h"
+
+
+extern sqlite3 *db;
+
+
+// ============================================================================
+// SETTLEMENT FILE IMPORT
+//
+// Streams a bank/UPI settlement CSV into Fees and FeePaymentHistory.
+// One line per payment:
+//
+//     roll_no,amount,payment_date,payment_mode,receipt_no[,fee_type]
+//
+// A first line starting with "roll_no" is treated as a header. fee_type
+// defaults to Institute. Rejected lines are reported and copied, with the
+// reason appended, to <file>.rejected.csv so they can be fixed and re-fed.
+// receipt_no is UNIQUE in both tables, so re-importing a file only adds the
+// lines that were not already accepted.
+// ============================================================================
+
+#define IMPORT_LINE_MAX      1024
+#define IMPORT_MAX_FIELDS    8
+#define IMPORT_REJECT_LOG    20      // per-line rejection messages per batch
+
+typedef struct {
+    char roll_no[14];
+    int student_id;
+} RollIndexEntry;
+
+typedef struct {
+    RollIndexEntry *entries;
+    int count;
+} RollIndex;
+
+
+static int roll_index_compare(const void *a, const void *b) {
+    return strcmp(((const RollIndexEntry *)a)->roll_no, ((const RollIndexEntry *)b)->roll_no);
+}
+
+// Loads roll_no -> student_id for every student with one query; the result
+// is already sorted by roll_no so lookups can bsearch it
+static int roll_index_load(RollIndex *index) {
+    const char *query = "SELECT roll_no, student_id FROM Students ORDER BY roll_no";
+    int capacity = 1024;
+
+    index->count = 0;
+    index->entries = (RollIndexEntry *)malloc(capacity * sizeof(RollIndexEntry));
+    if (index->entries == NULL) {
+        LOG_ERROR("Memory allocation failed");
+        return 0;
+    }
+
+    sqlite3_stmt *stmt = db_stmt_acquire(query);
+    if (stmt == NULL) {
+        LOG_ERROR("Failed to prepare roll_no lookup: %s", sqlite3_errmsg(db));
+        free(index->entries);
+        index->entries = NULL;
+        return 0;
+    }
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        if (index->count == capacity) {
+            capacity *= 2;
+            RollIndexEntry *grown = (RollIndexEntry *)realloc(index->entries, capacity * sizeof(RollIndexEntry));
+            if (grown == NULL) {
+                LOG_ERROR("Memory allocation failed");
+                db_stmt_release(stmt);
+                free(index->entries);
+                index->entries = NULL;
+                return 0;
+            }
+            index->entries = grown;
+        }
+
+        RollIndexEntry *entry = &index->entries[index->count++];
+        const char *roll_no = (const char *)sqlite3_column_text(stmt, 0);
+        g_strlcpy(entry->roll_no, roll_no ? roll_no : "", sizeof(entry->roll_no));
+        entry->student_id = sqlite3_column_int(stmt, 1);
+    }
+
+    db_stmt_release(stmt);
+    return 1;
+}
+
+static int roll_index_find(const RollIndex *index, const char *roll_no) {
+    RollIndexEntry key;
+    g_strlcpy(key.roll_no, roll_no, sizeof(key.roll_no));
+
+    const RollIndexEntry *hit = (const RollIndexEntry *)bsearch(&key, index->entries, index->count,
+                                                                sizeof(RollIndexEntry), roll_index_compare);
+    return hit ? hit->student_id : -1;
+}
+
+// Splits one CSV/TSV line in place. Handles double-quoted fields with ""
+// escapes and strips surrounding whitespace. Returns the number of fields.
+int db_split_import_line(char *line, char delimiter, char **fields, int max_fields) {
+    int count = 0;
+    char *p = line;
+
+    while (count < max_fields) {
+        while ((*p == ' ' || *p == '\t') && *p != delimiter) p++;
+
+        char *out = p;
+        fields[count++] = p;
+
+        if (*p == '"') {
+            char *in = p + 1;
+            while (*in != '\0') {
+                if (in[0] == '"' && in[1] == '"') {
+                    *out++ = '"';
+                    in += 2;
+                } else if (*in == '"') {
+                    in++;
+                    break;
+                } else {
+                    *out++ = *in++;
+                }
+            }
+            while (*in != '\0' && *in != delimiter) in++;
+            p = in;
+        } else {
+            while (*p != '\0' && *p != delimiter) p++;
+            out = p;
+        }
+
+        char at = *p;
+        *out = '\0';
+
+        // Trim trailing whitespace / CR
+        char *end = out;
+        while (end > fields[count - 1] && isspace((unsigned char)end[-1])) {
+            *--end = '\0';
+        }
+
+        if (at != delimiter) {
+            break;
+        }
+        p++;
+    }
+
+    return count;
+}
+
+// Settlement files use bank wording; map it onto the app's payment methods
+static const char* normalize_payment_mode(const char *mode) {
+    static const struct { const char *alias; const char *method; } aliases[] = {
+        { "UPI",    "Online" },
+        { "NEFT",   "Bank Transfer" },
+        { "RTGS",   "Bank Transfer" },
+        { "IMPS",   "Bank Transfer" },
+        { "Cheque", "Check" },
+        { NULL, NULL }
+    };
+
+    for (int i = 0; aliases[i].alias != NULL; i++) {
+        if (g_ascii_strcasecmp(mode, aliases[i].alias) == 0) {
+            return aliases[i].method;
+        }
+    }
+    return mode;
+}
+
+static int is_fee_module_type(const char *fee_type) {
+    return strcmp(fee_type, "Institute") == 0 || strcmp(fee_type, "Hostel") == 0 ||
+           strcmp(fee_type, "Mess") == 0 || strcmp(fee_type, "Other") == 0;
+}
+
+// Returns NULL if the line is valid, otherwise the rejection reason
+static const char* validate_settlement_line(char **fields, int field_count, const RollIndex *index,
+                                            int *out_student_id, Money *out_amount) {
+    if (field_count < 5) {
+        return "expected at least 5 fields";
+    }
+
+    Money amount = 0;
+    if (!money_parse(fields[1], &amount) || !validate_amount(amount)) {
+        return "invalid amount";
+    }
+
+    if (!validate_date(fields[2])) {
+        return "invalid payment date";
+    }
+
+    if (!validate_payment_method(fields[3])) {
+        return "unknown payment mode";
+    }
+
+    if (field_count > 5 && fields[5][0] != '\0' && !is_fee_module_type(fields[5])) {
+        return "unknown fee type";
+    }
+
+    int student_id = roll_index_find(index, fields[0]);
+    if (student_id < 0) {
+        return "unknown roll number";
+    }
+
+    *out_student_id = student_id;
+    *out_amount = amount;
+    return NULL;
+}
+
+static void report_batch(int batch_no, int first_line, int last_line, int accepted, int rejected,
+                         gint64 started_us) {
+    double seconds = (g_get_monotonic_time() - started_us) / 1e6;
+    int processed = accepted + rejected;
+
+    LOG_INFO("Batch %d: lines %d-%d, %d accepted, %d rejected, %.0f lines/s",
+             batch_no, first_line, last_line, accepted, rejected,
+             seconds > 0 ? processed / seconds : 0.0);
+}
+
+
+int db_import_fee_settlement(const char *path, int batch_size, FeeImportStats *out_stats) {
+    DB_LATENCY_SCOPE();
+
+    if (!db || !path) return 0;
+
+    if (batch_size <= 0) {
+        batch_size = FEE_IMPORT_DEFAULT_BATCH;
+    }
+
+    FeeImportStats stats;
+    memset(&stats, 0, sizeof(stats));
+    if (out_stats) {
+        *out_stats = stats;
+    }
+
+    FILE *in = fopen(path, "r");
+    if (in == NULL) {
+        LOG_ERROR("Cannot open settlement file: %s", path);
+        return 0;
+    }
+
+    RollIndex index;
+    if (!roll_index_load(&index)) {
+        fclose(in);
+        return 0;
+    }
+    LOG_INFO("Importing %s (%d students indexed, batch size %d)", path, index.count, batch_size);
+
+    const char *fee_insert =
+        "INSERT INTO Fees (student_id, roll_no, fee_type, paid_amount, paid_date, payment_mode, receipt_no, status, record_status) "
+        "VALUES (?, ?, ?, ?, ?, ?, ?, 'Paid', 1)";
+    const char *history_insert =
+        "INSERT INTO FeePaymentHistory (fee_id, student_id, payment_date, amount, payment_mode, receipt_no, remarks) "
+        "VALUES (?, ?, ?, ?, ?, ?, 'Settlement import')";
+
+    sqlite3_stmt *fee_stmt = db_stmt_acquire(fee_insert);
+    sqlite3_stmt *history_stmt = db_stmt_acquire(history_insert);
+    if (fee_stmt == NULL || history_stmt == NULL) {
+        LOG_ERROR("Failed to prepare import statements: %s", sqlite3_errmsg(db));
+        db_stmt_release(fee_stmt);
+        db_stmt_release(history_stmt);
+        free(index.entries);
+        fclose(in);
+        return 0;
+    }
+
+    char reject_path[512];
+    snprintf(reject_path, sizeof(reject_path), "%s.rejected.csv", path);
+    FILE *rejects = NULL;
+
+    char line[IMPORT_LINE_MAX];
+    char raw[IMPORT_LINE_MAX];
+    char *fields[IMPORT_MAX_FIELDS];
+    int line_no = 0;
+    int ok = 1;
+    int in_batch = 0;
+    int batch_first_line = 1;
+    int batch_accepted = 0;
+    int batch_rejected = 0;
+    gint64 import_started = g_get_monotonic_time();
+    gint64 batch_started = import_started;
+
+    while (fgets(line, sizeof(line), in) != NULL) {
+        line_no++;
+
+        size_t len = strlen(line);
+        int truncated = len == sizeof(line) - 1 && line[len - 1] != '\n';
+        if (truncated) {
+            int c;
+            while ((c = fgetc(in)) != EOF && c != '\n') { }
+        }
+        line[strcspn(line, "\r\n")] = '\0';
+
+        if (line[0] == '\0' || (line_no == 1 && g_ascii_strncasecmp(line, "roll_no", 7) == 0)) {
+            continue;
+        }
+
+        if (!in_batch) {
+            if (!db_begin_transaction()) {
+                ok = 0;
+                break;
+            }
+            in_batch = 1;
+            batch_first_line = line_no;
+            batch_accepted = 0;
+            batch_rejected = 0;
+            batch_started = g_get_monotonic_time();
+        }
+
+        g_strlcpy(raw, line, sizeof(raw));
+
+        int student_id = -1;
+        Money amount = 0;
+        const char *reason = NULL;
+        int field_count = 0;
+
+        if (truncated) {
+            reason = "line too long";
+        } else {
+            field_count = db_split_import_line(line, ',', fields, IMPORT_MAX_FIELDS);
+            if (field_count > 3) {
+                fields[3] = (char *)normalize_payment_mode(fields[3]);
+            }
+            reason = validate_settlement_line(fields, field_count, &index, &student_id, &amount);
+        }
+
+        if (reason == NULL) {
+            const char *fee_type = (field_count > 5 && fields[5][0] != '\0') ? fields[5] : "Institute";
+            const char *receipt = fields[4];
+
+            sqlite3_bind_int(fee_stmt, 1, student_id);
+            sqlite3_bind_text(fee_stmt, 2, fields[0], -1, SQLITE_STATIC);
+            sqlite3_bind_text(fee_stmt, 3, fee_type, -1, SQLITE_STATIC);
+            sqlite3_bind_int64(fee_stmt, 4, amount);
+            sqlite3_bind_text(fee_stmt, 5, fields[2], -1, SQLITE_STATIC);
+            sqlite3_bind_text(fee_stmt, 6, fields[3], -1, SQLITE_STATIC);
+            if (receipt[0] != '\0') {
+                sqlite3_bind_text(fee_stmt, 7, receipt, -1, SQLITE_STATIC);
+            } else {
+                sqlite3_bind_null(fee_stmt, 7);
+            }
+
+            int rc = sqlite3_step(fee_stmt);
+            sqlite3_reset(fee_stmt);
+
+            if (rc == SQLITE_CONSTRAINT) {
+                reason = "duplicate receipt number";
+            } else if (rc != SQLITE_DONE) {
+                LOG_ERROR("Fee insert failed at line %d: %s", line_no, sqlite3_errmsg(db));
+                ok = 0;
+                break;
+            } else {
+                sqlite3_int64 fee_id = sqlite3_last_insert_rowid(db);
+
+                sqlite3_bind_int64(history_stmt, 1, fee_id);
+                sqlite3_bind_int(history_stmt, 2, student_id);
+                sqlite3_bind_text(history_stmt, 3, fields[2], -1, SQLITE_STATIC);
+                sqlite3_bind_int64(history_stmt, 4, amount);
+                sqlite3_bind_text(history_stmt, 5, fields[3], -1, SQLITE_STATIC);
+                if (receipt[0] != '\0') {
+                    sqlite3_bind_text(history_stmt, 6, receipt, -1, SQLITE_STATIC);
+                } else {
+                    sqlite3_bind_null(history_stmt, 6);
+                }
+
+                rc = sqlite3_step(history_stmt);
+                sqlite3_reset(history_stmt);
+
+                if (rc != SQLITE_DONE) {
+                    LOG_ERROR("Payment history insert failed at line %d: %s", line_no, sqlite3_errmsg(db));
+                    ok = 0;
+                    break;
+                }
+                batch_accepted++;
+            }
+        }
+
+        if (reason != NULL) {
+            batch_rejected++;
+            if (batch_rejected <= IMPORT_REJECT_LOG) {
+                LOG_WARNING("Line %d rejected: %s", line_no, reason);
+            }
+            if (rejects == NULL) {
+                rejects = fopen(reject_path, "w");
+            }
+            if (rejects != NULL) {
+                fprintf(rejects, "%s,\"%s\"\n", raw, reason);
+            }
+        }
+
+        if (batch_accepted + batch_rejected >= batch_size) {
+            if (!db_commit_transaction()) {
+                ok = 0;
+                in_batch = 0;
+                break;
+            }
+            in_batch = 0;
+            stats.batches++;
+            stats.accepted += batch_accepted;
+            stats.rejected += batch_rejected;
+            report_batch(stats.batches, batch_first_line, line_no, batch_accepted, batch_rejected, batch_started);
+        }
+    }
+
+    if (in_batch) {
+        if (!ok) {
+            db_rollback_transaction();
+        } else if (!db_commit_transaction()) {
+            ok = 0;
+        }
+
+        if (ok) {
+            stats.batches++;
+            stats.accepted += batch_accepted;
+            stats.rejected += batch_rejected;
+            report_batch(stats.batches, batch_first_line, line_no, batch_accepted, batch_rejected, batch_started);
+        } else {
+            LOG_ERROR("Batch starting at line %d rolled back", batch_first_line);
+        }
+    }
+
+    db_stmt_release(fee_stmt);
+    db_stmt_release(history_stmt);
+    free(index.entries);
+    fclose(in);
+    if (rejects != NULL) {
+        fclose(rejects);
+    }
+
+    stats.lines = line_no;
+    stats.seconds = (g_get_monotonic_time() - import_started) / 1e6;
+
+    LOG_INFO("Import %s: %d accepted, %d rejected in %d batch(es), %.2fs (%.0f lines/s)",
+             ok ? "complete" : "stopped", stats.accepted, stats.rejected, stats.batches, stats.seconds,
+             stats.seconds > 0 ? (stats.accepted + stats.rejected) / stats.seconds : 0.0);
+    if (stats.rejected > 0) {
+        LOG_INFO("Rejected lines written to %s", reject_path);
+    }
+
+    if (out_stats) {
+        *out_stats = stats;
+    }
+    return ok;
+}
@@ -1,26 +1,362 @@
 #include <sqlite3.h>
 #include <stdio.h>
+#include <ctype.h>
 #include <stdlib.h>
 #include <string.h>
+#include <glib.h>
 #include "../include/database.h"
+#include "../include/logger.h"
+#include "../include/db_latency.h"
 
 sqlite3 *db = NULL;
 static char db_error_msg[512] = {0};
 
+/* ============================================================================
+ * PREPARED STATEMENT REGISTRY
+ * Each distinct SQL text is prepared once and reused; db_stmt_acquire()
+ * hands out a reset, binding-cleared handle and db_stmt_release() returns it.
+ * db_stmt_acquire_scan() is the same for a statement that reads a whole table
+ * by design; the query plan check lets only those scan.
+ * All cached statements are finalized in db_close().
+ * ============================================================================ */
+
+#define DB_STMT_CACHE_SIZE 96
+
+typedef struct {
+    char *sql;
+    sqlite3_stmt *stmt;
+    unsigned long hits;
+    int in_use;
+    int scan_ok;                // acquired with db_stmt_acquire_scan()
+} DbStmtEntry;
+
+static DbStmtEntry stmt_cache[DB_STMT_CACHE_SIZE];
+static int stmt_cache_count = 0;
+static unsigned long stmt_uncached_prepares = 0;
+
+static DbStmtEntry* db_stmt_find(const char *sql) {
+    for (int i = 0; i < stmt_cache_count; i++) {
+        if (stmt_cache[i].sql == sql || strcmp(stmt_cache[i].sql, sql) == 0) {
+            return &stmt_cache[i];
+        }
+    }
+    return NULL;
+}
+
+static sqlite3_stmt* db_stmt_acquire_entry(const char *sql, int scan_ok) {
+    if (db == NULL || sql == NULL) {
+        return NULL;
+    }
+
+    DbStmtEntry *entry = db_stmt_find(sql);
+
+    if (entry != NULL && !entry->in_use) {
+        entry->in_use = 1;
+        entry->hits++;
+        return entry->stmt;
+    }
+
+    sqlite3_stmt *stmt = NULL;
+    if (sqlite3_prepare_v3(db, sql, -1, SQLITE_PREPARE_PERSISTENT, &stmt, NULL) != SQLITE_OK) {
+        snprintf(db_error_msg, sizeof(db_error_msg),
+                "Failed to prepare statement: %s", sqlite3_errmsg(db));
+        return NULL;
+    }
+
+    // Already handed out (nested use) or cache full: caller gets a private handle
+    if (entry != NULL || stmt_cache_count >= DB_STMT_CACHE_SIZE) {
+        stmt_uncached_prepares++;
+        return stmt;
+    }
+
+    char *sql_copy = malloc(strlen(sql) + 1);
+    if (sql_copy == NULL) {
+        stmt_uncached_prepares++;
+        return stmt;
+    }
+    strcpy(sql_copy, sql);
+
+    entry = &stmt_cache[stmt_cache_count++];
+    entry->sql = sql_copy;
+    entry->stmt = stmt;
+    entry->hits = 1;
+    entry->in_use = 1;
+    entry->scan_ok = scan_ok;
+    return stmt;
+}
+
+sqlite3_stmt* db_stmt_acquire(const char *sql) {
+    return db_stmt_acquire_entry(sql, 0);
+}
+
+sqlite3_stmt* db_stmt_acquire_scan(const char *sql) {
+    return db_stmt_acquire_entry(sql, 1);
+}
+
+void db_stmt_release(sqlite3_stmt *stmt) {
+    if (stmt == NULL) {
+        return;
+    }
+
+    for (int i = 0; i < stmt_cache_count; i++) {
+        if (stmt_cache[i].stmt == stmt) {
+            sqlite3_reset(stmt);
+            sqlite3_clear_bindings(stmt);
+            stmt_cache[i].in_use = 0;
+            return;
+        }
+    }
+
+    sqlite3_finalize(stmt);
+}
+
+void db_stmt_print_stats(void) {
+    LOG_INFO("Prepared statement cache: %d statements, %lu uncached prepares",
+             stmt_cache_count, stmt_uncached_prepares);
+
+    for (int i = 0; i < stmt_cache_count; i++) {
+        char preview[61];
+        snprintf(preview, sizeof(preview), "%s", stmt_cache[i].sql);
+        LOG_INFO("  %6lu hits | %s%s", stmt_cache[i].hits, preview,
+                 strlen(stmt_cache[i].sql) > 60 ? "..." : "");
+    }
+}
+
+// Calls fn(sql, scan_ok, ctx) for every cached statement; stops early if fn returns 0
+void db_stmt_foreach(int (*fn)(const char *sql, int scan_ok, void *ctx), void *ctx) {
+    for (int i = 0; i < stmt_cache_count; i++) {
+        if (!fn(stmt_cache[i].sql, stmt_cache[i].scan_ok, ctx)) {
+            return;
+        }
+    }
+}
+
+static void db_stmt_clear_cache(void) {
+    for (int i = 0; i < stmt_cache_count; i++) {
+        sqlite3_finalize(stmt_cache[i].stmt);
+        free(stmt_cache[i].sql);
+        stmt_cache[i].sql = NULL;
+        stmt_cache[i].stmt = NULL;
+        stmt_cache[i].hits = 0;
+        stmt_cache[i].in_use = 0;
+    }
+    stmt_cache_count = 0;
+    stmt_uncached_prepares = 0;
+}
+
+/* ============================================================================
+ * CONNECTION PROFILES
+ * A profile is the set of PRAGMAs applied right after the connection opens.
+ * "tuned" is the default; "safe" keeps SQLite's rollback journal with full
+ * sync for machines where the database lives on a network share (WAL needs
+ * shared memory and does not work there).
+ * ============================================================================ */
+
+typedef struct {
+    const char *name;
+    const char *journal_mode;     // WAL, DELETE, ...
+    const char *synchronous;      // OFF, NORMAL, FULL
+    long long mmap_size;          // bytes, 0 disables memory-mapped I/O
+    int cache_size;               // negative = KiB, positive = pages
+    const char *temp_store;       // DEFAULT, FILE, MEMORY
+    int busy_timeout_ms;
+} DbProfile;
+
+static const DbProfile db_profiles[] = {
+    { "tuned", "WAL",    "NORMAL", 268435456LL, -65536, "MEMORY",  5000 },
+    { "safe",  "DELETE", "FULL",   0LL,         -2000,  "DEFAULT", 5000 },
+    { NULL, NULL, NULL, 0LL, 0, NULL, 0 }
+};
+
+static const DbProfile *active_profile = &db_profiles[0];
+
+int db_set_profile(const char *name) {
+    if (name == NULL || name[0] == '\0') {
+        return 0;
+    }
+
+    for (int i = 0; db_profiles[i].name != NULL; i++) {
+        if (strcmp(db_profiles[i].name, name) == 0) {
+            active_profile = &db_profiles[i];
+            return 1;
+        }
+    }
+
+    LOG_WARNING("Unknown database profile '%s', keeping '%s'",
+                name, active_profile->name);
+    return 0;
+}
+
+const char* db_get_profile_name(void) {
+    return active_profile->name;
+}
+
+static int db_apply_profile(const DbProfile *profile) {
+    char sql[256];
+    char *err = NULL;
+
+    snprintf(sql, sizeof(sql),
+             "PRAGMA journal_mode = %s;"
+             "PRAGMA synchronous = %s;"
+             "PRAGMA mmap_size = %lld;"
+             "PRAGMA cache_size = %d;"
+             "PRAGMA temp_store = %s;",
+             profile->journal_mode, profile->synchronous, profile->mmap_size,
+             profile->cache_size, profile->temp_store);
+
+    if (sqlite3_exec(db, sql, NULL, NULL, &err) != SQLITE_OK) {
+        snprintf(db_error_msg, sizeof(db_error_msg),
+                "Failed to apply profile '%s': %s", profile->name, err);
+        LOG_ERROR("%s", db_error_msg);
+        sqlite3_free(err);
+        return 0;
+    }
+
+    sqlite3_busy_timeout(db, profile->busy_timeout_ms);
+    return 1;
+}
+
+static void db_pragma_text(const char *pragma, char *out, size_t out_size) {
+    sqlite3_stmt *stmt = NULL;
+
+    snprintf(out, out_size, "?");
+    if (sqlite3_prepare_v2(db, pragma, -1, &stmt, NULL) != SQLITE_OK) {
+        return;
+    }
+    if (sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_text(stmt, 0) != NULL) {
+        snprintf(out, out_size, "%s", (const char *)sqlite3_column_text(stmt, 0));
+    }
+    sqlite3_finalize(stmt);
+}
+
+// Reads the settings back from SQLite so the log shows what actually took effect
+static void db_print_effective_settings(void) {
+    static const char *sync_names[] = { "OFF", "NORMAL", "FULL", "EXTRA" };
+    static const char *temp_names[] = { "DEFAULT", "FILE", "MEMORY" };
+    char journal[16], sync[16], mmap[32], cache[32], temp[16], busy[16];
+
+    db_pragma_text("PRAGMA journal_mode;", journal, sizeof(journal));
+    db_pragma_text("PRAGMA synchronous;", sync, sizeof(sync));
+    db_pragma_text("PRAGMA mmap_size;", mmap, sizeof(mmap));
+    db_pragma_text("PRAGMA cache_size;", cache, sizeof(cache));
+    db_pragma_text("PRAGMA temp_store;", temp, sizeof(temp));
+    db_pragma_text("PRAGMA busy_timeout;", busy, sizeof(busy));
+
+    int sync_level = atoi(sync);
+    int temp_level = atoi(temp);
+
+    LOG_INFO("Database profile '%s': journal_mode=%s synchronous=%s "
+             "mmap_size=%s cache_size=%s temp_store=%s busy_timeout=%sms",
+             active_profile->name, journal,
+             (sync_level >= 0 && sync_level <= 3) ? sync_names[sync_level] : sync,
+             mmap, cache,
+             (temp_level >= 0 && temp_level <= 2) ? temp_names[temp_level] : temp,
+             busy);
+}
+
 int db_init(const char *db_path) {
+    DB_LATENCY_SCOPE();
+
     int rc = sqlite3_open(db_path ? db_path : "college_finance.db", &db);
-    
+
     if (rc != SQLITE_OK) {
-        snprintf(db_error_msg, sizeof(db_error_msg), 
+        snprintf(db_error_msg, sizeof(db_error_msg),
                 "Cannot open database: %s", sqlite3_errmsg(db));
-        fprintf(stderr, "%s\n", db_error_msg);
+        LOG_ERROR("%s", db_error_msg);
+        return 0;
+    }
+
+    LOG_INFO("Database connection opened: college_finance.db");
+    db_latency_attach(db);
+
+    if (!db_apply_profile(active_profile)) {
+        sqlite3_close(db);
+        db = NULL;
+        return 0;
+    }
+
+    db_print_effective_settings();
+    return 1;
+}
+
+/* ============================================================================
+ * TRANSACTIONS
+ * BEGIN IMMEDIATE takes the write lock up front, so a multi-statement write
+ * either fails before doing any work or runs to COMMIT without being
+ * upgraded mid-way (which is where SQLITE_BUSY deadlocks come from).
+ * Calls made while a transaction is already open nest as savepoints, so a
+ * helper that wraps itself in a transaction can run inside a larger one.
+ * A commit that fails rolls back its own level and nothing more, so callers
+ * never roll back after it.
+ * ============================================================================ */
+
+static int transaction_depth = 0;
+
+int db_begin_transaction(void) {
+    DB_LATENCY_SCOPE();
+
+    char *err = NULL;
+
+    if (db == NULL) {
+        return 0;
+    }
+
+    const char *sql = transaction_depth == 0 ? "BEGIN IMMEDIATE;" : "SAVEPOINT nested;";
+    if (sqlite3_exec(db, sql, NULL, NULL, &err) != SQLITE_OK) {
+        snprintf(db_error_msg, sizeof(db_error_msg),
+                "Failed to begin transaction: %s", err);
+        LOG_ERROR("%s", db_error_msg);
+        sqlite3_free(err);
         return 0;
     }
-    
-    printf("[INFO] Database connection opened: college_finance.db\n");
+    transaction_depth++;
     return 1;
 }
 
+int db_commit_transaction(void) {
+    DB_LATENCY_SCOPE();
+
+    char *err = NULL;
+
+    if (db == NULL || transaction_depth == 0) {
+        return 0;
+    }
+
+    const char *sql = transaction_depth > 1 ? "RELEASE nested;" : "COMMIT;";
+    if (sqlite3_exec(db, sql, NULL, NULL, &err) != SQLITE_OK) {
+        snprintf(db_error_msg, sizeof(db_error_msg),
+                "Failed to commit transaction: %s", err);
+        LOG_ERROR("%s", db_error_msg);
+        sqlite3_free(err);
+        db_rollback_transaction();
+        return 0;
+    }
+    transaction_depth--;
+    return 1;
+}
+
+void db_rollback_transaction(void) {
+    DB_LATENCY_SCOPE();
+
+    if (db == NULL || transaction_depth == 0) {
+        return;
+    }
+    transaction_depth--;
+
+    // SQLite may already have rolled back on its own (e.g. SQLITE_FULL)
+    if (sqlite3_get_autocommit(db)) {
+        transaction_depth = 0;
+        return;
+    }
+
+    const char *sql = transaction_depth > 0 ? "ROLLBACK TO nested; RELEASE nested;" : "ROLLBACK;";
+    if (sqlite3_exec(db, sql, NULL, NULL, NULL) != SQLITE_OK) {
+        LOG_ERROR("Rollback failed: %s", sqlite3_errmsg(db));
+        return;
+    }
+    LOG_WARNING("Transaction rolled back");
+}
+
 const char* db_get_error() {
     return db_error_msg;
 }
@@ -29,16 +365,244 @@ const char* db_payroll_get_error() {
     return db_error_msg;
 }
 
-int db_create_tables() {
-    if (db == NULL) {
-        fprintf(stderr, "[ERROR] Database not initialized\n");
+/* ============================================================================
+ * FULL-TEXT SEARCH INDEX
+ * StudentSearch and EmployeeSearch are FTS5 external-content tables using
+ * the trigram tokenizer, so any 3+ character substring of an indexed column
+ * is an index lookup instead of a '%text%' LIKE scan. Triggers keep them in
+ * step with the base tables; the index is rebuilt once when first created.
+ * ============================================================================ */
+
+static int search_index_available = 0;
+
+static int db_schema_object_exists(const char *name) {
+    const char *sql = "SELECT 1 FROM sqlite_master WHERE name = ?;";
+    sqlite3_stmt *stmt = db_stmt_acquire_scan(sql);
+    int exists = 0;
+
+    if (stmt == NULL) {
         return 0;
     }
 
+    sqlite3_bind_text(stmt, 1, name, -1, SQLITE_STATIC);
+    exists = sqlite3_step(stmt) == SQLITE_ROW;
+    db_stmt_release(stmt);
+    return exists;
+}
+
+static const char *const search_index_statements[] = {
+        "CREATE VIRTUAL TABLE IF NOT EXISTS StudentSearch USING fts5(name, roll_no, branch, father_name, mobile, content='Students', content_rowid='student_id', tokenize='trigram');",
+
+        "CREATE TRIGGER IF NOT EXISTS students_search_ai AFTER INSERT ON Students BEGIN "
+        "INSERT INTO StudentSearch(rowid, name, roll_no, branch, father_name, mobile) VALUES (new.student_id, new.name, new.roll_no, new.branch, new.father_name, new.mobile); END;",
+
+        "CREATE TRIGGER IF NOT EXISTS students_search_ad AFTER DELETE ON Students BEGIN "
+        "INSERT INTO StudentSearch(StudentSearch, rowid, name, roll_no, branch, father_name, mobile) VALUES ('delete', old.student_id, old.name, old.roll_no, old.branch, old.father_name, old.mobile); END;",
+
+        "CREATE TRIGGER IF NOT EXISTS students_search_au AFTER UPDATE ON Students BEGIN "
+        "INSERT INTO StudentSearch(StudentSearch, rowid, name, roll_no, branch, father_name, mobile) VALUES ('delete', old.student_id, old.name, old.roll_no, old.branch, old.father_name, old.mobile); "
+        "INSERT INTO StudentSearch(rowid, name, roll_no, branch, father_name, mobile) VALUES (new.student_id, new.name, new.roll_no, new.branch, new.father_name, new.mobile); END;",
+
+        "CREATE VIRTUAL TABLE IF NOT EXISTS EmployeeSearch USING fts5(emp_name, emp_no, department, designation, mobile_number, email, content='employees', content_rowid='emp_id', tokenize='trigram');",
+
+        "CREATE TRIGGER IF NOT EXISTS employees_search_ai AFTER INSERT ON employees BEGIN "
+        "INSERT INTO EmployeeSearch(rowid, emp_name, emp_no, department, designation, mobile_number, email) VALUES (new.emp_id, new.emp_name, new.emp_no, new.department, new.designation, new.mobile_number, new.email); END;",
+
+        "CREATE TRIGGER IF NOT EXISTS employees_search_ad AFTER DELETE ON employees BEGIN "
+        "INSERT INTO EmployeeSearch(EmployeeSearch, rowid, emp_name, emp_no, department, designation, mobile_number, email) VALUES ('delete', old.emp_id, old.emp_name, old.emp_no, old.department, old.designation, old.mobile_number, old.email); END;",
+
+        "CREATE TRIGGER IF NOT EXISTS employees_search_au AFTER UPDATE ON employees BEGIN "
+        "INSERT INTO EmployeeSearch(EmployeeSearch, rowid, emp_name, emp_no, department, designation, mobile_number, email) VALUES ('delete', old.emp_id, old.emp_name, old.emp_no, old.department, old.designation, old.mobile_number, old.email); "
+        "INSERT INTO EmployeeSearch(rowid, emp_name, emp_no, department, designation, mobile_number, email) VALUES (new.emp_id, new.emp_name, new.emp_no, new.department, new.designation, new.mobile_number, new.email); END;",
+
+        NULL
+};
+
+// Creates the index on conn; the caller owns the transaction
+static int search_index_build(sqlite3 *conn, int student_new, int employee_new) {
     char *err = NULL;
-    int rc;
 
-    const char *sql_statements[] = {
+    for (int i = 0; search_index_statements[i] != NULL; i++) {
+        if (sqlite3_exec(conn, search_index_statements[i], NULL, NULL, &err) != SQLITE_OK) {
+            LOG_WARNING("Search index unavailable, using LIKE search: %s", err);
+            sqlite3_free(err);
+            return 0;
+        }
+    }
+
+    // Existing rows predate the triggers, so index them once
+    if (student_new) {
+        sqlite3_exec(conn, "INSERT INTO StudentSearch(StudentSearch) VALUES ('rebuild');", NULL, NULL, NULL);
+    }
+    if (employee_new) {
+        sqlite3_exec(conn, "INSERT INTO EmployeeSearch(EmployeeSearch) VALUES ('rebuild');", NULL, NULL, NULL);
+    }
+    return 1;
+}
+
+int db_create_search_index(void) {
+    DB_LATENCY_SCOPE();
+
+    if (db == NULL) {
+        return 0;
+    }
+
+    int student_new = !db_schema_object_exists("StudentSearch");
+    int employee_new = !db_schema_object_exists("EmployeeSearch");
+
+    if (!student_new && !employee_new) {
+        search_index_available = 1;
+        return 1;
+    }
+
+    if (!db_begin_transaction()) {
+        return 0;
+    }
+
+    if (!search_index_build(db, student_new, employee_new)) {
+        db_rollback_transaction();
+        search_index_available = 0;
+        return 0;
+    }
+
+    if (!db_commit_transaction()) {
+        search_index_available = 0;
+        return 0;
+    }
+
+    search_index_available = 1;
+    LOG_INFO("Search index built");
+    return 1;
+}
+
+// Background build: indexing every existing row can take seconds on a large
+// database, so the GUI does it on a thread with its own connection while
+// searches fall back to LIKE. The result comes back on the main loop.
+typedef struct {
+    char *path;
+    int student_new;
+    int employee_new;
+    int ok;
+    DbSearchIndexReadyFunc on_ready;
+    void *user_data;
+} SearchIndexJob;
+
+static gboolean search_index_job_done(gpointer data) {
+    SearchIndexJob *job = (SearchIndexJob *)data;
+
+    search_index_available = job->ok;
+    if (job->ok) {
+        LOG_INFO("Search index built in the background");
+    }
+    if (job->on_ready != NULL) {
+        job->on_ready(job->ok, job->user_data);
+    }
+
+    g_free(job->path);
+    g_free(job);
+    return G_SOURCE_REMOVE;
+}
+
+static gpointer search_index_job_run(gpointer data) {
+    SearchIndexJob *job = (SearchIndexJob *)data;
+    sqlite3 *conn = NULL;
+
+    if (sqlite3_open_v2(job->path, &conn, SQLITE_OPEN_READWRITE, NULL) == SQLITE_OK) {
+        sqlite3_busy_timeout(conn, active_profile->busy_timeout_ms);
+
+        // IMMEDIATE: queue behind the app's writes instead of failing mid-build
+        job->ok = sqlite3_exec(conn, "BEGIN IMMEDIATE;", NULL, NULL, NULL) == SQLITE_OK &&
+                  search_index_build(conn, job->student_new, job->employee_new) &&
+                  sqlite3_exec(conn, "COMMIT;", NULL, NULL, NULL) == SQLITE_OK;
+        if (!job->ok && !sqlite3_get_autocommit(conn)) {
+            sqlite3_exec(conn, "ROLLBACK;", NULL, NULL, NULL);
+        }
+    } else {
+        LOG_WARNING("Search index connection failed: %s", sqlite3_errmsg(conn));
+    }
+    sqlite3_close(conn);
+
+    g_idle_add(search_index_job_done, job);
+    return NULL;
+}
+
+void db_create_search_index_async(DbSearchIndexReadyFunc on_ready, void *user_data) {
+    DB_LATENCY_SCOPE();
+
+    if (db == NULL) {
+        if (on_ready != NULL) on_ready(0, user_data);
+        return;
+    }
+
+    int student_new = !db_schema_object_exists("StudentSearch");
+    int employee_new = !db_schema_object_exists("EmployeeSearch");
+    const char *path = sqlite3_db_filename(db, "main");
+
+    // Already built (the usual case), or an in-memory database that a
+    // second connection could not see
+    if ((!student_new && !employee_new) || path == NULL || path[0] == '\0') {
+        int ok = db_create_search_index();
+        if (on_ready != NULL) on_ready(ok, user_data);
+        return;
+    }
+
+    SearchIndexJob *job = g_new0(SearchIndexJob, 1);
+    job->path = g_strdup(path);
+    job->student_new = student_new;
+    job->employee_new = employee_new;
+    job->on_ready = on_ready;
+    job->user_data = user_data;
+
+    search_index_available = 0;
+    g_thread_unref(g_thread_new("search-index", search_index_job_run, job));
+}
+
+// Quotes free text as a single FTS5 phrase (a substring match under trigram).
+// Returns 0 when the caller should fall back to LIKE: no FTS5, or fewer than
+// 3 characters, which is below the trigram tokenizer's minimum.
+int db_search_match_expr(const char *text, char *out, size_t out_size) {
+    size_t len = 0;
+
+    if (!search_index_available || text == NULL || out == NULL || out_size < 3) {
+        return 0;
+    }
+    if (strlen(text) < 3) {
+        return 0;
+    }
+
+    out[len++] = '"';
+    for (const char *p = text; *p != '\0'; p++) {
+        size_t need = (*p == '"') ? 2 : 1;
+        if (len + need + 2 > out_size) {
+            return 0;
+        }
+        out[len++] = *p;
+        if (*p == '"') {
+            out[len++] = '"';
+        }
+    }
+    out[len++] = '"';
+    out[len] = '\0';
+    return 1;
+}
+
+/* ============================================================================
+ * SCHEMA MIGRATIONS
+ * The schema is the ordered list below. PRAGMA user_version records the last
+ * migration applied; db_migrate() runs only the pending ones, all inside one
+ * transaction, and an up-to-date database does no DDL at all. Never edit a
+ * migration that has shipped - add a new one.
+ * ============================================================================ */
+
+typedef struct {
+    int version;
+    const char *description;
+    const char *const *statements;      // NULL-terminated, may be NULL
+    int (*apply)(void);                 // extra step run after the statements, may be NULL
+} DbMigration;
+
+// 1: original schema as created by db_create_tables()
+static const char *const migration_1_base[] = {
         "CREATE TABLE IF NOT EXISTS Students (student_id INTEGER PRIMARY KEY AUTOINCREMENT, roll_no TEXT UNIQUE NOT NULL, name TEXT NOT NULL, gender TEXT, father_name TEXT, branch TEXT, year INTEGER, semester INTEGER, category TEXT, mobile TEXT, email TEXT, created_at DATETIME DEFAULT CURRENT_TIMESTAMP);",
 
         "CREATE TABLE IF NOT EXISTS Fees (fee_id INTEGER PRIMARY KEY AUTOINCREMENT, student_id INTEGER NOT NULL, roll_no TEXT NOT NULL, fee_type TEXT NOT NULL, paid_amount REAL DEFAULT 0.0, paid_date DATE, payment_mode TEXT, receipt_no TEXT UNIQUE, status TEXT DEFAULT 'Due', created_at DATETIME DEFAULT CURRENT_TIMESTAMP, updated_at DATETIME DEFAULT CURRENT_TIMESTAMP, record_status INTEGER DEFAULT 0, FOREIGN KEY(student_id) REFERENCES Students(student_id));",
@@ -64,30 +628,611 @@ int db_create_tables() {
         "CREATE INDEX IF NOT EXISTS idx_fee_summary_roll_no ON FeeSummary(roll_no);",
         "CREATE INDEX IF NOT EXISTS idx_payment_history_fee_id ON FeePaymentHistory(fee_id);",
         "CREATE INDEX IF NOT EXISTS idx_payment_history_student_id ON FeePaymentHistory(student_id);",
-
         NULL
+};
+
+static int db_column_exists(const char *table, const char *column) {
+    const char *sql = "SELECT 1 FROM pragma_table_info(?) WHERE name = ?;";
+    sqlite3_stmt *stmt = db_stmt_acquire(sql);
+    int exists = 0;
+
+    if (stmt == NULL) {
+        return 0;
+    }
+
+    sqlite3_bind_text(stmt, 1, table, -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 2, column, -1, SQLITE_STATIC);
+    exists = sqlite3_step(stmt) == SQLITE_ROW;
+    db_stmt_release(stmt);
+    return exists;
+}
+
+static int db_exec_migration_sql(const char *sql) {
+    char *err = NULL;
+
+    if (sqlite3_exec(db, sql, NULL, NULL, &err) != SQLITE_OK) {
+        snprintf(db_error_msg, sizeof(db_error_msg), "%s", err ? err : sqlite3_errmsg(db));
+        sqlite3_free(err);
+        return 0;
+    }
+    return 1;
+}
+
+// 2: one employees/payroll schema. Databases created by the old
+// db_create_payroll_tables() used different employee column names, and the
+// payroll table from db_create_tables() had no gross_salary column.
+static int migration_2_unify_payroll(void) {
+    static const struct { const char *from; const char *to; } renames[] = {
+        { "employee_name",    "emp_name" },
+        { "birth_date",       "emp_dob" },
+        { "reporting_person", "reporting_person_name" },
+        { NULL, NULL }
     };
+    char sql[256];
 
-    for (int i = 0; sql_statements[i] != NULL; i++) {
-        rc = sqlite3_exec(db, sql_statements[i], NULL, NULL, &err);
-        
-        if (rc != SQLITE_OK) {
-            snprintf(db_error_msg, sizeof(db_error_msg),
-                    "SQL error on statement %d: %s", i, err);
-            fprintf(stderr, "[ERROR] %s\n", db_error_msg);
-            sqlite3_free(err);
+    for (int i = 0; renames[i].from != NULL; i++) {
+        if (db_column_exists("employees", renames[i].from) && !db_column_exists("employees", renames[i].to)) {
+            snprintf(sql, sizeof(sql), "ALTER TABLE employees RENAME COLUMN %s TO %s;",
+                     renames[i].from, renames[i].to);
+            if (!db_exec_migration_sql(sql)) return 0;
+        }
+    }
+
+    if (!db_column_exists("employees", "category") &&
+        !db_exec_migration_sql("ALTER TABLE employees ADD COLUMN category TEXT;")) {
+        return 0;
+    }
+    if (!db_column_exists("employees", "reporting_person_id") &&
+        !db_exec_migration_sql("ALTER TABLE employees ADD COLUMN reporting_person_id INTEGER;")) {
+        return 0;
+    }
+    if (!db_column_exists("payroll", "gross_salary") &&
+        !db_exec_migration_sql("ALTER TABLE payroll ADD COLUMN gross_salary REAL DEFAULT 0;")) {
+        return 0;
+    }
+    return 1;
+}
+
+// 3: FeeSummary is derived from Fees: each trigger applies the row's
+// amount as a delta to its fee_type column and to total_paid
+static const char *const migration_3_fee_summary_triggers[] = {
+        "CREATE TRIGGER IF NOT EXISTS fees_summary_ai AFTER INSERT ON Fees BEGIN "
+        "INSERT OR IGNORE INTO FeeSummary (student_id, roll_no) VALUES (new.student_id, new.roll_no); "
+        "UPDATE FeeSummary SET "
+        "institute_paid = institute_paid + CASE WHEN new.fee_type = 'Institute' THEN COALESCE(new.paid_amount, 0) ELSE 0 END, "
+        "hostel_paid = hostel_paid + CASE WHEN new.fee_type = 'Hostel' THEN COALESCE(new.paid_amount, 0) ELSE 0 END, "
+        "mess_paid = mess_paid + CASE WHEN new.fee_type = 'Mess' THEN COALESCE(new.paid_amount, 0) ELSE 0 END, "
+        "other_paid = other_paid + CASE WHEN new.fee_type = 'Other' THEN COALESCE(new.paid_amount, 0) ELSE 0 END, "
+        "total_paid = total_paid + COALESCE(new.paid_amount, 0), "
+        "updated_at = CURRENT_TIMESTAMP "
+        "WHERE student_id = new.student_id; END;",
+
+        "CREATE TRIGGER IF NOT EXISTS fees_summary_ad AFTER DELETE ON Fees BEGIN "
+        "UPDATE FeeSummary SET "
+        "institute_paid = institute_paid - CASE WHEN old.fee_type = 'Institute' THEN COALESCE(old.paid_amount, 0) ELSE 0 END, "
+        "hostel_paid = hostel_paid - CASE WHEN old.fee_type = 'Hostel' THEN COALESCE(old.paid_amount, 0) ELSE 0 END, "
+        "mess_paid = mess_paid - CASE WHEN old.fee_type = 'Mess' THEN COALESCE(old.paid_amount, 0) ELSE 0 END, "
+        "other_paid = other_paid - CASE WHEN old.fee_type = 'Other' THEN COALESCE(old.paid_amount, 0) ELSE 0 END, "
+        "total_paid = total_paid - COALESCE(old.paid_amount, 0), "
+        "updated_at = CURRENT_TIMESTAMP "
+        "WHERE student_id = old.student_id; END;",
+
+        "CREATE TRIGGER IF NOT EXISTS fees_summary_au AFTER UPDATE OF student_id, fee_type, paid_amount ON Fees BEGIN "
+        "UPDATE FeeSummary SET "
+        "institute_paid = institute_paid - CASE WHEN old.fee_type = 'Institute' THEN COALESCE(old.paid_amount, 0) ELSE 0 END, "
+        "hostel_paid = hostel_paid - CASE WHEN old.fee_type = 'Hostel' THEN COALESCE(old.paid_amount, 0) ELSE 0 END, "
+        "mess_paid = mess_paid - CASE WHEN old.fee_type = 'Mess' THEN COALESCE(old.paid_amount, 0) ELSE 0 END, "
+        "other_paid = other_paid - CASE WHEN old.fee_type = 'Other' THEN COALESCE(old.paid_amount, 0) ELSE 0 END, "
+        "total_paid = total_paid - COALESCE(old.paid_amount, 0), "
+        "updated_at = CURRENT_TIMESTAMP "
+        "WHERE student_id = old.student_id; "
+        "INSERT OR IGNORE INTO FeeSummary (student_id, roll_no) VALUES (new.student_id, new.roll_no); "
+        "UPDATE FeeSummary SET "
+        "institute_paid = institute_paid + CASE WHEN new.fee_type = 'Institute' THEN COALESCE(new.paid_amount, 0) ELSE 0 END, "
+        "hostel_paid = hostel_paid + CASE WHEN new.fee_type = 'Hostel' THEN COALESCE(new.paid_amount, 0) ELSE 0 END, "
+        "mess_paid = mess_paid + CASE WHEN new.fee_type = 'Mess' THEN COALESCE(new.paid_amount, 0) ELSE 0 END, "
+        "other_paid = other_paid + CASE WHEN new.fee_type = 'Other' THEN COALESCE(new.paid_amount, 0) ELSE 0 END, "
+        "total_paid = total_paid + COALESCE(new.paid_amount, 0), "
+        "updated_at = CURRENT_TIMESTAMP "
+        "WHERE student_id = new.student_id; END;",
+        NULL
+};
+
+// Summaries written before the triggers existed may not match the ledger
+static int migration_3_rebuild_summary(void) {
+    return db_rebuild_fee_summary(NULL);
+}
+
+// 4: indexes designed from the queries in src/database
+//  - Fees(student_id, fee_type, paid_amount) covers the summary rebuild's
+//    GROUP BY and its NOT IN sweep; it supersedes idx_fees_student_id
+//  - FeeSummary(student_id) duplicated the UNIQUE constraint's index
+//  - Students(branch, roll_no, ...) covers db_get_students_by_branch,
+//    including its ORDER BY
+//  - payroll(month_year, emp_id) for per-month payroll lookups
+static const char *const migration_4_query_indexes[] = {
+    "DROP INDEX IF EXISTS idx_fees_student_id;",
+    "DROP INDEX IF EXISTS idx_fee_summary_student_id;",
+    "CREATE INDEX IF NOT EXISTS idx_fees_student_type_amount ON Fees(student_id, fee_type, paid_amount);",
+    "CREATE INDEX IF NOT EXISTS idx_students_branch_roll ON Students(branch, roll_no, name, gender, year, semester);",
+    "CREATE INDEX IF NOT EXISTS idx_payroll_month_year ON payroll(month_year, emp_id);",
+    NULL
+};
+
+// 5: amounts in integer paise (see money.h). SQLite cannot change a column's
+// type, so each table is rebuilt from its own CREATE statement with the
+// amount columns declared INTEGER, and the amounts copied as ROUND(x * 100).
+// Rebuilding from the stored statement keeps any column an older schema
+// added. Indexes and triggers are dropped with the old tables and recreated
+// from their saved SQL once every table has been rebuilt.
+static const char *const payroll_money_columns[] = {
+    "basic_salary", "house_rent", "medical", "conveyance", "dearness_allowance",
+    "performance_bonus", "other_allowances", "total_allowances", "income_tax",
+    "provident_fund", "health_insurance", "loan_deduction", "other_deductions",
+    "total_deductions", "gross_salary", "net_salary", NULL
+};
+static const char *const fees_money_columns[] = { "paid_amount", NULL };
+static const char *const fee_summary_money_columns[] = {
+    "institute_paid", "hostel_paid", "mess_paid", "other_paid", "total_paid", NULL
+};
+static const char *const payment_history_money_columns[] = { "amount", NULL };
+static const char *const employees_money_columns[] = { "base_salary", NULL };
+
+static const struct {
+    const char *table;
+    const char *const *columns;
+} money_tables[] = {
+    { "Fees",              fees_money_columns },
+    { "FeeSummary",        fee_summary_money_columns },
+    { "FeePaymentHistory", payment_history_money_columns },
+    { "employees",         employees_money_columns },
+    { "payroll",           payroll_money_columns },
+    { "salary_slips",      payroll_money_columns },
+    { NULL, NULL }
+};
+
+static int db_is_money_column(const char *const *columns, const char *name) {
+    for (int i = 0; columns[i] != NULL; i++) {
+        if (sqlite3_stricmp(columns[i], name) == 0) return 1;
+    }
+    return 0;
+}
+
+// Returns where "REAL" starts in the definition of column within a CREATE
+// TABLE statement, or NULL if the column is not declared REAL
+static char* db_find_real_column(char *ddl, const char *column) {
+    size_t len = strlen(column);
+
+    for (char *p = strstr(ddl, column); p != NULL; p = strstr(p + 1, column)) {
+        char before = p == ddl ? ' ' : p[-1];
+        char *type = p + len;
+
+        if (before != '(' && before != ',' && before != '"' && before != '`' && before != '[' &&
+            !isspace((unsigned char)before)) {
+            continue;
+        }
+        if (*type == '"' || *type == '`' || *type == ']') type++;
+        if (!isspace((unsigned char)*type)) continue;
+        while (isspace((unsigned char)*type)) type++;
+
+        if (sqlite3_strnicmp(type, "REAL", 4) == 0 && !isalnum((unsigned char)type[4]) && type[4] != '_') {
+            return type;
+        }
+    }
+    return NULL;
+}
+
+static int db_rebuild_money_table(const char *table, const char *const *columns) {
+    sqlite3_stmt *stmt = db_stmt_acquire_scan("SELECT sql FROM sqlite_master WHERE type = 'table' AND name = ?;");
+    char *ddl = NULL;
+
+    if (stmt == NULL) {
+        return 0;
+    }
+    sqlite3_bind_text(stmt, 1, table, -1, SQLITE_STATIC);
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        const char *create = (const char *)sqlite3_column_text(stmt, 0);
+        const char *body = create ? strchr(create, '(') : NULL;
+        if (body != NULL) {
+            ddl = sqlite3_mprintf("CREATE TABLE \"%w_paise\" %s", table, body);
+        }
+    }
+    db_stmt_release(stmt);
+
+    if (ddl == NULL) {
+        snprintf(db_error_msg, sizeof(db_error_msg), "No CREATE statement for table %s", table);
+        return 0;
+    }
+
+    for (int i = 0; columns[i] != NULL; i++) {
+        char *type = db_find_real_column(ddl, columns[i]);
+        if (type != NULL) {
+            char *retyped = sqlite3_mprintf("%.*sINTEGER%s", (int)(type - ddl), ddl, type + 4);
+            sqlite3_free(ddl);
+            ddl = retyped;
+            if (ddl == NULL) {
+                snprintf(db_error_msg, sizeof(db_error_msg), "Out of memory rebuilding %s", table);
+                return 0;
+            }
+        }
+    }
+
+    // Column list, with the amounts converted on the way across
+    sqlite3_str *names = sqlite3_str_new(db);
+    sqlite3_str *values = sqlite3_str_new(db);
+
+    stmt = db_stmt_acquire("SELECT name FROM pragma_table_info(?);");
+    if (stmt != NULL) {
+        sqlite3_bind_text(stmt, 1, table, -1, SQLITE_STATIC);
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            const char *name = (const char *)sqlite3_column_text(stmt, 0);
+            const char *sep = sqlite3_str_length(names) > 0 ? ", " : "";
+
+            sqlite3_str_appendf(names, "%s\"%w\"", sep, name);
+            if (db_is_money_column(columns, name)) {
+                sqlite3_str_appendf(values, "%sCAST(ROUND(\"%w\" * 100) AS INTEGER)", sep, name);
+            } else {
+                sqlite3_str_appendf(values, "%s\"%w\"", sep, name);
+            }
+        }
+        db_stmt_release(stmt);
+    }
+
+    // AUTOINCREMENT must not hand out ids of rows deleted before the rebuild
+    sqlite3_int64 seq = 0;
+    stmt = db_stmt_acquire_scan("SELECT seq FROM sqlite_sequence WHERE name = ?;");
+    if (stmt != NULL) {
+        sqlite3_bind_text(stmt, 1, table, -1, SQLITE_STATIC);
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            seq = sqlite3_column_int64(stmt, 0);
+        }
+        db_stmt_release(stmt);
+    }
+
+    char *column_names = sqlite3_str_finish(names);
+    char *column_values = sqlite3_str_finish(values);
+    char *copy = sqlite3_mprintf(
+        "INSERT INTO \"%w_paise\" (%s) SELECT %s FROM \"%w\"; "
+        "DROP TABLE \"%w\"; "
+        "ALTER TABLE \"%w_paise\" RENAME TO \"%w\"; "
+        "UPDATE sqlite_sequence SET seq = MAX(seq, %lld) WHERE name = '%q'; "
+        "INSERT INTO sqlite_sequence (name, seq) SELECT '%q', %lld "
+        "WHERE %lld > 0 AND NOT EXISTS (SELECT 1 FROM sqlite_sequence WHERE name = '%q');",
+        table, column_names, column_values, table,
+        table,
+        table, table,
+        seq, table,
+        table, seq, seq, table);
+
+    int ok = column_names != NULL && column_values != NULL && copy != NULL;
+    if (!ok) {
+        snprintf(db_error_msg, sizeof(db_error_msg), "Out of memory rebuilding %s", table);
+    }
+    ok = ok && db_exec_migration_sql(ddl) && db_exec_migration_sql(copy);
+
+    sqlite3_free(ddl);
+    sqlite3_free(column_names);
+    sqlite3_free(column_values);
+    sqlite3_free(copy);
+    return ok;
+}
+
+static int migration_5_money_paise(void) {
+    char **saved = NULL;        // CREATE statements of indexes and triggers
+    char **drops = NULL;        // DROP TRIGGER statements
+    int n_saved = 0, n_drops = 0, capacity = 0;
+    int ok = 1;
+
+    sqlite3_stmt *stmt = db_stmt_acquire_scan(
+        "SELECT type, name, sql FROM sqlite_master "
+        "WHERE tbl_name = ? AND type IN ('index', 'trigger') AND sql IS NOT NULL;");
+    if (stmt == NULL) {
+        return 0;
+    }
+
+    for (int t = 0; ok && money_tables[t].table != NULL; t++) {
+        sqlite3_bind_text(stmt, 1, money_tables[t].table, -1, SQLITE_STATIC);
+        while (ok && sqlite3_step(stmt) == SQLITE_ROW) {
+            if (n_saved == capacity) {
+                int grown = capacity ? capacity * 2 : 16;
+                char **more_saved = sqlite3_realloc64(saved, grown * sizeof(char *));
+                if (more_saved != NULL) {
+                    saved = more_saved;
+                }
+                char **more_drops = sqlite3_realloc64(drops, grown * sizeof(char *));
+                if (more_drops != NULL) {
+                    drops = more_drops;
+                }
+                if (more_saved == NULL || more_drops == NULL) {
+                    ok = 0;
+                    break;
+                }
+                capacity = grown;
+            }
+
+            char *create = sqlite3_mprintf("%s", (const char *)sqlite3_column_text(stmt, 2));
+            if (create == NULL) {
+                ok = 0;
+                break;
+            }
+            saved[n_saved++] = create;
+
+            if (strcmp((const char *)sqlite3_column_text(stmt, 0), "trigger") == 0) {
+                char *drop = sqlite3_mprintf("DROP TRIGGER \"%w\";", (const char *)sqlite3_column_text(stmt, 1));
+                if (drop == NULL) {
+                    ok = 0;
+                    break;
+                }
+                drops[n_drops++] = drop;
+            }
+        }
+        sqlite3_reset(stmt);
+    }
+    db_stmt_release(stmt);
+
+    // db_migrate() rolls the whole migration back when this fails
+    if (!ok) {
+        snprintf(db_error_msg, sizeof(db_error_msg), "Out of memory saving indexes and triggers");
+    }
+
+    // A trigger that names a dropped table makes the replacement's RENAME
+    // fail (fees_summary_* on Fees update FeeSummary), so all go up front
+    for (int i = 0; ok && i < n_drops; i++) {
+        ok = db_exec_migration_sql(drops[i]);
+    }
+    for (int t = 0; ok && money_tables[t].table != NULL; t++) {
+        ok = db_rebuild_money_table(money_tables[t].table, money_tables[t].columns);
+    }
+    for (int i = 0; ok && i < n_saved; i++) {
+        ok = db_exec_migration_sql(saved[i]);
+    }
+
+    for (int i = 0; i < n_saved; i++) sqlite3_free(saved[i]);
+    for (int i = 0; i < n_drops; i++) sqlite3_free(drops[i]);
+    sqlite3_free(saved);
+    sqlite3_free(drops);
+
+    // Each ledger row rounded on its own; make the summaries agree with them
+    return ok && db_rebuild_fee_summary(NULL);
+}
+
+// 6: each payroll row keeps the department the employee was in when it was
+// written, so later transfers do not move past months between departments
+static int migration_6_payroll_department(void) {
+    if (!db_column_exists("payroll", "department") &&
+        !db_exec_migration_sql("ALTER TABLE payroll ADD COLUMN department TEXT;")) {
+        return 0;
+    }
+    return db_exec_migration_sql(
+        "UPDATE payroll SET department = "
+        "(SELECT department FROM employees WHERE employees.emp_id = payroll.emp_id) "
+        "WHERE department IS NULL;");
+}
+
+// 7: PayrollSummary rolls payroll up by (month_year, department). Like
+// FeeSummary, the triggers apply each row as a delta: headcount and totals
+// on insert/delete, old row out and new row in on update (mark paid too).
+#define PAYROLL_SUMMARY_APPLY(sign, row) \
+        "INSERT OR IGNORE INTO PayrollSummary (month_year, department) " \
+        "VALUES (" row ".month_year, COALESCE(" row ".department, '')); " \
+        "UPDATE PayrollSummary SET " \
+        "headcount = headcount " sign " 1, " \
+        "paid_count = paid_count " sign " (" row ".status = 'Paid'), " \
+        "total_gross = total_gross " sign " COALESCE(" row ".gross_salary, 0), " \
+        "total_deductions = total_deductions " sign " COALESCE(" row ".total_deductions, 0), " \
+        "total_net = total_net " sign " COALESCE(" row ".net_salary, 0), " \
+        "paid_net = paid_net " sign " CASE WHEN " row ".status = 'Paid' THEN COALESCE(" row ".net_salary, 0) ELSE 0 END, " \
+        "updated_at = CURRENT_TIMESTAMP " \
+        "WHERE month_year = " row ".month_year AND department = COALESCE(" row ".department, ''); "
+
+static const char *const migration_7_payroll_summary[] = {
+        "CREATE TABLE IF NOT EXISTS PayrollSummary (month_year TEXT NOT NULL, department TEXT NOT NULL, headcount INTEGER NOT NULL DEFAULT 0, paid_count INTEGER NOT NULL DEFAULT 0, total_gross INTEGER NOT NULL DEFAULT 0, total_deductions INTEGER NOT NULL DEFAULT 0, total_net INTEGER NOT NULL DEFAULT 0, paid_net INTEGER NOT NULL DEFAULT 0, updated_at DATETIME DEFAULT CURRENT_TIMESTAMP, PRIMARY KEY (month_year, department)) WITHOUT ROWID;",
+
+        "CREATE TRIGGER IF NOT EXISTS payroll_summary_ai AFTER INSERT ON payroll BEGIN "
+        PAYROLL_SUMMARY_APPLY("+", "new")
+        "END;",
+
+        "CREATE TRIGGER IF NOT EXISTS payroll_summary_ad AFTER DELETE ON payroll BEGIN "
+        PAYROLL_SUMMARY_APPLY("-", "old")
+        "END;",
+
+        "CREATE TRIGGER IF NOT EXISTS payroll_summary_au AFTER UPDATE OF emp_id, month_year, department, "
+        "gross_salary, total_deductions, net_salary, status ON payroll BEGIN "
+        PAYROLL_SUMMARY_APPLY("-", "old")
+        PAYROLL_SUMMARY_APPLY("+", "new")
+        "END;",
+        NULL
+};
+
+static int migration_7_fill_payroll_summary(void) {
+    return db_rebuild_payroll_summary();
+}
+
+// Thumbnail ahead of the photo: a row's columns are stored in order, so a
+// thumbnail read stays on the row's first page and never walks the photo's
+// overflow chain. No foreign keys are enforced, hence the delete trigger.
+static const char *const migration_8_student_photos[] = {
+        "CREATE TABLE IF NOT EXISTS StudentPhotos (student_id INTEGER PRIMARY KEY, thumbnail BLOB NOT NULL, photo BLOB NOT NULL, updated_at DATETIME DEFAULT CURRENT_TIMESTAMP);",
+
+        "CREATE TRIGGER IF NOT EXISTS student_photos_ad AFTER DELETE ON Students BEGIN "
+        "DELETE FROM StudentPhotos WHERE student_id = old.student_id; END;",
+        NULL
+};
+
+// 9: DashboardStats holds the dashboard's counters, one row per stat, kept
+// by triggers as deltas so reading them never scans a table. A fee row is
+// pending until it is Paid or Cancelled; its paid_amount is what is owed.
+// The month's payroll is already rolled up in PayrollSummary.
+#define FEE_PENDING(row) "(COALESCE(" row ".status, '') NOT IN ('Paid', 'Cancelled'))"
+
+static const char *const migration_9_dashboard_stats[] = {
+        "CREATE TABLE IF NOT EXISTS DashboardStats (stat TEXT PRIMARY KEY, value INTEGER NOT NULL DEFAULT 0, updated_at DATETIME DEFAULT CURRENT_TIMESTAMP) WITHOUT ROWID;",
+
+        "CREATE TRIGGER IF NOT EXISTS students_stats_ai AFTER INSERT ON Students BEGIN "
+        "UPDATE DashboardStats SET value = value + 1, updated_at = CURRENT_TIMESTAMP WHERE stat = 'students'; END;",
+
+        "CREATE TRIGGER IF NOT EXISTS students_stats_ad AFTER DELETE ON Students BEGIN "
+        "UPDATE DashboardStats SET value = value - 1, updated_at = CURRENT_TIMESTAMP WHERE stat = 'students'; END;",
+
+        "CREATE TRIGGER IF NOT EXISTS employees_stats_ai AFTER INSERT ON employees BEGIN "
+        "UPDATE DashboardStats SET value = value + 1, updated_at = CURRENT_TIMESTAMP WHERE stat = 'employees'; END;",
+
+        "CREATE TRIGGER IF NOT EXISTS employees_stats_ad AFTER DELETE ON employees BEGIN "
+        "UPDATE DashboardStats SET value = value - 1, updated_at = CURRENT_TIMESTAMP WHERE stat = 'employees'; END;",
+
+        "CREATE TRIGGER IF NOT EXISTS fees_stats_ai AFTER INSERT ON Fees WHEN " FEE_PENDING("new") " BEGIN "
+        "UPDATE DashboardStats SET value = value + 1, updated_at = CURRENT_TIMESTAMP WHERE stat = 'pending_fee_count'; "
+        "UPDATE DashboardStats SET value = value + COALESCE(new.paid_amount, 0), updated_at = CURRENT_TIMESTAMP WHERE stat = 'pending_fee_amount'; END;",
+
+        "CREATE TRIGGER IF NOT EXISTS fees_stats_ad AFTER DELETE ON Fees WHEN " FEE_PENDING("old") " BEGIN "
+        "UPDATE DashboardStats SET value = value - 1, updated_at = CURRENT_TIMESTAMP WHERE stat = 'pending_fee_count'; "
+        "UPDATE DashboardStats SET value = value - COALESCE(old.paid_amount, 0), updated_at = CURRENT_TIMESTAMP WHERE stat = 'pending_fee_amount'; END;",
+
+        "CREATE TRIGGER IF NOT EXISTS fees_stats_au AFTER UPDATE OF status, paid_amount ON Fees BEGIN "
+        "UPDATE DashboardStats SET value = value - " FEE_PENDING("old") " + " FEE_PENDING("new") ", "
+        "updated_at = CURRENT_TIMESTAMP WHERE stat = 'pending_fee_count'; "
+        "UPDATE DashboardStats SET value = value "
+        "- CASE WHEN " FEE_PENDING("old") " THEN COALESCE(old.paid_amount, 0) ELSE 0 END "
+        "+ CASE WHEN " FEE_PENDING("new") " THEN COALESCE(new.paid_amount, 0) ELSE 0 END, "
+        "updated_at = CURRENT_TIMESTAMP WHERE stat = 'pending_fee_amount'; END;",
+        NULL
+};
+
+static int migration_9_fill_dashboard_stats(void) {
+    return db_rebuild_dashboard_stats();
+}
+
+// 10: Fees only records payments, so nothing is ever pending; the fee
+// counters of migration 9 are dropped along with their triggers
+static const char *const migration_10_drop_fee_stats[] = {
+        "DROP TRIGGER IF EXISTS fees_stats_ai;",
+        "DROP TRIGGER IF EXISTS fees_stats_ad;",
+        "DROP TRIGGER IF EXISTS fees_stats_au;",
+        "DELETE FROM DashboardStats WHERE stat IN ('pending_fee_count', 'pending_fee_amount');",
+        NULL
+};
+
+static const DbMigration migrations[] = {
+    { 1, "base schema",                      migration_1_base,                 NULL },
+    { 2, "unify employees and payroll",      NULL,                             migration_2_unify_payroll },
+    { 3, "fee summary triggers",             migration_3_fee_summary_triggers, migration_3_rebuild_summary },
+    { 4, "query indexes",                    migration_4_query_indexes,        NULL },
+    { 5, "amounts in integer paise",         NULL,                             migration_5_money_paise },
+    { 6, "payroll department snapshot",      NULL,                             migration_6_payroll_department },
+    { 7, "payroll summary rollup",           migration_7_payroll_summary,      migration_7_fill_payroll_summary },
+    { 8, "student photos",                   migration_8_student_photos,       NULL },
+    { 9, "dashboard stats",                  migration_9_dashboard_stats,      migration_9_fill_dashboard_stats },
+    { 10, "drop pending fee stats",          migration_10_drop_fee_stats,      NULL },
+};
+
+#define DB_SCHEMA_VERSION ((int)(sizeof(migrations) / sizeof(migrations[0])))
+
+int db_get_schema_version(void) {
+    DB_LATENCY_SCOPE();
+
+    sqlite3_stmt *stmt = db_stmt_acquire("PRAGMA user_version;");
+    int version = -1;
+
+    if (stmt == NULL) {
+        return -1;
+    }
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        version = sqlite3_column_int(stmt, 0);
+    }
+    db_stmt_release(stmt);
+    return version;
+}
+
+int db_migrate(void) {
+    DB_LATENCY_SCOPE();
+
+    if (db == NULL) {
+        LOG_ERROR("Database not initialized");
+        return 0;
+    }
+
+    int current = db_get_schema_version();
+    if (current < 0) {
+        snprintf(db_error_msg, sizeof(db_error_msg),
+                "Failed to read schema version: %s", sqlite3_errmsg(db));
+        LOG_ERROR("%s", db_error_msg);
+        return 0;
+    }
+
+    if (current > DB_SCHEMA_VERSION) {
+        snprintf(db_error_msg, sizeof(db_error_msg),
+                "Database schema version %d is newer than this build (%d)", current, DB_SCHEMA_VERSION);
+        LOG_ERROR("%s", db_error_msg);
+        return 0;
+    }
+
+    if (current == DB_SCHEMA_VERSION) {
+        LOG_INFO("Database schema up to date (version %d)", current);
+        return 1;
+    }
+
+    if (!db_begin_transaction()) {
+        return 0;
+    }
+
+    for (int m = current; m < DB_SCHEMA_VERSION; m++) {
+        const DbMigration *migration = &migrations[m];
+
+        int ok = 1;
+
+        for (int i = 0; ok && migration->statements != NULL && migration->statements[i] != NULL; i++) {
+            ok = db_exec_migration_sql(migration->statements[i]);
+        }
+        if (ok && migration->apply != NULL) {
+            ok = migration->apply();
+        }
+
+        if (!ok) {
+            LOG_ERROR("Migration %d (%s) failed: %s",
+                      migration->version, migration->description, db_error_msg);
+            db_rollback_transaction();
             return 0;
         }
+        LOG_INFO("Applied migration %d: %s", migration->version, migration->description);
+    }
+
+    char sql[64];
+    snprintf(sql, sizeof(sql), "PRAGMA user_version = %d;", DB_SCHEMA_VERSION);
+    if (!db_exec_migration_sql(sql)) {
+        LOG_ERROR("Failed to record schema version: %s", db_error_msg);
+        db_rollback_transaction();
+        return 0;
+    }
+
+    if (!db_commit_transaction()) {
+        return 0;
+    }
+
+    LOG_SUCCESS("Database schema migrated from version %d to %d", current, DB_SCHEMA_VERSION);
+    return 1;
+}
+
+int db_create_tables() {
+    DB_LATENCY_SCOPE();
+
+    if (!db_migrate()) {
+        return 0;
     }
 
-    printf("[INFO] All database tables created successfully\n");
+    // Search index is optional: without FTS5 the search functions fall back to LIKE
+    db_create_search_index();
     return 1;
 }
 
 void db_close() {
     if (db != NULL) {
+#ifdef DEBUG
+        db_check_query_plans();
+#endif
+        db_stmt_print_stats();
+        db_stmt_clear_cache();
         sqlite3_close(db);
-        printf("[INFO] Database connection closed\n");
+        LOG_INFO("Database connection closed");
         db = NULL;
     }
 }
\ No newline at end of file
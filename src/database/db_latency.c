@@ -0,0 +1,368 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include "../../include/db_latency.h"
+#include "../../include/logger.h"
+
+typedef struct {
+    uint64_t hash;
+    char *sql;
+    DbLatencyHistogram hist;
+} DbLatencyStatement;
+
+static atomic_int latency_on = 1;
+
+// Function sites push themselves here the first time they finish
+static _Atomic(DbLatencySite *) function_sites = NULL;
+
+// Open-addressed by SQL hash; a slot is claimed once and never freed
+static _Atomic(DbLatencyStatement *) statements[DB_LATENCY_MAX_SQL];
+static atomic_ulong statements_untracked = 0;
+
+
+// ============================================================================
+// HISTOGRAM
+// Values below 16 ns get a bucket each; above that, each power of two is
+// split into 16 equal sub-buckets.
+// ============================================================================
+
+static int db_latency_bucket(uint64_t ns) {
+    if (ns < DB_LATENCY_SUB_BUCKETS) {
+        return (int)ns;
+    }
+    int exponent = 63 - __builtin_clzll(ns);
+    int shift = exponent - DB_LATENCY_SUB_BITS;
+    int bucket = (shift + 1) * DB_LATENCY_SUB_BUCKETS + (int)((ns >> shift) & (DB_LATENCY_SUB_BUCKETS - 1));
+    return bucket < DB_LATENCY_BUCKETS ? bucket : DB_LATENCY_BUCKETS - 1;
+}
+
+// Largest value that lands in bucket
+static uint64_t db_latency_bucket_top(int bucket) {
+    if (bucket < 2 * DB_LATENCY_SUB_BUCKETS) {
+        return (uint64_t)bucket;
+    }
+    int shift = bucket / DB_LATENCY_SUB_BUCKETS - 1;
+    uint64_t sub = (uint64_t)(bucket % DB_LATENCY_SUB_BUCKETS);
+    return ((DB_LATENCY_SUB_BUCKETS + sub + 1) << shift) - 1;
+}
+
+static void db_latency_record(DbLatencyHistogram *hist, uint64_t ns) {
+    atomic_fetch_add_explicit(&hist->buckets[db_latency_bucket(ns)], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&hist->count, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&hist->total_ns, ns, memory_order_relaxed);
+
+    uint64_t max = atomic_load_explicit(&hist->max_ns, memory_order_relaxed);
+    while (ns > max &&
+           !atomic_compare_exchange_weak_explicit(&hist->max_ns, &max, ns,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+static void db_latency_clear(DbLatencyHistogram *hist) {
+    for (int i = 0; i < DB_LATENCY_BUCKETS; i++) {
+        atomic_store_explicit(&hist->buckets[i], 0, memory_order_relaxed);
+    }
+    atomic_store_explicit(&hist->count, 0, memory_order_relaxed);
+    atomic_store_explicit(&hist->total_ns, 0, memory_order_relaxed);
+    atomic_store_explicit(&hist->max_ns, 0, memory_order_relaxed);
+}
+
+// Percentiles come from a copy of the buckets, so a sample arriving
+// mid-read cannot push a rank past the end
+static void db_latency_summarize(const DbLatencyHistogram *hist, DbLatencyStats *out) {
+    static const int permille[2] = { 500, 990 };
+    uint64_t *targets[2] = { &out->p50_ns, &out->p99_ns };
+    unsigned int counts[DB_LATENCY_BUCKETS];
+    uint64_t samples = 0;
+
+    for (int i = 0; i < DB_LATENCY_BUCKETS; i++) {
+        counts[i] = atomic_load_explicit(&hist->buckets[i], memory_order_relaxed);
+        samples += counts[i];
+    }
+
+    out->count = samples;
+    out->max_ns = atomic_load_explicit(&hist->max_ns, memory_order_relaxed);
+    out->mean_ns = samples > 0 ? atomic_load_explicit(&hist->total_ns, memory_order_relaxed) / samples : 0;
+    out->p50_ns = 0;
+    out->p99_ns = 0;
+
+    for (int p = 0; p < 2 && samples > 0; p++) {
+        uint64_t rank = (samples * permille[p] + 999) / 1000;
+        uint64_t seen = 0;
+        for (int i = 0; i < DB_LATENCY_BUCKETS; i++) {
+            seen += counts[i];
+            if (seen >= rank) {
+                uint64_t top = db_latency_bucket_top(i);
+                *targets[p] = top < out->max_ns ? top : out->max_ns;
+                break;
+            }
+        }
+    }
+}
+
+
+// ============================================================================
+// FUNCTION TIMING
+// ============================================================================
+
+int64_t db_latency_now(void) {
+    if (!atomic_load_explicit(&latency_on, memory_order_relaxed)) {
+        return 0;
+    }
+    return db_latency_clock_ns();
+}
+
+int64_t db_latency_clock_ns(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER now;
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    QueryPerformanceCounter(&now);
+    return (now.QuadPart / frequency.QuadPart) * 1000000000 +
+           (now.QuadPart % frequency.QuadPart) * 1000000000 / frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+#endif
+}
+
+void db_latency_scope_end(DbLatencyScope *scope) {
+    if (scope->start_ns == 0) {
+        return;
+    }
+
+    DbLatencySite *site = scope->site;
+    int64_t elapsed = db_latency_now() - scope->start_ns;
+    if (elapsed < 0) {
+        return;     // timing was switched off mid-call
+    }
+
+    int expected = 0;
+    if (atomic_compare_exchange_strong(&site->registered, &expected, 1)) {
+        DbLatencySite *head = atomic_load(&function_sites);
+        do {
+            site->next = head;
+        } while (!atomic_compare_exchange_weak(&function_sites, &head, site));
+    }
+
+    db_latency_record(&site->hist, (uint64_t)elapsed);
+}
+
+void db_latency_set_enabled(int enabled) {
+    atomic_store(&latency_on, enabled ? 1 : 0);
+}
+
+int db_latency_enabled(void) {
+    return atomic_load(&latency_on);
+}
+
+
+// ============================================================================
+// STATEMENT TIMING
+// ============================================================================
+
+static uint64_t db_latency_hash(const char *sql) {
+    uint64_t hash = 14695981039346656037ULL;    // FNV-1a
+    for (const unsigned char *c = (const unsigned char *)sql; *c != '\0'; c++) {
+        hash = (hash ^ *c) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+static DbLatencyStatement* db_latency_statement(const char *sql) {
+    uint64_t hash = db_latency_hash(sql);
+
+    for (int probe = 0; probe < DB_LATENCY_MAX_SQL; probe++) {
+        _Atomic(DbLatencyStatement *) *slot = &statements[(hash + probe) & (DB_LATENCY_MAX_SQL - 1)];
+        DbLatencyStatement *entry = atomic_load_explicit(slot, memory_order_acquire);
+
+        if (entry == NULL) {
+            DbLatencyStatement *fresh = calloc(1, sizeof(DbLatencyStatement));
+            char *copy = fresh != NULL ? malloc(strlen(sql) + 1) : NULL;
+            if (copy == NULL) {
+                free(fresh);
+                return NULL;
+            }
+            strcpy(copy, sql);
+            fresh->hash = hash;
+            fresh->sql = copy;
+
+            if (atomic_compare_exchange_strong_explicit(slot, &entry, fresh,
+                                                        memory_order_acq_rel, memory_order_acquire)) {
+                return fresh;
+            }
+            // Another thread took the slot first; entry is now theirs
+            free(copy);
+            free(fresh);
+        }
+
+        if (entry->hash == hash && strcmp(entry->sql, sql) == 0) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static int db_latency_trace(unsigned type, void *ctx, void *p, void *x) {
+    (void)ctx;
+
+    if (type != SQLITE_TRACE_PROFILE || !atomic_load_explicit(&latency_on, memory_order_relaxed)) {
+        return 0;
+    }
+
+    const char *sql = sqlite3_sql((sqlite3_stmt *)p);
+    DbLatencyStatement *entry = sql != NULL ? db_latency_statement(sql) : NULL;
+    if (entry == NULL) {
+        atomic_fetch_add_explicit(&statements_untracked, 1, memory_order_relaxed);
+        return 0;
+    }
+
+    sqlite3_int64 ns = *(sqlite3_int64 *)x;
+    db_latency_record(&entry->hist, ns > 0 ? (uint64_t)ns : 0);
+    return 0;
+}
+
+void db_latency_attach(sqlite3 *conn) {
+    if (conn != NULL) {
+        sqlite3_trace_v2(conn, SQLITE_TRACE_PROFILE, db_latency_trace, NULL);
+    }
+}
+
+
+// ============================================================================
+// REPORTING
+// ============================================================================
+
+int db_latency_snapshot(DbLatencyStats *out, int max) {
+    int n = 0;
+
+    for (DbLatencySite *site = atomic_load(&function_sites); site != NULL && n < max; site = site->next) {
+        db_latency_summarize(&site->hist, &out[n]);
+        if (out[n].count > 0) {
+            out[n].kind = DB_LATENCY_FUNCTION;
+            out[n].name = site->name;
+            n++;
+        }
+    }
+
+    for (int i = 0; i < DB_LATENCY_MAX_SQL && n < max; i++) {
+        DbLatencyStatement *entry = atomic_load_explicit(&statements[i], memory_order_acquire);
+        if (entry == NULL) {
+            continue;
+        }
+        db_latency_summarize(&entry->hist, &out[n]);
+        if (out[n].count > 0) {
+            out[n].kind = DB_LATENCY_STATEMENT;
+            out[n].name = entry->sql;
+            n++;
+        }
+    }
+    return n;
+}
+
+void db_latency_reset(void) {
+    for (DbLatencySite *site = atomic_load(&function_sites); site != NULL; site = site->next) {
+        db_latency_clear(&site->hist);
+    }
+    for (int i = 0; i < DB_LATENCY_MAX_SQL; i++) {
+        DbLatencyStatement *entry = atomic_load_explicit(&statements[i], memory_order_acquire);
+        if (entry != NULL) {
+            db_latency_clear(&entry->hist);
+        }
+    }
+    atomic_store(&statements_untracked, 0);
+}
+
+static void db_latency_json_string(FILE *out, const char *text) {
+    fputc('"', out);
+    for (const unsigned char *c = (const unsigned char *)text; *c != '\0'; c++) {
+        switch (*c) {
+            case '"':  fputs("\\\"", out); break;
+            case '\\': fputs("\\\\", out); break;
+            case '\n': fputs("\\n", out); break;
+            case '\t': fputs("\\t", out); break;
+            default:
+                if (*c < 0x20) {
+                    fprintf(out, "\\u%04x", *c);
+                } else {
+                    fputc(*c, out);
+                }
+        }
+    }
+    fputc('"', out);
+}
+
+static void db_latency_json_list(FILE *out, const char *key, const char *name_key,
+                                 DbLatencyKind kind, const DbLatencyStats *stats, int n) {
+    int first = 1;
+
+    fprintf(out, "  \"%s\": [", key);
+    for (int i = 0; i < n; i++) {
+        if (stats[i].kind != kind) {
+            continue;
+        }
+        fprintf(out, "%s\n    {\"%s\": ", first ? "" : ",", name_key);
+        db_latency_json_string(out, stats[i].name);
+        fprintf(out, ", \"count\": %llu, \"mean\": %llu, \"p50\": %llu, \"p99\": %llu, \"max\": %llu}",
+                (unsigned long long)stats[i].count, (unsigned long long)stats[i].mean_ns,
+                (unsigned long long)stats[i].p50_ns, (unsigned long long)stats[i].p99_ns,
+                (unsigned long long)stats[i].max_ns);
+        first = 0;
+    }
+    fprintf(out, "%s]", first ? "" : "\n  ");
+}
+
+int db_latency_write_json(FILE *out) {
+    int max = DB_LATENCY_MAX_SQL;
+    for (DbLatencySite *site = atomic_load(&function_sites); site != NULL; site = site->next) {
+        max++;
+    }
+
+    DbLatencyStats *stats = malloc(max * sizeof(DbLatencyStats));
+    if (stats == NULL) {
+        return 0;
+    }
+    int n = db_latency_snapshot(stats, max);
+
+    fprintf(out, "{\n  \"unit\": \"ns\",\n  \"generated_at\": %lld,\n  \"untracked_statements\": %lu,\n",
+            (long long)time(NULL), atomic_load(&statements_untracked));
+    db_latency_json_list(out, "functions", "name", DB_LATENCY_FUNCTION, stats, n);
+    fputs(",\n", out);
+    db_latency_json_list(out, "statements", "sql", DB_LATENCY_STATEMENT, stats, n);
+    fputs("\n}\n", out);
+
+    free(stats);
+    return ferror(out) == 0;
+}
+
+int db_latency_dump_json(const char *path) {
+    if (path == NULL) {
+        path = DB_LATENCY_JSON_FILE;
+    }
+
+    FILE *out = fopen(path, "w");
+    if (out == NULL) {
+        LOG_ERROR("Cannot write latency report: %s", path);
+        return 0;
+    }
+
+    int ok = db_latency_write_json(out);
+    if (fclose(out) != 0) {
+        ok = 0;
+    }
+
+    if (ok) {
+        LOG_INFO("Latency report written to %s", path);
+    } else {
+        LOG_ERROR("Failed to write latency report: %s", path);
+    }
+    return ok;
+}
@@ -1,26 +1,3 @@
-#ifndef EMPLOYEE_UI_H
-#define EMPLOYEE_UI_H
-
-#include <gtk/gtk.h>
-
-
-// UI Functions
-void create_employee_ui(GtkWidget *container);
-void refresh_employee_list();
-
-// Button callbacks
-void on_add_employee_clicked(GtkButton *button, gpointer user_data);
-void on_save_employee_clicked(GtkButton *button, gpointer user_data);
-void on_refresh_employee_clicked(GtkButton *button, gpointer user_data);
-void on_search_employee_clicked(GtkButton *button, gpointer user_data);
-void on_edit_employee_clicked(GtkButton *button, gpointer user_data);
-void on_delete_employee_clicked(GtkButton *button, gpointer user_data);
-
-#endif
-// Optional - for more advanced features
-void on_employee_selected(GtkTreeView *tree_view, gpointer user_data);
-void show_employee_details(int emp_id);
-
 /* ============================================================================
  * FILE: src/db/db_payroll.c
  * PURPOSE: Database operations for Payroll Module
@@ -32,6 +9,8 @@ void show_employee_details(int emp_id);
 #include <string.h>
 #include <sqlite3.h>
 #include "../../include/payroll.h"
+#include "../../include/logger.h"
+#include "../../include/db_latency.h"
 
 /* ============================================================================
  * EXTERNAL VARIABLES (from database.c)
@@ -51,121 +30,25 @@ static char payroll_error_msg[500] = "";
 
 /**
  * Create payroll-related tables in database
- * Tables: employees, payroll, salary_slips
+ * Tables: employees, payroll, salary_slips - now part of the schema
+ * migrations in db_init.c, so this just brings the schema up to date
  * @return 1 on success, 0 on failure
  */
 int db_create_payroll_tables() {
+    DB_LATENCY_SCOPE();
+
     if (db == NULL) {
         snprintf(payroll_error_msg, sizeof(payroll_error_msg), 
-                 "[ERROR] Database not initialized");
-        fprintf(stderr, "%s\n", payroll_error_msg);
+                 "Database not initialized");
+        LOG_ERROR("%s", payroll_error_msg);
         return 0;
     }
 
-    printf("[INFO] Creating payroll-related tables...\n");
-
-    // SQL statements for all three tables
-    const char *sql_statements[] = {
-        // EMPLOYEES TABLE - Extended with all required fields
-        "CREATE TABLE IF NOT EXISTS employees ("
-        "    emp_id INTEGER PRIMARY KEY AUTOINCREMENT,"
-        "    emp_no TEXT UNIQUE NOT NULL,"
-        "    employee_name TEXT NOT NULL,"
-        "    birth_date DATE,"
-        "    department TEXT NOT NULL,"
-        "    designation TEXT NOT NULL,"
-        "    reporting_person TEXT,"
-        "    email TEXT UNIQUE,"
-        "    mobile_number TEXT,"
-        "    base_salary REAL NOT NULL,"
-        "    joining_date DATE,"
-        "    status TEXT DEFAULT 'Active',"
-        "    address TEXT,"
-        "    bank_account TEXT,"
-        "    created_date TIMESTAMP DEFAULT CURRENT_TIMESTAMP"
-        ");",
-
-        // PAYROLL TABLE
-        "CREATE TABLE IF NOT EXISTS payroll ("
-        "    payroll_id INTEGER PRIMARY KEY AUTOINCREMENT,"
-        "    emp_id INTEGER NOT NULL,"
-        "    month_year TEXT NOT NULL,"
-        "    basic_salary REAL NOT NULL,"
-        "    house_rent REAL DEFAULT 0,"
-        "    medical REAL DEFAULT 0,"
-        "    conveyance REAL DEFAULT 0,"
-        "    dearness_allowance REAL DEFAULT 0,"
-        "    performance_bonus REAL DEFAULT 0,"
-        "    other_allowances REAL DEFAULT 0,"
-        "    total_allowances REAL DEFAULT 0,"
-        "    income_tax REAL DEFAULT 0,"
-        "    provident_fund REAL DEFAULT 0,"
-        "    health_insurance REAL DEFAULT 0,"
-        "    loan_deduction REAL DEFAULT 0,"
-        "    other_deductions REAL DEFAULT 0,"
-        "    total_deductions REAL DEFAULT 0,"
-        "    gross_salary REAL DEFAULT 0,"
-        "    net_salary REAL DEFAULT 0,"
-        "    payment_date DATE,"
-        "    payment_method TEXT,"
-        "    status TEXT DEFAULT 'Pending',"
-        "    remarks TEXT,"
-        "    created_date TIMESTAMP DEFAULT CURRENT_TIMESTAMP,"
-        "    FOREIGN KEY (emp_id) REFERENCES employees(emp_id),"
-        "    UNIQUE(emp_id, month_year)"
-        ");",
-
-        // SALARY_SLIPS TABLE
-        "CREATE TABLE IF NOT EXISTS salary_slips ("
-        "    slip_id INTEGER PRIMARY KEY AUTOINCREMENT,"
-        "    payroll_id INTEGER NOT NULL,"
-        "    emp_id INTEGER NOT NULL,"
-        "    emp_no TEXT,"
-        "    employee_name TEXT,"
-        "    designation TEXT,"
-        "    department TEXT,"
-        "    from_date DATE,"
-        "    to_date DATE,"
-        "    slip_date DATE,"
-        "    basic_salary REAL,"
-        "    house_rent REAL,"
-        "    medical REAL,"
-        "    conveyance REAL,"
-        "    dearness_allowance REAL,"
-        "    performance_bonus REAL,"
-        "    other_allowances REAL,"
-        "    total_allowances REAL,"
-        "    income_tax REAL,"
-        "    provident_fund REAL,"
-        "    health_insurance REAL,"
-        "    loan_deduction REAL,"
-        "    other_deductions REAL,"
-        "    total_deductions REAL,"
-        "    gross_salary REAL,"
-        "    net_salary REAL,"
-        "    payment_status TEXT,"
-        "    FOREIGN KEY (payroll_id) REFERENCES payroll(payroll_id),"
-        "    FOREIGN KEY (emp_id) REFERENCES employees(emp_id)"
-        ");",
-
-        NULL
-    };
-
-    // Execute all SQL statements
-    for (int i = 0; sql_statements[i] != NULL; i++) {
-        char *err = NULL;
-        int rc = sqlite3_exec(db, sql_statements[i], NULL, NULL, &err);
-
-        if (rc != SQLITE_OK) {
-            snprintf(payroll_error_msg, sizeof(payroll_error_msg),
-                     "SQL error while creating table: %s", err);
-            fprintf(stderr, "[ERROR] %s\n", payroll_error_msg);
-            sqlite3_free(err);
-            return 0;
-        }
+    if (!db_migrate()) {
+        snprintf(payroll_error_msg, sizeof(payroll_error_msg),
+                 "Schema migration failed: %s", db_get_error());
+        return 0;
     }
-
-    printf("[SUCCESS] All payroll tables created successfully\n");
     return 1;
 }
 
@@ -175,22 +58,24 @@ int db_create_payroll_tables() {
  * @return payroll_id on success, -1 on failure
  */
 int db_add_payroll(const Payroll *payroll) {
+    DB_LATENCY_SCOPE();
+
     if (db == NULL) {
         snprintf(payroll_error_msg, sizeof(payroll_error_msg),
                  "Database not initialized");
-        fprintf(stderr, "[ERROR] %s\n", payroll_error_msg);
+        LOG_ERROR("%s", payroll_error_msg);
         return -1;
     }
 
     if (payroll == NULL) {
         snprintf(payroll_error_msg, sizeof(payroll_error_msg),
                  "Payroll struct is NULL");
-        fprintf(stderr, "[ERROR] %s\n", payroll_error_msg);
+        LOG_ERROR("%s", payroll_error_msg);
         return -1;
     }
 
-    printf("[INFO] Adding payroll for emp_id: %d, month: %s\n",
-           payroll->emp_id, payroll->month_year);
+    LOG_DEBUG("Adding payroll for emp_id: %d, month: %s",
+              payroll->emp_id, payroll->month_year);
 
     // SQL INSERT statement
     const char *sql = "INSERT INTO payroll ("
@@ -198,65 +83,59 @@ int db_add_payroll(const Payroll *payroll) {
         "dearness_allowance, performance_bonus, other_allowances, total_allowances, "
         "income_tax, provident_fund, health_insurance, loan_deduction, other_deductions, "
         "total_deductions, gross_salary, net_salary, payment_date, payment_method, "
-        "status, remarks) "
-        "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);";
-
-    sqlite3_stmt *stmt = NULL;
-    int result = sqlite3_prepare_v2(db, sql, -1, &stmt, NULL);
+        "status, remarks, department) "
+        "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, "
+        "(SELECT department FROM employees WHERE emp_id = ?1));";
 
-    if (result != SQLITE_OK) {
-        snprintf(payroll_error_msg, sizeof(payroll_error_msg),
-                 "Failed to prepare SQL: %s", sqlite3_errmsg(db));
-        fprintf(stderr, "[ERROR] %s\n", payroll_error_msg);
-        return -1;
-    }
+    sqlite3_stmt *stmt = db_stmt_acquire(sql);
 
     if (stmt == NULL) {
         snprintf(payroll_error_msg, sizeof(payroll_error_msg),
-                 "Statement is NULL");
-        fprintf(stderr, "[ERROR] %s\n", payroll_error_msg);
+                 "Failed to prepare SQL: %s", sqlite3_errmsg(db));
+        LOG_ERROR("%s", payroll_error_msg);
         return -1;
     }
 
-    // Bind parameters (22 parameters in total)
+    // Bind parameters (22 parameters in total; the department is looked up
+    // from ?1 so the payroll row keeps the employee's department at the time)
     sqlite3_bind_int(stmt, 1, payroll->emp_id);
     sqlite3_bind_text(stmt, 2, payroll->month_year, -1, SQLITE_STATIC);
-    sqlite3_bind_double(stmt, 3, payroll->basic_salary);
-    sqlite3_bind_double(stmt, 4, payroll->house_rent);
-    sqlite3_bind_double(stmt, 5, payroll->medical);
-    sqlite3_bind_double(stmt, 6, payroll->conveyance);
-    sqlite3_bind_double(stmt, 7, payroll->dearness_allowance);
-    sqlite3_bind_double(stmt, 8, payroll->performance_bonus);
-    sqlite3_bind_double(stmt, 9, payroll->other_allowances);
-    sqlite3_bind_double(stmt, 10, payroll->total_allowances);
-    sqlite3_bind_double(stmt, 11, payroll->income_tax);
-    sqlite3_bind_double(stmt, 12, payroll->provident_fund);
-    sqlite3_bind_double(stmt, 13, payroll->health_insurance);
-    sqlite3_bind_double(stmt, 14, payroll->loan_deduction);
-    sqlite3_bind_double(stmt, 15, payroll->other_deductions);
-    sqlite3_bind_double(stmt, 16, payroll->total_deductions);
-    sqlite3_bind_double(stmt, 17, payroll->gross_salary);
-    sqlite3_bind_double(stmt, 18, payroll->net_salary);
+    sqlite3_bind_int64(stmt, 3, payroll->basic_salary);
+    sqlite3_bind_int64(stmt, 4, payroll->house_rent);
+    sqlite3_bind_int64(stmt, 5, payroll->medical);
+    sqlite3_bind_int64(stmt, 6, payroll->conveyance);
+    sqlite3_bind_int64(stmt, 7, payroll->dearness_allowance);
+    sqlite3_bind_int64(stmt, 8, payroll->performance_bonus);
+    sqlite3_bind_int64(stmt, 9, payroll->other_allowances);
+    sqlite3_bind_int64(stmt, 10, payroll->total_allowances);
+    sqlite3_bind_int64(stmt, 11, payroll->income_tax);
+    sqlite3_bind_int64(stmt, 12, payroll->provident_fund);
+    sqlite3_bind_int64(stmt, 13, payroll->health_insurance);
+    sqlite3_bind_int64(stmt, 14, payroll->loan_deduction);
+    sqlite3_bind_int64(stmt, 15, payroll->other_deductions);
+    sqlite3_bind_int64(stmt, 16, payroll->total_deductions);
+    sqlite3_bind_int64(stmt, 17, payroll->gross_salary);
+    sqlite3_bind_int64(stmt, 18, payroll->net_salary);
     sqlite3_bind_text(stmt, 19, payroll->payment_date, -1, SQLITE_STATIC);
     sqlite3_bind_text(stmt, 20, payroll->payment_method, -1, SQLITE_STATIC);
     sqlite3_bind_text(stmt, 21, payroll->status, -1, SQLITE_STATIC);
     sqlite3_bind_text(stmt, 22, payroll->remarks, -1, SQLITE_STATIC);
 
     // Execute insert
-    result = sqlite3_step(stmt);
+    int result = sqlite3_step(stmt);
 
     if (result != SQLITE_DONE) {
         snprintf(payroll_error_msg, sizeof(payroll_error_msg),
                  "Failed to insert payroll: %s", sqlite3_errmsg(db));
-        fprintf(stderr, "[ERROR] %s\n", payroll_error_msg);
-        sqlite3_finalize(stmt);
+        LOG_ERROR("%s", payroll_error_msg);
+        db_stmt_release(stmt);
         return -1;
     }
 
     sqlite3_int64 payroll_id = sqlite3_last_insert_rowid(db);
-    sqlite3_finalize(stmt);
+    db_stmt_release(stmt);
 
-    printf("[SUCCESS] Payroll added with ID: %lld\n", payroll_id);
+    LOG_DEBUG("Payroll added with ID: %lld", payroll_id);
     return (int)payroll_id;
 }
 
@@ -267,6 +146,8 @@ int db_add_payroll(const Payroll *payroll) {
  * @return 1 if found, 0 if not found, -1 on error
  */
 int db_get_payroll(int payroll_id, Payroll *payroll) {
+    DB_LATENCY_SCOPE();
+
     if (db == NULL || payroll == NULL) {
         snprintf(payroll_error_msg, sizeof(payroll_error_msg),
                  "Database or payroll pointer is NULL");
@@ -280,10 +161,9 @@ int db_get_payroll(int payroll_id, Payroll *payroll) {
         "gross_salary, net_salary, payment_date, payment_method, status, remarks "
         "FROM payroll WHERE payroll_id = ?;";
 
-    sqlite3_stmt *stmt = NULL;
-    int result = sqlite3_prepare_v2(db, sql, -1, &stmt, NULL);
+    sqlite3_stmt *stmt = db_stmt_acquire(sql);
 
-    if (result != SQLITE_OK) {
+    if (stmt == NULL) {
         snprintf(payroll_error_msg, sizeof(payroll_error_msg),
                  "Failed to prepare SQL: %s", sqlite3_errmsg(db));
         return -1;
@@ -296,66 +176,72 @@ int db_get_payroll(int payroll_id, Payroll *payroll) {
         payroll->payroll_id = sqlite3_column_int(stmt, 0);
         payroll->emp_id = sqlite3_column_int(stmt, 1);
         strncpy(payroll->month_year, (const char *)sqlite3_column_text(stmt, 2), 19);
-        payroll->basic_salary = sqlite3_column_double(stmt, 3);
-        payroll->house_rent = sqlite3_column_double(stmt, 4);
-        payroll->medical = sqlite3_column_double(stmt, 5);
-        payroll->conveyance = sqlite3_column_double(stmt, 6);
-        payroll->dearness_allowance = sqlite3_column_double(stmt, 7);
-        payroll->performance_bonus = sqlite3_column_double(stmt, 8);
-        payroll->other_allowances = sqlite3_column_double(stmt, 9);
-        payroll->total_allowances = sqlite3_column_double(stmt, 10);
-        payroll->income_tax = sqlite3_column_double(stmt, 11);
-        payroll->provident_fund = sqlite3_column_double(stmt, 12);
-        payroll->health_insurance = sqlite3_column_double(stmt, 13);
-        payroll->loan_deduction = sqlite3_column_double(stmt, 14);
-        payroll->other_deductions = sqlite3_column_double(stmt, 15);
-        payroll->total_deductions = sqlite3_column_double(stmt, 16);
-        payroll->gross_salary = sqlite3_column_double(stmt, 17);
-        payroll->net_salary = sqlite3_column_double(stmt, 18);
+        payroll->basic_salary = sqlite3_column_int64(stmt, 3);
+        payroll->house_rent = sqlite3_column_int64(stmt, 4);
+        payroll->medical = sqlite3_column_int64(stmt, 5);
+        payroll->conveyance = sqlite3_column_int64(stmt, 6);
+        payroll->dearness_allowance = sqlite3_column_int64(stmt, 7);
+        payroll->performance_bonus = sqlite3_column_int64(stmt, 8);
+        payroll->other_allowances = sqlite3_column_int64(stmt, 9);
+        payroll->total_allowances = sqlite3_column_int64(stmt, 10);
+        payroll->income_tax = sqlite3_column_int64(stmt, 11);
+        payroll->provident_fund = sqlite3_column_int64(stmt, 12);
+        payroll->health_insurance = sqlite3_column_int64(stmt, 13);
+        payroll->loan_deduction = sqlite3_column_int64(stmt, 14);
+        payroll->other_deductions = sqlite3_column_int64(stmt, 15);
+        payroll->total_deductions = sqlite3_column_int64(stmt, 16);
+        payroll->gross_salary = sqlite3_column_int64(stmt, 17);
+        payroll->net_salary = sqlite3_column_int64(stmt, 18);
         strncpy(payroll->payment_date, (const char *)sqlite3_column_text(stmt, 19), 19);
         strncpy(payroll->payment_method, (const char *)sqlite3_column_text(stmt, 20), 49);
         strncpy(payroll->status, (const char *)sqlite3_column_text(stmt, 21), 19);
         strncpy(payroll->remarks, (const char *)sqlite3_column_text(stmt, 22), 199);
 
-        sqlite3_finalize(stmt);
-        printf("[SUCCESS] Payroll found: ID=%d, Emp=%d\n", payroll_id, payroll->emp_id);
+        db_stmt_release(stmt);
+        LOG_DEBUG("Payroll found: ID=%d, Emp=%d", payroll_id, payroll->emp_id);
         return 1;
     }
 
-    sqlite3_finalize(stmt);
-    printf("[WARNING] Payroll not found: ID=%d\n", payroll_id);
+    db_stmt_release(stmt);
+    LOG_WARNING("Payroll not found: ID=%d", payroll_id);
     return 0;
 }
 
+/**
+ * Payroll list, newest first; also run by the background loader
+ */
+const char db_payroll_list_sql[] =
+    "SELECT payroll_id, emp_id, month_year, basic_salary, "
+    "house_rent, medical, conveyance, dearness_allowance, performance_bonus, "
+    "other_allowances, total_allowances, income_tax, provident_fund, "
+    "health_insurance, loan_deduction, other_deductions, total_deductions, "
+    "gross_salary, net_salary, payment_date, payment_method, status, remarks "
+    "FROM payroll ORDER BY payroll_id DESC;";
+
 /**
  * Get all payroll records as SQLite statement
  * Caller must finalize the returned statement
  * @return sqlite3_stmt pointer, NULL on error
  */
 sqlite3_stmt* db_get_all_payroll() {
+    DB_LATENCY_SCOPE();
+
     if (db == NULL) {
-        fprintf(stderr, "[ERROR] Database not initialized\n");
+        LOG_ERROR("Database not initialized");
         return NULL;
     }
 
-    const char *sql = "SELECT payroll_id, emp_id, month_year, basic_salary, "
-        "house_rent, medical, conveyance, dearness_allowance, performance_bonus, "
-        "other_allowances, total_allowances, income_tax, provident_fund, "
-        "health_insurance, loan_deduction, other_deductions, total_deductions, "
-        "gross_salary, net_salary, payment_date, payment_method, status, remarks "
-        "FROM payroll ORDER BY payroll_id DESC;";
-
     sqlite3_stmt *stmt = NULL;
-    int result = sqlite3_prepare_v2(db, sql, -1, &stmt, NULL);
+    int result = sqlite3_prepare_v2(db, db_payroll_list_sql, -1, &stmt, NULL);
 
     if (result != SQLITE_OK) {
         snprintf(payroll_error_msg, sizeof(payroll_error_msg),
                  "Failed to prepare SQL: %s", sqlite3_errmsg(db));
-        fprintf(stderr, "[ERROR] %s\n", payroll_error_msg);
+        LOG_ERROR("%s", payroll_error_msg);
         return NULL;
     }
 
-    printf("[INFO] Retrieved all payroll records\n");
+    LOG_INFO("Retrieved all payroll records");
     return stmt;
 }
 
@@ -367,6 +253,8 @@ sqlite3_stmt* db_get_all_payroll() {
  * @return 1 if found, 0 if not found, -1 on error
  */
 int db_get_payroll_by_emp_month(int emp_id, const char *month_year, Payroll *payroll) {
+    DB_LATENCY_SCOPE();
+
     if (db == NULL || payroll == NULL || month_year == NULL) {
         snprintf(payroll_error_msg, sizeof(payroll_error_msg),
                  "Invalid parameters");
@@ -380,10 +268,9 @@ int db_get_payroll_by_emp_month(int emp_id, const char *month_year, Payroll *pay
         "gross_salary, net_salary, payment_date, payment_method, status, remarks "
         "FROM payroll WHERE emp_id = ? AND month_year = ? LIMIT 1;";
 
-    sqlite3_stmt *stmt = NULL;
-    int result = sqlite3_prepare_v2(db, sql, -1, &stmt, NULL);
+    sqlite3_stmt *stmt = db_stmt_acquire(sql);
 
-    if (result != SQLITE_OK) {
+    if (stmt == NULL) {
         snprintf(payroll_error_msg, sizeof(payroll_error_msg),
                  "Failed to prepare SQL: %s", sqlite3_errmsg(db));
         return -1;
@@ -396,32 +283,32 @@ int db_get_payroll_by_emp_month(int emp_id, const char *month_year, Payroll *pay
         payroll->payroll_id = sqlite3_column_int(stmt, 0);
         payroll->emp_id = sqlite3_column_int(stmt, 1);
         strncpy(payroll->month_year, (const char *)sqlite3_column_text(stmt, 2), 19);
-        payroll->basic_salary = sqlite3_column_double(stmt, 3);
-        payroll->house_rent = sqlite3_column_double(stmt, 4);
-        payroll->medical = sqlite3_column_double(stmt, 5);
-        payroll->conveyance = sqlite3_column_double(stmt, 6);
-        payroll->dearness_allowance = sqlite3_column_double(stmt, 7);
-        payroll->performance_bonus = sqlite3_column_double(stmt, 8);
-        payroll->other_allowances = sqlite3_column_double(stmt, 9);
-        payroll->total_allowances = sqlite3_column_double(stmt, 10);
-        payroll->income_tax = sqlite3_column_double(stmt, 11);
-        payroll->provident_fund = sqlite3_column_double(stmt, 12);
-        payroll->health_insurance = sqlite3_column_double(stmt, 13);
-        payroll->loan_deduction = sqlite3_column_double(stmt, 14);
-        payroll->other_deductions = sqlite3_column_double(stmt, 15);
-        payroll->total_deductions = sqlite3_column_double(stmt, 16);
-        payroll->gross_salary = sqlite3_column_double(stmt, 17);
-        payroll->net_salary = sqlite3_column_double(stmt, 18);
+        payroll->basic_salary = sqlite3_column_int64(stmt, 3);
+        payroll->house_rent = sqlite3_column_int64(stmt, 4);
+        payroll->medical = sqlite3_column_int64(stmt, 5);
+        payroll->conveyance = sqlite3_column_int64(stmt, 6);
+        payroll->dearness_allowance = sqlite3_column_int64(stmt, 7);
+        payroll->performance_bonus = sqlite3_column_int64(stmt, 8);
+        payroll->other_allowances = sqlite3_column_int64(stmt, 9);
+        payroll->total_allowances = sqlite3_column_int64(stmt, 10);
+        payroll->income_tax = sqlite3_column_int64(stmt, 11);
+        payroll->provident_fund = sqlite3_column_int64(stmt, 12);
+        payroll->health_insurance = sqlite3_column_int64(stmt, 13);
+        payroll->loan_deduction = sqlite3_column_int64(stmt, 14);
+        payroll->other_deductions = sqlite3_column_int64(stmt, 15);
+        payroll->total_deductions = sqlite3_column_int64(stmt, 16);
+        payroll->gross_salary = sqlite3_column_int64(stmt, 17);
+        payroll->net_salary = sqlite3_column_int64(stmt, 18);
         strncpy(payroll->payment_date, (const char *)sqlite3_column_text(stmt, 19), 19);
         strncpy(payroll->payment_method, (const char *)sqlite3_column_text(stmt, 20), 49);
         strncpy(payroll->status, (const char *)sqlite3_column_text(stmt, 21), 19);
         strncpy(payroll->remarks, (const char *)sqlite3_column_text(stmt, 22), 199);
 
-        sqlite3_finalize(stmt);
+        db_stmt_release(stmt);
         return 1;
     }
 
-    sqlite3_finalize(stmt);
+    db_stmt_release(stmt);
     return 0;
 }
 
@@ -431,6 +318,8 @@ int db_get_payroll_by_emp_month(int emp_id, const char *month_year, Payroll *pay
  * @return 1 on success, -1 on failure
  */
 int db_update_payroll(const Payroll *payroll) {
+    DB_LATENCY_SCOPE();
+
     if (db == NULL || payroll == NULL) {
         snprintf(payroll_error_msg, sizeof(payroll_error_msg),
                  "Database or payroll pointer is NULL");
@@ -446,50 +335,49 @@ int db_update_payroll(const Payroll *payroll) {
         "payment_date = ?, payment_method = ?, status = ?, remarks = ? "
         "WHERE payroll_id = ?;";
 
-    sqlite3_stmt *stmt = NULL;
-    int result = sqlite3_prepare_v2(db, sql, -1, &stmt, NULL);
+    sqlite3_stmt *stmt = db_stmt_acquire(sql);
 
-    if (result != SQLITE_OK) {
+    if (stmt == NULL) {
         snprintf(payroll_error_msg, sizeof(payroll_error_msg),
                  "Failed to prepare SQL: %s", sqlite3_errmsg(db));
         return -1;
     }
 
     // Bind all parameters
-    sqlite3_bind_double(stmt, 1, payroll->basic_salary);
-    sqlite3_bind_double(stmt, 2, payroll->house_rent);
-    sqlite3_bind_double(stmt, 3, payroll->medical);
-    sqlite3_bind_double(stmt, 4, payroll->conveyance);
-    sqlite3_bind_double(stmt, 5, payroll->dearness_allowance);
-    sqlite3_bind_double(stmt, 6, payroll->performance_bonus);
-    sqlite3_bind_double(stmt, 7, payroll->other_allowances);
-    sqlite3_bind_double(stmt, 8, payroll->total_allowances);
-    sqlite3_bind_double(stmt, 9, payroll->income_tax);
-    sqlite3_bind_double(stmt, 10, payroll->provident_fund);
-    sqlite3_bind_double(stmt, 11, payroll->health_insurance);
-    sqlite3_bind_double(stmt, 12, payroll->loan_deduction);
-    sqlite3_bind_double(stmt, 13, payroll->other_deductions);
-    sqlite3_bind_double(stmt, 14, payroll->total_deductions);
-    sqlite3_bind_double(stmt, 15, payroll->gross_salary);
-    sqlite3_bind_double(stmt, 16, payroll->net_salary);
+    sqlite3_bind_int64(stmt, 1, payroll->basic_salary);
+    sqlite3_bind_int64(stmt, 2, payroll->house_rent);
+    sqlite3_bind_int64(stmt, 3, payroll->medical);
+    sqlite3_bind_int64(stmt, 4, payroll->conveyance);
+    sqlite3_bind_int64(stmt, 5, payroll->dearness_allowance);
+    sqlite3_bind_int64(stmt, 6, payroll->performance_bonus);
+    sqlite3_bind_int64(stmt, 7, payroll->other_allowances);
+    sqlite3_bind_int64(stmt, 8, payroll->total_allowances);
+    sqlite3_bind_int64(stmt, 9, payroll->income_tax);
+    sqlite3_bind_int64(stmt, 10, payroll->provident_fund);
+    sqlite3_bind_int64(stmt, 11, payroll->health_insurance);
+    sqlite3_bind_int64(stmt, 12, payroll->loan_deduction);
+    sqlite3_bind_int64(stmt, 13, payroll->other_deductions);
+    sqlite3_bind_int64(stmt, 14, payroll->total_deductions);
+    sqlite3_bind_int64(stmt, 15, payroll->gross_salary);
+    sqlite3_bind_int64(stmt, 16, payroll->net_salary);
     sqlite3_bind_text(stmt, 17, payroll->payment_date, -1, SQLITE_STATIC);
     sqlite3_bind_text(stmt, 18, payroll->payment_method, -1, SQLITE_STATIC);
     sqlite3_bind_text(stmt, 19, payroll->status, -1, SQLITE_STATIC);
     sqlite3_bind_text(stmt, 20, payroll->remarks, -1, SQLITE_STATIC);
     sqlite3_bind_int(stmt, 21, payroll->payroll_id);
 
-    result = sqlite3_step(stmt);
+    int result = sqlite3_step(stmt);
 
     if (result != SQLITE_DONE) {
         snprintf(payroll_error_msg, sizeof(payroll_error_msg),
                  "Failed to update payroll: %s", sqlite3_errmsg(db));
-        fprintf(stderr, "[ERROR] %s\n", payroll_error_msg);
-        sqlite3_finalize(stmt);
+        LOG_ERROR("%s", payroll_error_msg);
+        db_stmt_release(stmt);
         return -1;
     }
 
-    sqlite3_finalize(stmt);
-    printf("[SUCCESS] Payroll updated: ID=%d\n", payroll->payroll_id);
+    db_stmt_release(stmt);
+    LOG_SUCCESS("Payroll updated: ID=%d", payroll->payroll_id);
     return 1;
 }
 
@@ -499,6 +387,8 @@ int db_update_payroll(const Payroll *payroll) {
  * @return 1 on success, -1 on failure
  */
 int db_delete_payroll(int payroll_id) {
+    DB_LATENCY_SCOPE();
+
     if (db == NULL) {
         snprintf(payroll_error_msg, sizeof(payroll_error_msg),
                  "Database not initialized");
@@ -507,27 +397,26 @@ int db_delete_payroll(int payroll_id) {
 
     const char *sql = "DELETE FROM payroll WHERE payroll_id = ?;";
 
-    sqlite3_stmt *stmt = NULL;
-    int result = sqlite3_prepare_v2(db, sql, -1, &stmt, NULL);
+    sqlite3_stmt *stmt = db_stmt_acquire(sql);
 
-    if (result != SQLITE_OK) {
+    if (stmt == NULL) {
         snprintf(payroll_error_msg, sizeof(payroll_error_msg),
                  "Failed to prepare SQL: %s", sqlite3_errmsg(db));
         return -1;
     }
 
     sqlite3_bind_int(stmt, 1, payroll_id);
-    result = sqlite3_step(stmt);
+    int result = sqlite3_step(stmt);
 
     if (result != SQLITE_DONE) {
         snprintf(payroll_error_msg, sizeof(payroll_error_msg),
                  "Failed to delete payroll: %s", sqlite3_errmsg(db));
-        sqlite3_finalize(stmt);
+        db_stmt_release(stmt);
         return -1;
     }
 
-    sqlite3_finalize(stmt);
-    printf("[SUCCESS] Payroll deleted: ID=%d\n", payroll_id);
+    db_stmt_release(stmt);
+    LOG_SUCCESS("Payroll deleted: ID=%d", payroll_id);
     return 1;
 }
 
@@ -539,6 +428,8 @@ int db_delete_payroll(int payroll_id) {
  * @return 1 on success, -1 on failure
  */
 int db_mark_payroll_paid(int payroll_id, const char *payment_date, const char *payment_method) {
+    DB_LATENCY_SCOPE();
+
     if (db == NULL || payment_date == NULL || payment_method == NULL) {
         snprintf(payroll_error_msg, sizeof(payroll_error_msg),
                  "Invalid parameters");
@@ -547,10 +438,9 @@ int db_mark_payroll_paid(int payroll_id, const char *payment_date, const char *p
 
     const char *sql = "UPDATE payroll SET status = 'Paid', payment_date = ?, payment_method = ? WHERE payroll_id = ?;";
 
-    sqlite3_stmt *stmt = NULL;
-    int result = sqlite3_prepare_v2(db, sql, -1, &stmt, NULL);
+    sqlite3_stmt *stmt = db_stmt_acquire(sql);
 
-    if (result != SQLITE_OK) {
+    if (stmt == NULL) {
         snprintf(payroll_error_msg, sizeof(payroll_error_msg),
                  "Failed to prepare SQL: %s", sqlite3_errmsg(db));
         return -1;
@@ -560,17 +450,17 @@ int db_mark_payroll_paid(int payroll_id, const char *payment_date, const char *p
     sqlite3_bind_text(stmt, 2, payment_method, -1, SQLITE_STATIC);
     sqlite3_bind_int(stmt, 3, payroll_id);
 
-    result = sqlite3_step(stmt);
+    int result = sqlite3_step(stmt);
 
     if (result != SQLITE_DONE) {
         snprintf(payroll_error_msg, sizeof(payroll_error_msg),
                  "Failed to mark paid: %s", sqlite3_errmsg(db));
-        sqlite3_finalize(stmt);
+        db_stmt_release(stmt);
         return -1;
     }
 
-    sqlite3_finalize(stmt);
-    printf("[SUCCESS] Payroll marked as paid: ID=%d, Date=%s\n", payroll_id, payment_date);
+    db_stmt_release(stmt);
+    LOG_SUCCESS("Payroll marked as paid: ID=%d, Date=%s", payroll_id, payment_date);
     return 1;
 }
 
@@ -580,6 +470,8 @@ int db_mark_payroll_paid(int payroll_id, const char *payment_date, const char *p
  * @return slip_id on success, -1 on failure
  */
 int db_add_salary_slip(const SalarySlip *slip) {
+    DB_LATENCY_SCOPE();
+
     if (db == NULL || slip == NULL) {
         snprintf(payroll_error_msg, sizeof(payroll_error_msg),
                  "Database or slip pointer is NULL");
@@ -595,10 +487,9 @@ int db_add_salary_slip(const SalarySlip *slip) {
         "net_salary, payment_status) "
         "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);";
 
-    sqlite3_stmt *stmt = NULL;
-    int result = sqlite3_prepare_v2(db, sql, -1, &stmt, NULL);
+    sqlite3_stmt *stmt = db_stmt_acquire(sql);
 
-    if (result != SQLITE_OK) {
+    if (stmt == NULL) {
         snprintf(payroll_error_msg, sizeof(payroll_error_msg),
                  "Failed to prepare SQL: %s", sqlite3_errmsg(db));
         return -1;
@@ -614,38 +505,237 @@ int db_add_salary_slip(const SalarySlip *slip) {
     sqlite3_bind_text(stmt, 7, slip->from_date, -1, SQLITE_STATIC);
     sqlite3_bind_text(stmt, 8, slip->to_date, -1, SQLITE_STATIC);
     sqlite3_bind_text(stmt, 9, slip->slip_date, -1, SQLITE_STATIC);
-    sqlite3_bind_double(stmt, 10, slip->basic_salary);
-    sqlite3_bind_double(stmt, 11, slip->house_rent);
-    sqlite3_bind_double(stmt, 12, slip->medical);
-    sqlite3_bind_double(stmt, 13, slip->conveyance);
-    sqlite3_bind_double(stmt, 14, slip->dearness_allowance);
-    sqlite3_bind_double(stmt, 15, slip->performance_bonus);
-    sqlite3_bind_double(stmt, 16, slip->other_allowances);
-    sqlite3_bind_double(stmt, 17, slip->total_allowances);
-    sqlite3_bind_double(stmt, 18, slip->income_tax);
-    sqlite3_bind_double(stmt, 19, slip->provident_fund);
-    sqlite3_bind_double(stmt, 20, slip->health_insurance);
-    sqlite3_bind_double(stmt, 21, slip->loan_deduction);
-    sqlite3_bind_double(stmt, 22, slip->other_deductions);
-    sqlite3_bind_double(stmt, 23, slip->total_deductions);
-    sqlite3_bind_double(stmt, 24, slip->gross_salary);
-    sqlite3_bind_double(stmt, 25, slip->net_salary);
+    sqlite3_bind_int64(stmt, 10, slip->basic_salary);
+    sqlite3_bind_int64(stmt, 11, slip->house_rent);
+    sqlite3_bind_int64(stmt, 12, slip->medical);
+    sqlite3_bind_int64(stmt, 13, slip->conveyance);
+    sqlite3_bind_int64(stmt, 14, slip->dearness_allowance);
+    sqlite3_bind_int64(stmt, 15, slip->performance_bonus);
+    sqlite3_bind_int64(stmt, 16, slip->other_allowances);
+    sqlite3_bind_int64(stmt, 17, slip->total_allowances);
+    sqlite3_bind_int64(stmt, 18, slip->income_tax);
+    sqlite3_bind_int64(stmt, 19, slip->provident_fund);
+    sqlite3_bind_int64(stmt, 20, slip->health_insurance);
+    sqlite3_bind_int64(stmt, 21, slip->loan_deduction);
+    sqlite3_bind_int64(stmt, 22, slip->other_deductions);
+    sqlite3_bind_int64(stmt, 23, slip->total_deductions);
+    sqlite3_bind_int64(stmt, 24, slip->gross_salary);
+    sqlite3_bind_int64(stmt, 25, slip->net_salary);
     sqlite3_bind_text(stmt, 26, slip->payment_status, -1, SQLITE_STATIC);
 
-    result = sqlite3_step(stmt);
+    int result = sqlite3_step(stmt);
 
     if (result != SQLITE_DONE) {
         snprintf(payroll_error_msg, sizeof(payroll_error_msg),
                  "Failed to insert salary slip: %s", sqlite3_errmsg(db));
-        fprintf(stderr, "[ERROR] %s\n", payroll_error_msg);
-        sqlite3_finalize(stmt);
+        LOG_ERROR("%s", payroll_error_msg);
+        db_stmt_release(stmt);
         return -1;
     }
 
     sqlite3_int64 slip_id = sqlite3_last_insert_rowid(db);
-    sqlite3_finalize(stmt);
+    db_stmt_release(stmt);
 
-    printf("[SUCCESS] Salary slip added with ID: %lld\n", slip_id);
+    LOG_DEBUG("Salary slip added with ID: %lld", slip_id);
     return (int)slip_id;
 }
 
+
+/**
+ * Load the active employees for a payroll run
+ * Employees that already have a payroll row for month_year are counted in
+ * *out_already_paid and left out of the list, so a run that is repeated
+ * only picks up the employees still missing
+ * @param month_year - Month and year (e.g., "Dec-2025")
+ * @param out_employees - Set to a malloc'd array (free() it); NULL if empty
+ * @param out_already_paid - Optional, active employees already on payroll
+ * @return Number of employees in the list, -1 on failure
+ */
+int db_get_payroll_run_employees(const char *month_year, Employee **out_employees, int *out_already_paid) {
+    DB_LATENCY_SCOPE();
+
+    if (db == NULL || month_year == NULL || out_employees == NULL) {
+        snprintf(payroll_error_msg, sizeof(payroll_error_msg),
+                 "Invalid parameters");
+        return -1;
+    }
+
+    *out_employees = NULL;
+    if (out_already_paid) {
+        *out_already_paid = 0;
+    }
+
+    const char *sql = "SELECT e.emp_id, e.emp_no, e.emp_name, e.department, e.designation, e.base_salary, "
+        "EXISTS (SELECT 1 FROM payroll p WHERE p.emp_id = e.emp_id AND p.month_year = ?) "
+        "FROM employees e WHERE e.status = 'Active' ORDER BY e.emp_id;";
+
+    // Nearly every employee is active, so the scan is the plan we want
+    sqlite3_stmt *stmt = db_stmt_acquire_scan(sql);
+
+    if (stmt == NULL) {
+        snprintf(payroll_error_msg, sizeof(payroll_error_msg),
+                 "Failed to prepare SQL: %s", sqlite3_errmsg(db));
+        return -1;
+    }
+
+    sqlite3_bind_text(stmt, 1, month_year, -1, SQLITE_STATIC);
+
+    Employee *employees = NULL;
+    int count = 0;
+    int capacity = 0;
+    int already_paid = 0;
+    int result;
+
+    while ((result = sqlite3_step(stmt)) == SQLITE_ROW) {
+        if (sqlite3_column_int(stmt, 6)) {
+            already_paid++;
+            continue;
+        }
+
+        if (count == capacity) {
+            capacity = capacity ? capacity * 2 : 256;
+            Employee *grown = (Employee *)realloc(employees, capacity * sizeof(Employee));
+            if (grown == NULL) {
+                snprintf(payroll_error_msg, sizeof(payroll_error_msg), "Memory allocation failed");
+                free(employees);
+                db_stmt_release(stmt);
+                return -1;
+            }
+            employees = grown;
+        }
+
+        Employee *emp = &employees[count++];
+        const char *name = (const char *)sqlite3_column_text(stmt, 2);
+        const char *department = (const char *)sqlite3_column_text(stmt, 3);
+        const char *designation = (const char *)sqlite3_column_text(stmt, 4);
+
+        memset(emp, 0, sizeof(Employee));
+        emp->emp_id = sqlite3_column_int(stmt, 0);
+        emp->emp_no = sqlite3_column_int(stmt, 1);
+        strncpy(emp->emp_name, name ? name : "", sizeof(emp->emp_name) - 1);
+        strncpy(emp->department, department ? department : "", sizeof(emp->department) - 1);
+        strncpy(emp->designation, designation ? designation : "", sizeof(emp->designation) - 1);
+        emp->base_salary = sqlite3_column_int64(stmt, 5);
+        strcpy(emp->status, "Active");
+    }
+
+    if (result != SQLITE_DONE) {
+        snprintf(payroll_error_msg, sizeof(payroll_error_msg),
+                 "Failed to load employees: %s", sqlite3_errmsg(db));
+        LOG_ERROR("%s", payroll_error_msg);
+        free(employees);
+        db_stmt_release(stmt);
+        return -1;
+    }
+
+    db_stmt_release(stmt);
+
+    *out_employees = employees;
+    if (out_already_paid) {
+        *out_already_paid = already_paid;
+    }
+    return count;
+}
+
+/**
+ * Recompute PayrollSummary from the payroll table
+ * The payroll_summary_* triggers keep it current; this is for filling it
+ * the first time and for repairing it
+ * @return 1 on success, 0 on failure
+ */
+int db_rebuild_payroll_summary(void) {
+    DB_LATENCY_SCOPE();
+
+    if (db == NULL) {
+        return 0;
+    }
+
+    const char *queries[] = {
+        "DELETE FROM PayrollSummary;",
+
+        "INSERT INTO PayrollSummary (month_year, department, headcount, paid_count, "
+        "total_gross, total_deductions, total_net, paid_net) "
+        "SELECT month_year, COALESCE(department, ''), COUNT(*), SUM(status = 'Paid'), "
+        "SUM(COALESCE(gross_salary, 0)), SUM(COALESCE(total_deductions, 0)), SUM(COALESCE(net_salary, 0)), "
+        "SUM(CASE WHEN status = 'Paid' THEN COALESCE(net_salary, 0) ELSE 0 END) "
+        "FROM payroll GROUP BY month_year, COALESCE(department, '');",
+        NULL
+    };
+
+    if (!db_begin_transaction()) {
+        return 0;
+    }
+
+    for (int i = 0; queries[i] != NULL; i++) {
+        char *err = NULL;
+        if (sqlite3_exec(db, queries[i], NULL, NULL, &err) != SQLITE_OK) {
+            snprintf(payroll_error_msg, sizeof(payroll_error_msg),
+                     "Payroll summary rebuild failed: %s", err);
+            LOG_ERROR("%s", payroll_error_msg);
+            sqlite3_free(err);
+            db_rollback_transaction();
+            return 0;
+        }
+    }
+
+    return db_commit_transaction();
+}
+
+/**
+ * Read the payroll rollup for a month
+ * One PayrollSummary row for a department; for all departments, the
+ * month's rows (one per department) are added up
+ * @param month_year - Month and year (e.g., "Dec-2025")
+ * @param department - Department name, NULL for all departments
+ * @param summary - Filled with the totals, all zero if there is no payroll
+ * @return 1 on success, -1 on failure
+ */
+int db_get_payroll_summary(const char *month_year, const char *department, PayrollSummary *summary) {
+    DB_LATENCY_SCOPE();
+
+    if (db == NULL || month_year == NULL || summary == NULL) {
+        snprintf(payroll_error_msg, sizeof(payroll_error_msg),
+                 "Invalid parameters");
+        return -1;
+    }
+
+    const char *sql = department != NULL
+        ? "SELECT headcount, paid_count, total_gross, total_deductions, total_net, paid_net "
+          "FROM PayrollSummary WHERE month_year = ? AND department = ?;"
+        : "SELECT SUM(headcount), SUM(paid_count), SUM(total_gross), "
+          "SUM(total_deductions), SUM(total_net), SUM(paid_net) "
+          "FROM PayrollSummary WHERE month_year = ?;";
+
+    sqlite3_stmt *stmt = db_stmt_acquire(sql);
+
+    if (stmt == NULL) {
+        snprintf(payroll_error_msg, sizeof(payroll_error_msg),
+                 "Failed to prepare SQL: %s", sqlite3_errmsg(db));
+        return -1;
+    }
+
+    sqlite3_bind_text(stmt, 1, month_year, -1, SQLITE_STATIC);
+    if (department != NULL) {
+        sqlite3_bind_text(stmt, 2, department, -1, SQLITE_STATIC);
+    }
+
+    memset(summary, 0, sizeof(PayrollSummary));
+
+    int result = sqlite3_step(stmt);
+    if (result == SQLITE_ROW) {
+        summary->headcount = sqlite3_column_int(stmt, 0);
+        summary->paid_count = sqlite3_column_int(stmt, 1);
+        summary->total_gross = sqlite3_column_int64(stmt, 2);
+        summary->total_deductions = sqlite3_column_int64(stmt, 3);
+        summary->total_net = sqlite3_column_int64(stmt, 4);
+        summary->paid_net = sqlite3_column_int64(stmt, 5);
+    } else if (result != SQLITE_DONE) {
+        snprintf(payroll_error_msg, sizeof(payroll_error_msg),
+                 "Failed to read payroll summary: %s", sqlite3_errmsg(db));
+        db_stmt_release(stmt);
+        return -1;
+    }
+
+    db_stmt_release(stmt);
+    return 1;
+}
@@ -0,0 +1,227 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sqlite3.h>
+#include <glib.h>
+#include "../../include/database.h"
+#include "../../include/logger.h"
+#include "../../include/db_latency.h"
+
+
+extern sqlite3 *db;
+
+
+// ============================================================================
+// STUDENT PHOTOS
+//
+// A photo is written by inserting a zeroblob of its size and filling it
+// through an incremental blob handle, DB_PHOTO_CHUNK bytes at a time, so
+// neither SQLite nor the app ever holds the whole image. Reads stream the
+// same way. StudentPhotos.student_id is the rowid, which is what
+// sqlite3_blob_open() takes.
+// ============================================================================
+
+
+// Size of an open file, or -1
+static long photo_file_size(FILE *file) {
+    if (fseek(file, 0, SEEK_END) != 0) {
+        return -1;
+    }
+    long size = ftell(file);
+    rewind(file);
+    return size;
+}
+
+static int photo_student_exists(int student_id) {
+    sqlite3_stmt *stmt = db_stmt_acquire("SELECT 1 FROM Students WHERE student_id = ?;");
+    if (stmt == NULL) {
+        LOG_ERROR("Failed to prepare student lookup: %s", sqlite3_errmsg(db));
+        return 0;
+    }
+
+    sqlite3_bind_int(stmt, 1, student_id);
+    int found = sqlite3_step(stmt) == SQLITE_ROW;
+    db_stmt_release(stmt);
+    return found;
+}
+
+// Copies the file into the zeroblob just inserted for student_id
+static int photo_stream_in(int student_id, FILE *file, long size) {
+    sqlite3_blob *blob = NULL;
+    if (sqlite3_blob_open(db, "main", "StudentPhotos", "photo", student_id, 1, &blob) != SQLITE_OK) {
+        LOG_ERROR("Failed to open photo blob: %s", sqlite3_errmsg(db));
+        sqlite3_blob_close(blob);
+        return 0;
+    }
+
+    unsigned char *chunk = (unsigned char *)malloc(DB_PHOTO_CHUNK);
+    if (chunk == NULL) {
+        LOG_ERROR("Memory allocation failed");
+        sqlite3_blob_close(blob);
+        return 0;
+    }
+
+    long offset = 0;
+    int ok = 1;
+    while (ok && offset < size) {
+        size_t want = (size_t)MIN((long)DB_PHOTO_CHUNK, size - offset);
+        size_t got = fread(chunk, 1, want, file);
+        if (got != want) {
+            LOG_ERROR("Photo file ended early at byte %ld of %ld", offset + (long)got, size);
+            ok = 0;
+        } else if (sqlite3_blob_write(blob, chunk, (int)got, (int)offset) != SQLITE_OK) {
+            LOG_ERROR("Failed to write photo: %s", sqlite3_errmsg(db));
+            ok = 0;
+        }
+        offset += (long)got;
+    }
+
+    free(chunk);
+    if (sqlite3_blob_close(blob) != SQLITE_OK) {
+        ok = 0;
+    }
+    return ok;
+}
+
+int db_save_student_photo(int student_id, const char *photo_path,
+                          const unsigned char *thumbnail, int thumbnail_size) {
+    DB_LATENCY_SCOPE();
+
+    if (!db || !photo_path || !thumbnail || thumbnail_size <= 0) return 0;
+
+    if (!photo_student_exists(student_id)) {
+        LOG_ERROR("No student with ID %d", student_id);
+        return 0;
+    }
+
+    FILE *file = fopen(photo_path, "rb");
+    if (file == NULL) {
+        LOG_ERROR("Cannot open photo: %s", photo_path);
+        return 0;
+    }
+
+    long size = photo_file_size(file);
+    if (size <= 0 || size > DB_PHOTO_MAX_BYTES) {
+        LOG_ERROR("Photo must be 1 byte to %d MB (%s is %ld bytes)",
+                  DB_PHOTO_MAX_BYTES / (1024 * 1024), photo_path, size);
+        fclose(file);
+        return 0;
+    }
+
+    if (!db_begin_transaction()) {
+        fclose(file);
+        return 0;
+    }
+
+    const char *sql =
+        "INSERT OR REPLACE INTO StudentPhotos (student_id, thumbnail, photo, updated_at) "
+        "VALUES (?, ?, zeroblob(?), CURRENT_TIMESTAMP);";
+
+    sqlite3_stmt *stmt = db_stmt_acquire(sql);
+    int ok = stmt != NULL;
+    if (ok) {
+        sqlite3_bind_int(stmt, 1, student_id);
+        sqlite3_bind_blob(stmt, 2, thumbnail, thumbnail_size, SQLITE_STATIC);
+        sqlite3_bind_int(stmt, 3, (int)size);
+
+        ok = sqlite3_step(stmt) == SQLITE_DONE;
+        if (!ok) {
+            LOG_ERROR("Failed to store photo: %s", sqlite3_errmsg(db));
+        }
+        db_stmt_release(stmt);
+    } else {
+        LOG_ERROR("Failed to prepare photo insert: %s", sqlite3_errmsg(db));
+    }
+
+    ok = ok && photo_stream_in(student_id, file, size);
+    fclose(file);
+
+    if (!ok) {
+        db_rollback_transaction();
+        return 0;
+    }
+    if (!db_commit_transaction()) {
+        return 0;
+    }
+
+    LOG_SUCCESS("Photo saved for student %d (%ld bytes, %d byte thumbnail)",
+                student_id, size, thumbnail_size);
+    return 1;
+}
+
+int db_get_student_thumbnail(int student_id, unsigned char **out_data, int *out_size) {
+    DB_LATENCY_SCOPE();
+
+    if (!db || !out_data || !out_size) return 0;
+
+    *out_data = NULL;
+    *out_size = 0;
+
+    // Fails with "no such rowid" when the student has no photo
+    sqlite3_blob *blob = NULL;
+    if (sqlite3_blob_open(db, "main", "StudentPhotos", "thumbnail", student_id, 0, &blob) != SQLITE_OK) {
+        sqlite3_blob_close(blob);
+        return 0;
+    }
+
+    int size = sqlite3_blob_bytes(blob);
+    unsigned char *data = size > 0 ? (unsigned char *)g_malloc(size) : NULL;
+    int ok = data != NULL && sqlite3_blob_read(blob, data, size, 0) == SQLITE_OK;
+    sqlite3_blob_close(blob);
+
+    if (!ok) {
+        g_free(data);
+        return 0;
+    }
+
+    *out_data = data;
+    *out_size = size;
+    return 1;
+}
+
+int db_read_student_photo(int student_id, DbBlobSink sink, void *user_data) {
+    DB_LATENCY_SCOPE();
+
+    if (!db || !sink) return 0;
+
+    sqlite3_blob *blob = NULL;
+    if (sqlite3_blob_open(db, "main", "StudentPhotos", "photo", student_id, 0, &blob) != SQLITE_OK) {
+        sqlite3_blob_close(blob);
+        return 0;
+    }
+
+    unsigned char *chunk = (unsigned char *)malloc(DB_PHOTO_CHUNK);
+    int size = sqlite3_blob_bytes(blob);
+    int ok = chunk != NULL;
+
+    for (int offset = 0; ok && offset < size; offset += DB_PHOTO_CHUNK) {
+        int n = MIN(DB_PHOTO_CHUNK, size - offset);
+        if (sqlite3_blob_read(blob, chunk, n, offset) != SQLITE_OK) {
+            LOG_ERROR("Failed to read photo for student %d: %s", student_id, sqlite3_errmsg(db));
+            ok = 0;
+        } else {
+            ok = sink(chunk, n, user_data);
+        }
+    }
+
+    free(chunk);
+    sqlite3_blob_close(blob);
+    return ok;
+}
+
+int db_delete_student_photo(int student_id) {
+    DB_LATENCY_SCOPE();
+
+    if (!db) return 0;
+
+    sqlite3_stmt *stmt = db_stmt_acquire("DELETE FROM StudentPhotos WHERE student_id = ?;");
+    if (stmt == NULL) {
+        LOG_ERROR("Failed to prepare photo delete: %s", sqlite3_errmsg(db));
+        return 0;
+    }
+
+    sqlite3_bind_int(stmt, 1, student_id);
+    int ok = sqlite3_step(stmt) == SQLITE_DONE;
+    db_stmt_release(stmt);
+    return ok;
+}
@@ -0,0 +1,203 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sqlite3.h>
+#include "../../include/database.h"
+#include "../../include/logger.h"
+
+
+extern sqlite3 *db;
+
+
+// ============================================================================
+// QUERY PLAN CHECK
+//
+// Runs EXPLAIN QUERY PLAN over the application's queries and reports any
+// that read a whole table. A statement without a WHERE clause is a listing
+// and may scan, but must get its ORDER BY from an index rather than a temp
+// sort. Anything with a WHERE clause must reach its rows through an index,
+// unless its call site acquired it with db_stmt_acquire_scan() to say the
+// whole-table read is intended.
+// ============================================================================
+
+// Returns 1 if the plan is acceptable, 0 if it is a regression
+static int check_query_plan(const char *sql, int scan_ok) {
+    char explain[4096];
+    sqlite3_stmt *stmt = NULL;
+
+    if (strncmp(sql, "PRAGMA", 6) == 0) {
+        return 1;
+    }
+
+    snprintf(explain, sizeof(explain), "EXPLAIN QUERY PLAN %s", sql);
+    if (sqlite3_prepare_v2(db, explain, -1, &stmt, NULL) != SQLITE_OK) {
+        LOG_ERROR("EXPLAIN failed: %s", sqlite3_errmsg(db));
+        return 0;
+    }
+
+    int listing = strstr(sql, " WHERE ") == NULL;
+    int ok = 1;
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        const char *detail = (const char *)sqlite3_column_text(stmt, 3);
+        if (detail == NULL) {
+            continue;
+        }
+
+        // A SELECT without FROM shows as SCAN CONSTANT ROW: no table is read
+        int full_scan = strncmp(detail, "SCAN ", 5) == 0 && strstr(detail, "VIRTUAL TABLE") == NULL &&
+                        strcmp(detail, "SCAN CONSTANT ROW") != 0;
+        int temp_sort = strstr(detail, "USE TEMP B-TREE FOR ORDER BY") != NULL;
+
+        if ((full_scan && !listing && !scan_ok) || (temp_sort && listing)) {
+            if (ok) {
+                LOG_ERROR("Query plan regression:\n        %.200s", sql);
+            }
+            LOG_ERROR("  -> %s", detail);
+            ok = 0;
+        }
+    }
+
+    sqlite3_finalize(stmt);
+    return ok;
+}
+
+static int check_registry_entry(const char *sql, int scan_ok, void *ctx) {
+    int *failures = (int *)ctx;
+    if (!check_query_plan(sql, scan_ok)) {
+        (*failures)++;
+    }
+    return 1;
+}
+
+int db_check_query_plans(void) {
+    int failures = 0;
+
+    if (db == NULL) {
+        return 0;
+    }
+
+    db_stmt_foreach(check_registry_entry, &failures);
+    if (failures > 0) {
+        LOG_WARNING("%d cached quer%s fall back to a full table scan",
+                    failures, failures == 1 ? "y" : "ies");
+    }
+    return failures;
+}
+
+// Checks a statement handed out by a function whose caller owns it
+static int check_owned_statement(sqlite3_stmt *stmt, int scan_ok) {
+    if (stmt == NULL) {
+        LOG_ERROR("Query under check failed to prepare: %s", sqlite3_errmsg(db));
+        return 1;
+    }
+
+    int failed = !check_query_plan(sqlite3_sql(stmt), scan_ok);
+    sqlite3_finalize(stmt);
+    return failed;
+}
+
+int db_run_query_plan_check(void) {
+    if (db == NULL) {
+        return 1;
+    }
+
+    // Enough rows per table, plus ANALYZE, for the planner to choose the
+    // plans it would choose on a real college database
+    const char *seed =
+        "WITH RECURSIVE n(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM n WHERE i < 5000) "
+        "INSERT INTO Students (roll_no, name, gender, father_name, branch, year, semester, category, mobile, email) "
+        "SELECT printf('%013d', i), 'Student ' || i, 'Male', 'Father ' || i, "
+        "CASE i % 5 WHEN 0 THEN 'CSE' WHEN 1 THEN 'ME' WHEN 2 THEN 'EE' WHEN 3 THEN 'CE' ELSE 'IT' END, "
+        "1 + i % 4, 1 + i % 8, 'GEN', printf('9%09d', i), 's' || i || '@college.in' FROM n;"
+
+        "INSERT INTO Fees (student_id, roll_no, fee_type, paid_amount, paid_date, payment_mode, status, record_status) "
+        "SELECT student_id, roll_no, t.fee_type, 100000, '2025-07-01', 'Cash', 'Paid', 1 FROM Students, "
+        "(SELECT 'Institute' AS fee_type UNION ALL SELECT 'Hostel' UNION ALL SELECT 'Mess') t;"
+
+        "WITH RECURSIVE n(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM n WHERE i < 200) "
+        "INSERT INTO employees (emp_no, emp_name, emp_dob, department, designation, category, "
+        "reporting_person_name, reporting_person_id, email, mobile_number, address, base_salary) "
+        "SELECT 1000 + i, 'Employee ' || i, '1980-01-01', 'Dept ' || (i % 8), 'Lecturer', 'Teaching', "
+        "'Principal', 1, 'e' || i || '@college.in', printf('8%09d', i), 'Mainpuri', 4000000 FROM n;"
+
+        "WITH RECURSIVE m(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM m WHERE i < 12) "
+        "INSERT INTO payroll (emp_id, month_year, basic_salary, payment_date, payment_method, status, remarks, department) "
+        "SELECT emp_id, printf('M%02d-2025', m.i), base_salary, '2025-01-31', 'Bank Transfer', 'Paid', '', department "
+        "FROM employees, m;"
+
+        "ANALYZE;";
+
+    char *err = NULL;
+    if (sqlite3_exec(db, seed, NULL, NULL, &err) != SQLITE_OK) {
+        LOG_ERROR("Failed to seed query plan database: %s", err);
+        sqlite3_free(err);
+        return 1;
+    }
+    LOG_INFO("Seeded database for query plan check");
+
+    int failures = 0;
+    sqlite3_stmt *stmt = NULL;
+
+    // Without FTS5 the searches fall back to a '%text%' LIKE, which has to scan
+    char match[64];
+    int like_search = !db_search_match_expr("Student 42", match, sizeof(match));
+
+    // Functions that hand their statement to the caller
+    failures += check_owned_statement(db_get_all_students(), 0);
+    failures += check_owned_statement(db_search_students("Student 42"), like_search);
+    failures += check_owned_statement(db_get_students_by_branch("CSE"), 0);
+    failures += check_owned_statement(db_get_all_payroll(), 0);
+    stmt = NULL;
+    db_get_all_employees(&stmt);
+    failures += check_owned_statement(stmt, 0);
+    stmt = NULL;
+    db_search_employees("Employee 7", &stmt);
+    failures += check_owned_statement(stmt, like_search);
+
+    // Functions using the statement registry: run each once so its
+    // statements are cached, then check everything in the registry
+    Student student;
+    FeeRecord fee;
+    FeeTableRow *rows = NULL;
+    Employee employee;
+    BankDetails bank;
+    Payroll payroll;
+    StudentIDCard card;
+
+    db_search_student_by_rollno("0000000000042", &student);
+    db_get_student_count();
+    db_get_fee_record("0000000000042", &fee);
+    db_get_student_for_card_by_roll("0000000000042", &card);
+    db_get_student_card_by_id(42, &card);
+
+    if (db_get_all_fee_summary_rows(&rows) > 0) db_free_fee_table_rows(rows);
+    rows = NULL;
+    if (db_get_fee_summary_page("0000000000100", 200, &rows) > 0) db_free_fee_table_rows(rows);
+    rows = NULL;
+    if (db_search_fee_summary_by_criteria("Student 42", &rows) > 0) db_free_fee_table_rows(rows);
+    db_rebuild_fee_summary(NULL);
+
+    db_get_employee_by_id(7, &employee);
+    db_get_employee_count();
+    db_get_bank_details(7, &bank);
+    db_get_payroll(7, &payroll);
+    db_get_payroll_by_emp_month(7, "M03-2025", &payroll);
+
+    Employee *run_employees = NULL;
+    if (db_get_payroll_run_employees("M03-2025", &run_employees, NULL) >= 0) free(run_employees);
+    PayrollSummary payroll_summary;
+    db_get_payroll_summary("M03-2025", NULL, &payroll_summary);
+    db_get_payroll_summary("M03-2025", "Dept 3", &payroll_summary);
+    DashboardStats dashboard;
+    db_get_dashboard_stats("M03-2025", &dashboard);
+
+    failures += db_check_query_plans();
+
+    if (failures == 0) {
+        LOG_SUCCESS("Query plan check passed: no hot query scans a whole table");
+    } else {
+        LOG_ERROR("Query plan check failed: %d regression(s)", failures);
+    }
+    return failures;
+}
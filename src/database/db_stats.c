@@ -0,0 +1,122 @@
+#include <stdio.h>
+#include <string.h>
+#include <sqlite3.h>
+#include <glib.h>
+#include "../../include/database.h"
+#include "../../include/logger.h"
+#include "../../include/db_latency.h"
+
+
+extern sqlite3 *db;
+
+
+// ============================================================================
+// DASHBOARD STATS
+//
+// The counters are maintained by the *_stats_* triggers from migration 9,
+// so the dashboard reads two primary-key rows instead of counting tables.
+// db_stats_watch() tells it when to read them again: SQLite's update hook
+// flags a change to one of the source tables, and the first flag since the
+// last refresh queues one idle callback, however many rows a save touched.
+// ============================================================================
+
+
+static DbStatsChangedFunc stats_changed = NULL;
+static void *stats_changed_data = NULL;
+static gint stats_refresh_queued = 0;
+
+
+int db_rebuild_dashboard_stats(void) {
+    DB_LATENCY_SCOPE();
+
+    if (db == NULL) {
+        return 0;
+    }
+
+    const char *sql =
+        "INSERT OR REPLACE INTO DashboardStats (stat, value, updated_at) VALUES "
+        "('students', (SELECT COUNT(*) FROM Students), CURRENT_TIMESTAMP), "
+        "('employees', (SELECT COUNT(*) FROM employees), CURRENT_TIMESTAMP);";
+
+    char *err = NULL;
+    if (sqlite3_exec(db, sql, NULL, NULL, &err) != SQLITE_OK) {
+        LOG_ERROR("Dashboard stats rebuild failed: %s", err);
+        sqlite3_free(err);
+        return 0;
+    }
+    return 1;
+}
+
+int db_get_dashboard_stats(const char *month_year, DashboardStats *out_stats) {
+    DB_LATENCY_SCOPE();
+
+    if (db == NULL || month_year == NULL || out_stats == NULL) {
+        return 0;
+    }
+
+    const char *sql =
+        "SELECT "
+        "(SELECT value FROM DashboardStats WHERE stat = 'students'), "
+        "(SELECT value FROM DashboardStats WHERE stat = 'employees'), "
+        "(SELECT COALESCE(SUM(total_gross), 0) FROM PayrollSummary WHERE month_year = ?);";
+
+    sqlite3_stmt *stmt = db_stmt_acquire(sql);
+    if (stmt == NULL) {
+        LOG_ERROR("Failed to prepare dashboard stats query: %s", sqlite3_errmsg(db));
+        return 0;
+    }
+
+    sqlite3_bind_text(stmt, 1, month_year, -1, SQLITE_STATIC);
+
+    memset(out_stats, 0, sizeof(DashboardStats));
+
+    int ok = sqlite3_step(stmt) == SQLITE_ROW;
+    if (ok) {
+        out_stats->students = sqlite3_column_int(stmt, 0);
+        out_stats->employees = sqlite3_column_int(stmt, 1);
+        out_stats->month_payroll = sqlite3_column_int64(stmt, 2);
+    } else {
+        LOG_ERROR("Failed to read dashboard stats: %s", sqlite3_errmsg(db));
+    }
+
+    db_stmt_release(stmt);
+    return ok;
+}
+
+static gboolean stats_dispatch_changed(gpointer user_data) {
+    (void)user_data;
+
+    g_atomic_int_set(&stats_refresh_queued, 0);
+    if (stats_changed != NULL) {
+        stats_changed(stats_changed_data);
+    }
+    return G_SOURCE_REMOVE;
+}
+
+// Runs inside sqlite3_step(), once per row: no SQL here, only the flag
+static void stats_update_hook(void *user_data, int op, const char *db_name,
+                              const char *table, sqlite3_int64 rowid) {
+    (void)user_data;
+    (void)op;
+    (void)db_name;
+    (void)rowid;
+
+    if (strcmp(table, "Students") != 0 && strcmp(table, "employees") != 0 &&
+        strcmp(table, "payroll") != 0) {
+        return;
+    }
+
+    if (g_atomic_int_compare_and_exchange(&stats_refresh_queued, 0, 1)) {
+        g_idle_add(stats_dispatch_changed, NULL);
+    }
+}
+
+void db_stats_watch(DbStatsChangedFunc on_changed, void *user_data) {
+    if (db == NULL) {
+        return;
+    }
+
+    stats_changed = on_changed;
+    stats_changed_data = user_data;
+    sqlite3_update_hook(db, on_changed != NULL ? stats_update_hook : NULL, NULL);
+}
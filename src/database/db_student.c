@@ -4,89 +4,84 @@
 #include <sqlite3.h>
 #include <ctype.h> 
 #include "../../include/database.h"
+#include "../../include/logger.h"
+#include "../../include/db_latency.h"
 
 
 int db_add_student(const char *name, const char *gender, const char *father_name, 
                    const char *branch, int year, int semester, const char *roll_no, 
                    const char *category, const char *mobile, const char *email) {
+    DB_LATENCY_SCOPE();
     
     if (db == NULL) {
-        fprintf(stderr, "[ERROR] Database not initialized\n");
+        LOG_ERROR("Database not initialized");
         return -1;
     }
     if (!name || !gender || !father_name || !branch || !category || !email || !roll_no || !mobile) {
-        fprintf(stderr, "[ERROR] NULL text parameter passed to db_add_student\n");
+        LOG_ERROR("NULL text parameter passed to db_add_student");
         return -1;
     }
     if (strlen(roll_no) != 13) {
-        fprintf(stderr, "[ERROR] Roll number must be exactly 13 digits\n");
+        LOG_ERROR("Roll number must be exactly 13 digits");
         return -1;
     }
     for (int i = 0; roll_no[i]; i++) {
         if (!isdigit(roll_no[i])) {
-            fprintf(stderr, "[ERROR] Roll number must contain only digits\n");
+            LOG_ERROR("Roll number must contain only digits");
             return -1;
         }
     }
     if (strlen(mobile) != 10) {
-        fprintf(stderr, "[ERROR] Mobile must be exactly 10 digits\n");
+        LOG_ERROR("Mobile must be exactly 10 digits");
         return -1;
     }
     
     for (int i = 0; mobile[i]; i++) {
         if (!isdigit(mobile[i])) {
-            fprintf(stderr, "[ERROR] Mobile must contain only digits\n");
+            LOG_ERROR("Mobile must contain only digits");
             return -1;
         }
     }
     
     if (year < 1 || year > 4) {
-        fprintf(stderr, "[ERROR] Year must be 1-4\n");
+        LOG_ERROR("Year must be 1-4");
         return -1;
     }
 
     if (semester < 1 || semester > 8) {
-        fprintf(stderr, "[ERROR] Semester must be 1-8\n");
+        LOG_ERROR("Semester must be 1-8");
         return -1;
     }
     
-    printf("[DEBUG] Adding student: %s (Roll: %s)\n", name, roll_no);
-    printf("[DEBUG] Branch: %s, Year: %d, Sem: %d, Mobile: %s, Category: %s\n", 
-           branch, year, semester, mobile, category);
+    LOG_DEBUG("Adding student: %s (Roll: %s)", name, roll_no);
+    LOG_DEBUG("Branch: %s, Year: %d, Sem: %d, Mobile: %s, Category: %s", 
+              branch, year, semester, mobile, category);
     
     // Check for duplicate roll number using TEXT binding
     const char *check_sql = "SELECT COUNT(*) FROM students WHERE roll_no = ?;";
-    sqlite3_stmt *check_stmt = NULL;
-    
-    int result = sqlite3_prepare_v2(db, check_sql, -1, &check_stmt, NULL);
-    if (result != SQLITE_OK) {
-        fprintf(stderr, "[ERROR] Failed to prepare check statement: %s\n", sqlite3_errmsg(db));
-        return -1;
-    }
-    
+    sqlite3_stmt *check_stmt = db_stmt_acquire(check_sql);
     if (check_stmt == NULL) {
-        fprintf(stderr, "[ERROR] Check statement is NULL\n");
+        LOG_ERROR("Failed to prepare check statement: %s", sqlite3_errmsg(db));
         return -1;
     }
-    
     if (sqlite3_bind_text(check_stmt, 1, roll_no, -1, SQLITE_STATIC) != SQLITE_OK) {
-        fprintf(stderr, "[ERROR] Failed to bind roll_no in check query\n");
-        sqlite3_finalize(check_stmt);
+        LOG_ERROR("Failed to bind roll_no in check query");
+        db_stmt_release(check_stmt);
         return -1;
     }
     
     if (sqlite3_step(check_stmt) == SQLITE_ROW) {
         int count = sqlite3_column_int(check_stmt, 0);
-        sqlite3_finalize(check_stmt);
+        db_stmt_release(check_stmt);
         check_stmt = NULL;
         
         if (count > 0) {
-            fprintf(stderr, "[ERROR] Roll number %s already exists\n", roll_no);
+            LOG_ERROR("Roll number %s already exists", roll_no);
             return -1;
         }
     } else {
-        fprintf(stderr, "[ERROR] Failed to check existing roll number\n");
-        sqlite3_finalize(check_stmt);
+        LOG_ERROR("Failed to check existing roll number");
+        db_stmt_release(check_stmt);
         return -1;
     }
     
@@ -96,128 +91,131 @@ int db_add_student(const char *name, const char *gender, const char *father_name
         "roll_no, category, mobile, email) "
         "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?);";
 
-    sqlite3_stmt *stmt = NULL;
-    result = sqlite3_prepare_v2(db, sql, -1, &stmt, NULL);
-    
-    if (result != SQLITE_OK) {
-        fprintf(stderr, "[ERROR] SQL prepare error: %s\n", sqlite3_errmsg(db));
-        if (stmt != NULL) sqlite3_finalize(stmt);
-        return -1;
-    }
-    
+    sqlite3_stmt *stmt = db_stmt_acquire(sql);
+
     if (stmt == NULL) {
-        fprintf(stderr, "[ERROR] Statement is NULL after prepare\n");
+        LOG_ERROR("SQL prepare error: %s", sqlite3_errmsg(db));
         return -1;
     }
     
     // Parameter binding (10 parameters, indices adjusted after photo removal)
     if (sqlite3_bind_text(stmt, 1, name, -1, SQLITE_STATIC) != SQLITE_OK) {
-        fprintf(stderr, "[ERROR] Failed to bind name\n");
-        sqlite3_finalize(stmt);
+        LOG_ERROR("Failed to bind name");
+        db_stmt_release(stmt);
         return -1;
     }
     
     if (sqlite3_bind_text(stmt, 2, gender, -1, SQLITE_STATIC) != SQLITE_OK) {
-        fprintf(stderr, "[ERROR] Failed to bind gender\n");
-        sqlite3_finalize(stmt);
+        LOG_ERROR("Failed to bind gender");
+        db_stmt_release(stmt);
         return -1;
     }
     
     if (sqlite3_bind_text(stmt, 3, father_name, -1, SQLITE_STATIC) != SQLITE_OK) {
-        fprintf(stderr, "[ERROR] Failed to bind father_name\n");
-        sqlite3_finalize(stmt);
+        LOG_ERROR("Failed to bind father_name");
+        db_stmt_release(stmt);
         return -1;
     }
     
     if (sqlite3_bind_text(stmt, 4, branch, -1, SQLITE_STATIC) != SQLITE_OK) {
-        fprintf(stderr, "[ERROR] Failed to bind branch\n");
-        sqlite3_finalize(stmt);
+        LOG_ERROR("Failed to bind branch");
+        db_stmt_release(stmt);
         return -1;
     }
     
     if (sqlite3_bind_int(stmt, 5, year) != SQLITE_OK) {
-        fprintf(stderr, "[ERROR] Failed to bind year\n");
-        sqlite3_finalize(stmt);
+        LOG_ERROR("Failed to bind year");
+        db_stmt_release(stmt);
         return -1;
     }
     
     if (sqlite3_bind_int(stmt, 6, semester) != SQLITE_OK) {
-        fprintf(stderr, "[ERROR] Failed to bind semester\n");
-        sqlite3_finalize(stmt);
+        LOG_ERROR("Failed to bind semester");
+        db_stmt_release(stmt);
         return -1;
     }
     
     if (sqlite3_bind_text(stmt, 7, roll_no, -1, SQLITE_STATIC) != SQLITE_OK) {
-        fprintf(stderr, "[ERROR] Failed to bind roll_no\n");
-        sqlite3_finalize(stmt);
+        LOG_ERROR("Failed to bind roll_no");
+        db_stmt_release(stmt);
         return -1;
     }
     
     if (sqlite3_bind_text(stmt, 8, category, -1, SQLITE_STATIC) != SQLITE_OK) {
-        fprintf(stderr, "[ERROR] Failed to bind category\n");
-        sqlite3_finalize(stmt);
+        LOG_ERROR("Failed to bind category");
+        db_stmt_release(stmt);
         return -1;
     }
     
     if (sqlite3_bind_text(stmt, 9, mobile, -1, SQLITE_STATIC) != SQLITE_OK) {
-        fprintf(stderr, "[ERROR] Failed to bind mobile\n");
-        sqlite3_finalize(stmt);
+        LOG_ERROR("Failed to bind mobile");
+        db_stmt_release(stmt);
         return -1;
     }
     
     if (sqlite3_bind_text(stmt, 10, email, -1, SQLITE_STATIC) != SQLITE_OK) {
-        fprintf(stderr, "[ERROR] Failed to bind email\n");
-        sqlite3_finalize(stmt);
+        LOG_ERROR("Failed to bind email");
+        db_stmt_release(stmt);
         return -1;
     }
     
-    printf("[DEBUG] Executing INSERT statement\n");
+    LOG_DEBUG("Executing INSERT statement");
     
-    result = sqlite3_step(stmt);
+    int result = sqlite3_step(stmt);
     
     if (result != SQLITE_DONE) {
-        fprintf(stderr, "[ERROR] Failed to insert student: %s (code: %d)\n", 
-                sqlite3_errmsg(db), result);
-        sqlite3_finalize(stmt);
+        LOG_ERROR("Failed to insert student: %s (code: %d)", 
+                  sqlite3_errmsg(db), result);
+        db_stmt_release(stmt);
         return -1;
     }
     
     sqlite3_int64 last_id = sqlite3_last_insert_rowid(db);
     int student_id = (int)last_id;
     
-    printf("[DEBUG] Last insert ID: %d\n", student_id);
+    LOG_DEBUG("Last insert ID: %d", student_id);
     
-    sqlite3_finalize(stmt);
+    db_stmt_release(stmt);
     
-    printf("[SUCCESS] Student added with ID: %d, Roll: %s, Name: %s, Mobile: %s\n", 
-           student_id, roll_no, name, mobile);
+    LOG_SUCCESS("Student added with ID: %d, Roll: %s, Name: %s, Mobile: %s", 
+                student_id, roll_no, name, mobile);
     return student_id;
 }
 
 
 // Keep other functions unchanged...
 int db_get_student(int student_id, Student *student) {
+    DB_LATENCY_SCOPE();
+
     (void)student_id;
     (void)student;
     return -1;
 }
 
 
+// Student list, newest first; also run by the background loader
+const char db_student_list_sql[] =
+    "SELECT student_id, roll_no, name, gender, father_name, branch, "
+    "year, semester, category, mobile, email "
+    "FROM students ORDER BY student_id DESC;";
+
+// Only the columns the search index keys on (student_index.c)
+const char db_student_index_sql[] =
+    "SELECT student_id, roll_no, name, mobile FROM students;";
+
 sqlite3_stmt* db_get_all_students() {
+    DB_LATENCY_SCOPE();
+
     if (db == NULL) {
-        fprintf(stderr, "[ERROR] Database not initialized\n");
+        LOG_ERROR("Database not initialized");
         return NULL;
     }
     
-    const char *sql =
-        "SELECT student_id, roll_no, name, gender, father_name, branch, "
-        "year, semester, category, mobile, email "
-        "FROM students ORDER BY student_id DESC;";
     sqlite3_stmt *stmt = NULL;
     
-    int result = sqlite3_prepare_v2(db, sql, -1, &stmt, NULL);
+    int result = sqlite3_prepare_v2(db, db_student_list_sql, -1, &stmt, NULL);
     if (result != SQLITE_OK) {
-        fprintf(stderr, "[ERROR] Failed to prepare statement: %s\n", sqlite3_errmsg(db));
+        LOG_ERROR("Failed to prepare statement: %s", sqlite3_errmsg(db));
         return NULL;
     }
     
@@ -225,9 +223,66 @@ sqlite3_stmt* db_get_all_students() {
 }
 
 
+// Ranked search over name, roll_no, branch, father_name and mobile.
+// Same columns as db_get_all_students(); caller steps and finalizes.
+sqlite3_stmt* db_search_students(const char *text) {
+    DB_LATENCY_SCOPE();
+
+    if (db == NULL || text == NULL) {
+        LOG_ERROR("Database not initialized");
+        return NULL;
+    }
+
+    char match[256];
+    sqlite3_stmt *stmt = NULL;
+    int result;
+
+    if (db_search_match_expr(text, match, sizeof(match))) {
+        // bm25 weights: roll_no and name hits rank above branch/father_name
+        const char *sql =
+            "SELECT s.student_id, s.roll_no, s.name, s.gender, s.father_name, s.branch, "
+            "s.year, s.semester, s.category, s.mobile, s.email "
+            "FROM StudentSearch "
+            "JOIN students s ON s.student_id = StudentSearch.rowid "
+            "WHERE StudentSearch MATCH ? "
+            "ORDER BY bm25(StudentSearch, 5.0, 10.0, 1.0, 2.0, 5.0), s.roll_no;";
+
+        result = sqlite3_prepare_v2(db, sql, -1, &stmt, NULL);
+        if (result == SQLITE_OK) {
+            sqlite3_bind_text(stmt, 1, match, -1, SQLITE_TRANSIENT);
+        }
+    } else {
+        const char *sql =
+            "SELECT student_id, roll_no, name, gender, father_name, branch, "
+            "year, semester, category, mobile, email "
+            "FROM students "
+            "WHERE name LIKE ?1 OR roll_no LIKE ?1 OR branch LIKE ?1 "
+            "OR father_name LIKE ?1 OR mobile LIKE ?1 "
+            "ORDER BY roll_no;";
+
+        char pattern[256];
+        snprintf(pattern, sizeof(pattern), "%%%s%%", text);
+
+        result = sqlite3_prepare_v2(db, sql, -1, &stmt, NULL);
+        if (result == SQLITE_OK) {
+            sqlite3_bind_text(stmt, 1, pattern, -1, SQLITE_TRANSIENT);
+        }
+    }
+
+    if (result != SQLITE_OK) {
+        LOG_ERROR("Failed to prepare search: %s", sqlite3_errmsg(db));
+        return NULL;
+    }
+
+    return stmt;
+}
+
+
 int db_edit_student(int student_id, const Student *student) {
+    DB_LATENCY_SCOPE();
+
     if (!db || !student) {
-        fprintf(stderr, "[ERROR] Invalid db or student pointer\n");
+        LOG_ERROR("Invalid db or student pointer");
         return -1;
     }
 
@@ -239,8 +294,10 @@ int db_edit_student(int student_id, const Student *student) {
 
     sqlite3_stmt *stmt = NULL;
 
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
-        fprintf(stderr, "[ERROR] Prepare failed: %s\n", sqlite3_errmsg(db));
+    stmt = db_stmt_acquire(sql);
+
+    if (stmt == NULL) {
+        LOG_ERROR("Prepare failed: %s", sqlite3_errmsg(db));
         return -1;
     }
 
@@ -258,39 +315,45 @@ int db_edit_student(int student_id, const Student *student) {
     sqlite3_bind_int(stmt, 11, student_id);
 
     if (sqlite3_step(stmt) != SQLITE_DONE) {
-        fprintf(stderr, "[ERROR] Update failed: %s\n", sqlite3_errmsg(db));
-        sqlite3_finalize(stmt);
+        LOG_ERROR("Update failed: %s", sqlite3_errmsg(db));
+        db_stmt_release(stmt);
         return -1;
     }
 
-    sqlite3_finalize(stmt);
+    db_stmt_release(stmt);
     return 0;
 }
 
 
 int db_delete_student(int student_id) {
+    DB_LATENCY_SCOPE();
+
     if (!db) return -1;
 
     const char *sql = "DELETE FROM students WHERE student_id = ?;";
     sqlite3_stmt *stmt = NULL;
 
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK)
+    stmt = db_stmt_acquire(sql);
+
+    if (stmt == NULL)
         return -1;
 
     sqlite3_bind_int(stmt, 1, student_id);
 
     if (sqlite3_step(stmt) != SQLITE_DONE) {
-        fprintf(stderr, "[ERROR] Delete failed: %s\n", sqlite3_errmsg(db));
-        sqlite3_finalize(stmt);
+        LOG_ERROR("Delete failed: %s", sqlite3_errmsg(db));
+        db_stmt_release(stmt);
         return -1;
     }
 
-    sqlite3_finalize(stmt);
+    db_stmt_release(stmt);
     return 0;
 }
 
 
 int db_search_student_by_rollno(const char *roll_no, Student *student) {
+    DB_LATENCY_SCOPE();
+
     if (!db || !roll_no || !student)
         return -1;
 
@@ -301,13 +364,15 @@ int db_search_student_by_rollno(const char *roll_no, Student *student) {
 
     sqlite3_stmt *stmt = NULL;
 
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK)
+    stmt = db_stmt_acquire(sql);
+
+    if (stmt == NULL)
         return -1;
 
     sqlite3_bind_text(stmt, 1, roll_no, -1, SQLITE_STATIC);
 
     if (sqlite3_step(stmt) != SQLITE_ROW) {
-        sqlite3_finalize(stmt);
+        db_stmt_release(stmt);
         return -1;  // Not found
     }
 
@@ -324,12 +389,14 @@ int db_search_student_by_rollno(const char *roll_no, Student *student) {
     strcpy(student->mobile, (const char *)sqlite3_column_text(stmt, 9));
     strcpy(student->email, (const char *)sqlite3_column_text(stmt, 10));
 
-    sqlite3_finalize(stmt);
+    db_stmt_release(stmt);
     return 0;
 }
 
 
 sqlite3_stmt* db_get_students_by_branch(const char *branch) {
+    DB_LATENCY_SCOPE();
+
     if (!db || !branch) return NULL;
 
     const char *sql =
@@ -348,16 +415,20 @@ sqlite3_stmt* db_get_students_by_branch(const char *branch) {
 
 
 int db_get_student_count() {
+    DB_LATENCY_SCOPE();
+
     if (db == NULL) {
-        printf("[ERROR] Database not connected\n");
+        LOG_ERROR("Database not connected");
         return 0;
     }
     
     const char *sql = "SELECT COUNT(*) FROM students";
     sqlite3_stmt *stmt;
     
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
-        printf("[ERROR] Failed to prepare count statement: %s\n", sqlite3_errmsg(db));
+    stmt = db_stmt_acquire(sql);
+    
+    if (stmt == NULL) {
+        LOG_ERROR("Failed to prepare count statement: %s", sqlite3_errmsg(db));
         return 0;
     }
     
@@ -366,7 +437,7 @@ int db_get_student_count() {
         count = sqlite3_column_int(stmt, 0);
     }
     
-    sqlite3_finalize(stmt);
-    printf("[INFO] Total students in database: %d\n", count);
+    db_stmt_release(stmt);
+    LOG_INFO("Total students in database: %d", count);
     return count;
 }
\ No newline at end of file
@@ -0,0 +1,356 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sqlite3.h>
+#include <glib.h>
+#include "../../include/database.h"
+#include "../../include/validators.h"
+#include "../../include/logger.h"
+#include "../../include/db_latency.h"
+
+
+extern sqlite3 *db;
+
+
+// ============================================================================
+// STUDENT ADMISSION IMPORT
+//
+// Streams an admission list into Students, one student per line:
+//
+//     roll_no,name,gender,father_name,branch,year,semester,category,mobile,email
+//
+// Lines may be comma- or tab-separated; the first line decides which. A
+// first line starting with "roll_no" is treated as a header.
+//
+// The file is read a batch at a time. Each batch is validated in parallel
+// with the same validators the Add Student form uses, then inserted in
+// file order inside one transaction. Duplicate roll numbers within the
+// file are caught by an in-memory set; ones already in the database by
+// the UNIQUE index on the insert itself, so each row costs one statement.
+// Rejected lines are copied, with the reason appended, to
+// <file>.rejected.csv (or .tsv) so they can be fixed and re-fed.
+// ============================================================================
+
+#define ADMISSION_LINE_MAX      1024
+#define ADMISSION_FIELDS        10
+#define ADMISSION_SLICE_SIZE    256     // rows per validation task
+#define ADMISSION_REJECT_LOG    20      // per-line rejection messages per batch
+
+enum {
+    ADMISSION_ROLL_NO,
+    ADMISSION_NAME,
+    ADMISSION_GENDER,
+    ADMISSION_FATHER_NAME,
+    ADMISSION_BRANCH,
+    ADMISSION_YEAR,
+    ADMISSION_SEMESTER,
+    ADMISSION_CATEGORY,
+    ADMISSION_MOBILE,
+    ADMISSION_EMAIL
+};
+
+typedef struct {
+    int line_no;
+    int truncated;
+    char line[ADMISSION_LINE_MAX];      // split in place by the validator
+    char raw[ADMISSION_LINE_MAX];       // as read, for the rejects file
+    char *fields[ADMISSION_FIELDS];
+    const char *reason;                 // NULL if the row is valid
+} AdmissionRow;
+
+typedef struct {
+    AdmissionRow *rows;
+    int count;
+    char delimiter;
+} AdmissionBatch;
+
+
+// Returns NULL if the row is valid, otherwise the rejection reason.
+// Touches nothing but the row, so batches validate on any thread.
+static const char* validate_admission_row(AdmissionRow *row, char delimiter) {
+    if (row->truncated) {
+        return "line too long";
+    }
+
+    int field_count = db_split_import_line(row->line, delimiter, row->fields, ADMISSION_FIELDS);
+    char **f = row->fields;
+
+    if (field_count < ADMISSION_FIELDS) {
+        return "expected 10 fields";
+    }
+    if (!validate_roll_no(f[ADMISSION_ROLL_NO])) {
+        return "roll number must be 13 digits";
+    }
+    if (!validate_name(f[ADMISSION_NAME])) {
+        return "invalid name";
+    }
+    if (!validate_gender(f[ADMISSION_GENDER])) {
+        return "invalid gender";
+    }
+    if (!validate_name(f[ADMISSION_FATHER_NAME])) {
+        return "invalid father's name";
+    }
+    if (!validate_branch(f[ADMISSION_BRANCH])) {
+        return "unknown branch";
+    }
+    if (!validate_year(f[ADMISSION_YEAR])) {
+        return "year must be 1-4";
+    }
+    if (!validate_semester(f[ADMISSION_SEMESTER])) {
+        return "semester must be 1-8";
+    }
+    if (!validate_category(f[ADMISSION_CATEGORY])) {
+        return "unknown category";
+    }
+    if (!validate_mobile(f[ADMISSION_MOBILE])) {
+        return "mobile must be 10 digits starting with 6-9";
+    }
+    if (!validate_email(f[ADMISSION_EMAIL])) {
+        return "invalid email";
+    }
+    return NULL;
+}
+
+// GThreadPool worker: data is the index of the slice's first row + 1
+// (the pool does not accept NULL)
+static void admission_validate_slice(gpointer data, gpointer user_data) {
+    AdmissionBatch *batch = (AdmissionBatch *)user_data;
+    int first = GPOINTER_TO_INT(data) - 1;
+    int last = MIN(first + ADMISSION_SLICE_SIZE, batch->count);
+
+    for (int i = first; i < last; i++) {
+        batch->rows[i].reason = validate_admission_row(&batch->rows[i], batch->delimiter);
+    }
+}
+
+static int admission_validate_batch(AdmissionBatch *batch) {
+    int slices = (batch->count + ADMISSION_SLICE_SIZE - 1) / ADMISSION_SLICE_SIZE;
+    int threads = MAX(1, MIN((int)g_get_num_processors(), slices));
+    GError *error = NULL;
+
+    GThreadPool *pool = g_thread_pool_new(admission_validate_slice, batch, threads, TRUE, &error);
+    if (pool == NULL) {
+        LOG_ERROR("Failed to start validation workers: %s", error->message);
+        g_error_free(error);
+        return 0;
+    }
+
+    for (int first = 0; first < batch->count; first += ADMISSION_SLICE_SIZE) {
+        g_thread_pool_push(pool, GINT_TO_POINTER(first + 1), NULL);
+    }
+
+    // Waits for every queued slice
+    g_thread_pool_free(pool, FALSE, TRUE);
+    return 1;
+}
+
+// Reads up to max non-blank lines, skipping a header on line 1. The first
+// line read also settles the delimiter. Returns the number of rows read.
+static int admission_read_batch(FILE *in, AdmissionRow *rows, int max, int *line_no, char *delimiter) {
+    int count = 0;
+
+    while (count < max) {
+        AdmissionRow *row = &rows[count];
+        if (fgets(row->line, sizeof(row->line), in) == NULL) {
+            break;
+        }
+        (*line_no)++;
+
+        size_t len = strlen(row->line);
+        row->truncated = len == sizeof(row->line) - 1 && row->line[len - 1] != '\n';
+        if (row->truncated) {
+            int c;
+            while ((c = fgetc(in)) != EOF && c != '\n') { }
+        }
+        row->line[strcspn(row->line, "\r\n")] = '\0';
+
+        if (*line_no == 1) {
+            *delimiter = strchr(row->line, '\t') != NULL ? '\t' : ',';
+            if (g_ascii_strncasecmp(row->line, "roll_no", 7) == 0) {
+                continue;
+            }
+        }
+        if (row->line[0] == '\0') {
+            continue;
+        }
+
+        row->line_no = *line_no;
+        row->reason = NULL;
+        g_strlcpy(row->raw, row->line, sizeof(row->raw));
+        count++;
+    }
+
+    return count;
+}
+
+static void report_admission_batch(int batch_no, int first_line, int last_line, int accepted, int rejected,
+                                   gint64 started_us) {
+    double seconds = (g_get_monotonic_time() - started_us) / 1e6;
+    int processed = accepted + rejected;
+
+    LOG_INFO("Batch %d: lines %d-%d, %d accepted, %d rejected, %.0f rows/s",
+             batch_no, first_line, last_line, accepted, rejected,
+             seconds > 0 ? processed / seconds : 0.0);
+}
+
+
+int db_import_students(const char *path, int batch_size, StudentImportStats *out_stats) {
+    DB_LATENCY_SCOPE();
+
+    if (!db || !path) return 0;
+
+    if (batch_size <= 0) {
+        batch_size = STUDENT_IMPORT_DEFAULT_BATCH;
+    }
+
+    StudentImportStats stats;
+    memset(&stats, 0, sizeof(stats));
+    if (out_stats) {
+        *out_stats = stats;
+    }
+
+    FILE *in = fopen(path, "r");
+    if (in == NULL) {
+        LOG_ERROR("Cannot open admission file: %s", path);
+        return 0;
+    }
+
+    AdmissionRow *rows = (AdmissionRow *)malloc(batch_size * sizeof(AdmissionRow));
+    if (rows == NULL) {
+        LOG_ERROR("Memory allocation failed");
+        fclose(in);
+        return 0;
+    }
+
+    // Same text as db_add_student(), so both share one prepared statement
+    const char *insert_sql =
+        "INSERT INTO students (name, gender, father_name, branch, year, semester, "
+        "roll_no, category, mobile, email) "
+        "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?);";
+
+    sqlite3_stmt *stmt = db_stmt_acquire(insert_sql);
+    if (stmt == NULL) {
+        LOG_ERROR("Failed to prepare admission insert: %s", sqlite3_errmsg(db));
+        free(rows);
+        fclose(in);
+        return 0;
+    }
+
+    LOG_INFO("Importing admissions from %s (batch size %d)", path, batch_size);
+
+    // Roll numbers accepted so far in this file
+    GHashTable *seen = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+    char reject_path[512];
+    FILE *rejects = NULL;
+    char delimiter = ',';
+    int line_no = 0;
+    int ok = 1;
+    gint64 import_started = g_get_monotonic_time();
+
+    AdmissionBatch batch = { rows, 0, ',' };
+
+    while (ok && (batch.count = admission_read_batch(in, rows, batch_size, &line_no, &delimiter)) > 0) {
+        gint64 batch_started = g_get_monotonic_time();
+        int batch_accepted = 0;
+        int batch_rejected = 0;
+
+        batch.delimiter = delimiter;
+        if (!admission_validate_batch(&batch) || !db_begin_transaction()) {
+            ok = 0;
+            break;
+        }
+
+        for (int i = 0; i < batch.count; i++) {
+            AdmissionRow *row = &rows[i];
+            char **f = row->fields;
+
+            if (row->reason == NULL && g_hash_table_contains(seen, f[ADMISSION_ROLL_NO])) {
+                row->reason = "duplicate roll number in file";
+                stats.duplicates++;
+            }
+
+            if (row->reason == NULL) {
+                sqlite3_bind_text(stmt, 1, f[ADMISSION_NAME], -1, SQLITE_STATIC);
+                sqlite3_bind_text(stmt, 2, f[ADMISSION_GENDER], -1, SQLITE_STATIC);
+                sqlite3_bind_text(stmt, 3, f[ADMISSION_FATHER_NAME], -1, SQLITE_STATIC);
+                sqlite3_bind_text(stmt, 4, f[ADMISSION_BRANCH], -1, SQLITE_STATIC);
+                sqlite3_bind_int(stmt, 5, atoi(f[ADMISSION_YEAR]));
+                sqlite3_bind_int(stmt, 6, atoi(f[ADMISSION_SEMESTER]));
+                sqlite3_bind_text(stmt, 7, f[ADMISSION_ROLL_NO], -1, SQLITE_STATIC);
+                sqlite3_bind_text(stmt, 8, f[ADMISSION_CATEGORY], -1, SQLITE_STATIC);
+                sqlite3_bind_text(stmt, 9, f[ADMISSION_MOBILE], -1, SQLITE_STATIC);
+                sqlite3_bind_text(stmt, 10, f[ADMISSION_EMAIL], -1, SQLITE_STATIC);
+
+                int rc = sqlite3_step(stmt);
+                sqlite3_reset(stmt);
+
+                if (rc == SQLITE_CONSTRAINT) {
+                    row->reason = "roll number already exists";
+                    stats.duplicates++;
+                } else if (rc != SQLITE_DONE) {
+                    LOG_ERROR("Student insert failed at line %d: %s", row->line_no, sqlite3_errmsg(db));
+                    ok = 0;
+                    break;
+                } else {
+                    g_hash_table_add(seen, g_strdup(f[ADMISSION_ROLL_NO]));
+                    batch_accepted++;
+                }
+            }
+
+            if (row->reason != NULL) {
+                batch_rejected++;
+                if (batch_rejected <= ADMISSION_REJECT_LOG) {
+                    LOG_WARNING("Line %d rejected: %s", row->line_no, row->reason);
+                }
+                if (rejects == NULL) {
+                    snprintf(reject_path, sizeof(reject_path), "%s.rejected.%s",
+                             path, delimiter == '\t' ? "tsv" : "csv");
+                    rejects = fopen(reject_path, "w");
+                }
+                if (rejects != NULL) {
+                    fprintf(rejects, "%s%c\"%s\"\n", row->raw, delimiter, row->reason);
+                }
+            }
+        }
+
+        if (!ok) {
+            db_rollback_transaction();
+        } else if (!db_commit_transaction()) {
+            ok = 0;
+        }
+        if (!ok) {
+            LOG_ERROR("Batch starting at line %d rolled back", rows[0].line_no);
+            break;
+        }
+
+        stats.batches++;
+        stats.accepted += batch_accepted;
+        stats.rejected += batch_rejected;
+        report_admission_batch(stats.batches, rows[0].line_no, rows[batch.count - 1].line_no,
+                               batch_accepted, batch_rejected, batch_started);
+    }
+
+    db_stmt_release(stmt);
+    g_hash_table_destroy(seen);
+    free(rows);
+    fclose(in);
+    if (rejects != NULL) {
+        fclose(rejects);
+    }
+
+    stats.lines = line_no;
+    stats.seconds = (g_get_monotonic_time() - import_started) / 1e6;
+
+    LOG_INFO("Admission import %s: %d accepted, %d rejected (%d duplicate) in %d batch(es), %.2fs (%.0f rows/s)",
+             ok ? "complete" : "stopped", stats.accepted, stats.rejected, stats.duplicates, stats.batches,
+             stats.seconds, stats.seconds > 0 ? (stats.accepted + stats.rejected) / stats.seconds : 0.0);
+    if (stats.rejected > 0) {
+        LOG_INFO("Rejected lines written to %s", reject_path);
+    }
+
+    if (out_stats) {
+        *out_stats = stats;
+    }
+    return ok;
+}
@@ -0,0 +1,401 @@
+#include <stdio.h>
+#include <string.h>
+#include <sqlite3.h>
+#include <gtk/gtk.h>
+#include "../../include/database.h"
+#include "../../include/db_async.h"
+#include "../../include/db_tree_model.h"
+#include "../../include/logger.h"
+
+
+// ============================================================================
+// VIRTUAL TABLE MODEL
+//
+// Row i lives on page i / DB_TREE_MODEL_PAGE_ROWS. A page is read with the
+// listing query plus LIMIT/OFFSET, through the statement registry, on the
+// main connection; iterators carry only the row index. Cached pages sit in
+// a hash table keyed by page number and in an LRU queue, most recent first.
+//
+// With a keyset query, the last key of every page read is kept (evicted or
+// not). A page whose preceding page's key is known is read by seeking past
+// that key, so reading down through the table, or re-reading an evicted
+// page, costs one index seek per page. Only a page with no known predecessor,
+// i.e. a jump by row index into unread territory, falls back to OFFSET:
+// a row index carries no key to seek to.
+// ============================================================================
+
+typedef struct {
+    int number;
+    DbAsyncChunk *rows;
+    GList *link;                    // this page's node in lru
+} DbTreeModelPage;
+
+struct _DbTreeModel {
+    GObject parent_instance;
+
+    char *page_sql;                 // sql + LIMIT :page_rows OFFSET :page_offset
+    char *keyset_sql;               // page after :after_key, or NULL
+    int key_column;
+    GPtrArray *page_keys;           // page number -> its last key, NULL if unread
+    char *count_sql;
+    char **params;
+    int n_columns;
+    GType *column_types;
+    DbTreeModelValueFunc value_func;
+    gpointer user_data;
+
+    int n_rows;
+    gint stamp;
+
+    GHashTable *pages;              // page number -> DbTreeModelPage*
+    GQueue lru;                     // DbTreeModelPage*, most recent at the head
+    unsigned long page_reads;
+};
+
+typedef struct {
+    DbTreeModel *model;
+    DbTreeModelReadyFunc on_ready;
+    gpointer user_data;
+    int count;
+} DbTreeModelLoad;
+
+static void db_tree_model_tree_model_init(GtkTreeModelIface *iface);
+
+G_DEFINE_TYPE_WITH_CODE(DbTreeModel, db_tree_model, G_TYPE_OBJECT,
+                        G_IMPLEMENT_INTERFACE(GTK_TYPE_TREE_MODEL, db_tree_model_tree_model_init))
+
+
+static void db_tree_model_page_free(gpointer data) {
+    DbTreeModelPage *page = (DbTreeModelPage *)data;
+    db_async_chunk_free(page->rows);
+    g_free(page);
+}
+
+static void db_tree_model_finalize(GObject *object) {
+    DbTreeModel *model = DB_TREE_MODEL(object);
+
+    if (model->page_reads > 0) {
+        LOG_INFO("Table model released after %lu page reads (%d rows)",
+                 model->page_reads, model->n_rows);
+    }
+
+    g_queue_clear(&model->lru);
+    g_hash_table_destroy(model->pages);
+    g_free(model->page_sql);
+    g_free(model->keyset_sql);
+    g_ptr_array_free(model->page_keys, TRUE);
+    g_free(model->count_sql);
+    g_strfreev(model->params);
+    g_free(model->column_types);
+
+    G_OBJECT_CLASS(db_tree_model_parent_class)->finalize(object);
+}
+
+static void db_tree_model_class_init(DbTreeModelClass *klass) {
+    G_OBJECT_CLASS(klass)->finalize = db_tree_model_finalize;
+}
+
+static void db_tree_model_init(DbTreeModel *model) {
+    model->stamp = (gint)g_random_int();
+    model->pages = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, db_tree_model_page_free);
+    model->page_keys = g_ptr_array_new_with_free_func(g_free);
+    g_queue_init(&model->lru);
+}
+
+
+// ============================================================================
+// PAGE CACHE
+// ============================================================================
+
+// Last key of page number, or NULL if it has not been read
+static const char* db_tree_model_page_key(DbTreeModel *model, int number) {
+    if (number < 0 || number >= (int)model->page_keys->len) {
+        return NULL;
+    }
+    return g_ptr_array_index(model->page_keys, number);
+}
+
+static void db_tree_model_remember_key(DbTreeModel *model, int number, const DbAsyncChunk *rows) {
+    const char *key = rows->n_rows > 0 ? db_async_text(rows, rows->n_rows - 1, model->key_column) : NULL;
+    if (key == NULL) {
+        return;
+    }
+
+    if ((int)model->page_keys->len <= number) {
+        g_ptr_array_set_size(model->page_keys, number + 1);
+    }
+    g_free(g_ptr_array_index(model->page_keys, number));
+    g_ptr_array_index(model->page_keys, number) = g_strdup(key);
+}
+
+static DbAsyncChunk* db_tree_model_read_page(DbTreeModel *model, int number) {
+    const char *after_key = model->keyset_sql != NULL ? db_tree_model_page_key(model, number - 1) : NULL;
+
+    sqlite3_stmt *stmt = db_stmt_acquire(after_key != NULL ? model->keyset_sql : model->page_sql);
+    if (stmt == NULL) {
+        LOG_ERROR("Failed to prepare table page query: %s", db_get_error());
+        return NULL;
+    }
+
+    for (int i = 0; model->params != NULL && model->params[i] != NULL; i++) {
+        sqlite3_bind_text(stmt, i + 1, model->params[i], -1, SQLITE_STATIC);
+    }
+    if (after_key != NULL) {
+        sqlite3_bind_text(stmt, sqlite3_bind_parameter_index(stmt, ":after_key"), after_key, -1, SQLITE_STATIC);
+    } else {
+        sqlite3_bind_int64(stmt, sqlite3_bind_parameter_index(stmt, ":page_offset"),
+                           (sqlite3_int64)number * DB_TREE_MODEL_PAGE_ROWS);
+    }
+    sqlite3_bind_int(stmt, sqlite3_bind_parameter_index(stmt, ":page_rows"), DB_TREE_MODEL_PAGE_ROWS);
+
+    DbAsyncChunk *rows = db_async_chunk_read(stmt, DB_TREE_MODEL_PAGE_ROWS);
+
+    db_stmt_release(stmt);
+    model->page_reads++;
+
+    if (rows != NULL && model->keyset_sql != NULL) {
+        db_tree_model_remember_key(model, number, rows);
+    }
+    return rows;
+}
+
+// Returns the page holding row, reading it (and evicting the least recently
+// used page) on a miss
+static DbTreeModelPage* db_tree_model_get_page(DbTreeModel *model, int row) {
+    int number = row / DB_TREE_MODEL_PAGE_ROWS;
+    DbTreeModelPage *page = g_hash_table_lookup(model->pages, GINT_TO_POINTER(number));
+
+    if (page != NULL) {
+        if (page->link != model->lru.head) {
+            g_queue_unlink(&model->lru, page->link);
+            g_queue_push_head_link(&model->lru, page->link);
+        }
+        return page;
+    }
+
+    DbAsyncChunk *rows = db_tree_model_read_page(model, number);
+    if (rows == NULL) {
+        return NULL;
+    }
+
+    if (g_queue_get_length(&model->lru) >= DB_TREE_MODEL_CACHED_PAGES) {
+        DbTreeModelPage *oldest = g_queue_pop_tail(&model->lru);
+        g_hash_table_remove(model->pages, GINT_TO_POINTER(oldest->number));
+    }
+
+    page = g_new0(DbTreeModelPage, 1);
+    page->number = number;
+    page->rows = rows;
+    g_queue_push_head(&model->lru, page);
+    page->link = model->lru.head;
+    g_hash_table_insert(model->pages, GINT_TO_POINTER(number), page);
+    return page;
+}
+
+
+// ============================================================================
+// GtkTreeModel INTERFACE
+// A flat list; an iterator's user_data is its row index.
+// ============================================================================
+
+static gboolean db_tree_model_set_iter(DbTreeModel *model, GtkTreeIter *iter, int row) {
+    if (row < 0 || row >= model->n_rows) {
+        iter->stamp = 0;
+        return FALSE;
+    }
+    iter->stamp = model->stamp;
+    iter->user_data = GINT_TO_POINTER(row);
+    return TRUE;
+}
+
+static int db_tree_model_iter_row(GtkTreeIter *iter) {
+    return GPOINTER_TO_INT(iter->user_data);
+}
+
+static GtkTreeModelFlags db_tree_model_get_flags(GtkTreeModel *tree_model) {
+    (void)tree_model;
+    return GTK_TREE_MODEL_LIST_ONLY | GTK_TREE_MODEL_ITERS_PERSIST;
+}
+
+static gint db_tree_model_get_n_columns(GtkTreeModel *tree_model) {
+    return DB_TREE_MODEL(tree_model)->n_columns;
+}
+
+static GType db_tree_model_get_column_type(GtkTreeModel *tree_model, gint index) {
+    DbTreeModel *model = DB_TREE_MODEL(tree_model);
+    g_return_val_if_fail(index >= 0 && index < model->n_columns, G_TYPE_INVALID);
+    return model->column_types[index];
+}
+
+static gboolean db_tree_model_get_iter(GtkTreeModel *tree_model, GtkTreeIter *iter, GtkTreePath *path) {
+    if (gtk_tree_path_get_depth(path) != 1) {
+        return FALSE;
+    }
+    return db_tree_model_set_iter(DB_TREE_MODEL(tree_model), iter, gtk_tree_path_get_indices(path)[0]);
+}
+
+static GtkTreePath* db_tree_model_get_path(GtkTreeModel *tree_model, GtkTreeIter *iter) {
+    g_return_val_if_fail(iter->stamp == DB_TREE_MODEL(tree_model)->stamp, NULL);
+    return gtk_tree_path_new_from_indices(db_tree_model_iter_row(iter), -1);
+}
+
+static void db_tree_model_get_value(GtkTreeModel *tree_model, GtkTreeIter *iter, gint column, GValue *value) {
+    DbTreeModel *model = DB_TREE_MODEL(tree_model);
+
+    g_return_if_fail(column >= 0 && column < model->n_columns);
+    g_value_init(value, model->column_types[column]);
+    g_return_if_fail(iter->stamp == model->stamp);
+
+    int row = db_tree_model_iter_row(iter);
+    DbTreeModelPage *page = db_tree_model_get_page(model, row);
+    int page_row = row % DB_TREE_MODEL_PAGE_ROWS;
+
+    // Rows deleted since the count leave the tail of the last page short;
+    // those cells stay empty until the next refresh
+    if (page == NULL || page_row >= page->rows->n_rows) {
+        return;
+    }
+    model->value_func(page->rows, page_row, column, value, model->user_data);
+}
+
+static gboolean db_tree_model_iter_next(GtkTreeModel *tree_model, GtkTreeIter *iter) {
+    return db_tree_model_set_iter(DB_TREE_MODEL(tree_model), iter, db_tree_model_iter_row(iter) + 1);
+}
+
+static gboolean db_tree_model_iter_previous(GtkTreeModel *tree_model, GtkTreeIter *iter) {
+    return db_tree_model_set_iter(DB_TREE_MODEL(tree_model), iter, db_tree_model_iter_row(iter) - 1);
+}
+
+static gboolean db_tree_model_iter_children(GtkTreeModel *tree_model, GtkTreeIter *iter, GtkTreeIter *parent) {
+    if (parent != NULL) {
+        return FALSE;
+    }
+    return db_tree_model_set_iter(DB_TREE_MODEL(tree_model), iter, 0);
+}
+
+static gboolean db_tree_model_iter_has_child(GtkTreeModel *tree_model, GtkTreeIter *iter) {
+    (void)tree_model;
+    (void)iter;
+    return FALSE;
+}
+
+static gint db_tree_model_iter_n_children(GtkTreeModel *tree_model, GtkTreeIter *iter) {
+    return iter == NULL ? DB_TREE_MODEL(tree_model)->n_rows : 0;
+}
+
+static gboolean db_tree_model_iter_nth_child(GtkTreeModel *tree_model, GtkTreeIter *iter,
+                                             GtkTreeIter *parent, gint n) {
+    if (parent != NULL) {
+        return FALSE;
+    }
+    return db_tree_model_set_iter(DB_TREE_MODEL(tree_model), iter, n);
+}
+
+static gboolean db_tree_model_iter_parent(GtkTreeModel *tree_model, GtkTreeIter *iter, GtkTreeIter *child) {
+    (void)tree_model;
+    (void)iter;
+    (void)child;
+    return FALSE;
+}
+
+static void db_tree_model_tree_model_init(GtkTreeModelIface *iface) {
+    iface->get_flags = db_tree_model_get_flags;
+    iface->get_n_columns = db_tree_model_get_n_columns;
+    iface->get_column_type = db_tree_model_get_column_type;
+    iface->get_iter = db_tree_model_get_iter;
+    iface->get_path = db_tree_model_get_path;
+    iface->get_value = db_tree_model_get_value;
+    iface->iter_next = db_tree_model_iter_next;
+    iface->iter_previous = db_tree_model_iter_previous;
+    iface->iter_children = db_tree_model_iter_children;
+    iface->iter_has_child = db_tree_model_iter_has_child;
+    iface->iter_n_children = db_tree_model_iter_n_children;
+    iface->iter_nth_child = db_tree_model_iter_nth_child;
+    iface->iter_parent = db_tree_model_iter_parent;
+}
+
+
+// ============================================================================
+// CONSTRUCTION AND LOADING
+// ============================================================================
+
+DbTreeModel* db_tree_model_new(const char *sql, const char *const *params,
+                               int n_columns, const GType *column_types,
+                               DbTreeModelValueFunc value_func, gpointer user_data) {
+    g_return_val_if_fail(sql != NULL && n_columns > 0 && column_types != NULL && value_func != NULL, NULL);
+
+    DbTreeModel *model = g_object_new(DB_TYPE_TREE_MODEL, NULL);
+
+    // The listing queries end in ';', which cannot be followed by LIMIT
+    char *listing = g_strdup(sql);
+    g_strchomp(listing);
+    size_t len = strlen(listing);
+    while (len > 0 && listing[len - 1] == ';') {
+        listing[--len] = '\0';
+    }
+
+    model->page_sql = g_strdup_printf("%s LIMIT :page_rows OFFSET :page_offset", listing);
+    model->count_sql = g_strdup_printf("SELECT count(*) FROM (%s)", listing);
+    model->params = g_strdupv((char **)params);
+    model->n_columns = n_columns;
+    model->column_types = g_new(GType, n_columns);
+    memcpy(model->column_types, column_types, sizeof(GType) * n_columns);
+    model->value_func = value_func;
+    model->user_data = user_data;
+
+    g_free(listing);
+    return model;
+}
+
+void db_tree_model_set_keyset(DbTreeModel *model, const char *keyset_sql, int key_column) {
+    g_return_if_fail(DB_IS_TREE_MODEL(model) && keyset_sql != NULL);
+    g_return_if_fail(key_column >= 0);
+
+    g_free(model->keyset_sql);
+    model->keyset_sql = g_strdup(keyset_sql);
+    model->key_column = key_column;
+}
+
+static void on_count_rows(const DbAsyncChunk *chunk, gpointer user_data) {
+    DbTreeModelLoad *load = (DbTreeModelLoad *)user_data;
+    if (chunk->n_rows > 0) {
+        load->count = db_async_int(chunk, 0, 0);
+    }
+}
+
+static void on_count_done(GCancellable *handle, int total_rows, gboolean cancelled, gpointer user_data) {
+    (void)total_rows;
+    DbTreeModelLoad *load = (DbTreeModelLoad *)user_data;
+
+    if (!cancelled) {
+        load->model->n_rows = load->count;
+    }
+    if (load->on_ready != NULL) {
+        load->on_ready(load->model, handle, cancelled, load->user_data);
+    }
+
+    g_object_unref(load->model);
+    g_free(load);
+}
+
+GCancellable* db_tree_model_load(DbTreeModel *model, DbTreeModelReadyFunc on_ready, gpointer user_data) {
+    g_return_val_if_fail(DB_IS_TREE_MODEL(model), NULL);
+
+    DbTreeModelLoad *load = g_new0(DbTreeModelLoad, 1);
+    load->model = g_object_ref(model);
+    load->on_ready = on_ready;
+    load->user_data = user_data;
+
+    GCancellable *handle = db_async_query(model->count_sql, (const char *const *)model->params,
+                                          on_count_rows, on_count_done, load);
+    if (handle == NULL) {
+        g_object_unref(load->model);
+        g_free(load);
+    }
+    return handle;
+}
+
+int db_tree_model_get_n_rows(DbTreeModel *model) {
+    g_return_val_if_fail(DB_IS_TREE_MODEL(model), 0);
+    return model->n_rows;
+}
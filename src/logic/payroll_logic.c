@@ -1,19 +1,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <math.h>
-#include "../../include/database.h" 
-
-/* ============================================================================
- * CONSTANTS FOR TAX CALCULATION
- * ============================================================================ */
-
-// Indian Income Tax Slabs 2024-25 (FY 2024-25)
-#define TAX_SLAB_1_LIMIT    250000    // 0% up to 2.5 Lakhs
-#define TAX_SLAB_2_LIMIT    500000    // 5% on 2.5L to 5L
-#define TAX_SLAB_3_LIMIT    1000000   // 20% on 5L to 10L
-#define TAX_SLAB_4_LIMIT    1500000   // 30% on 10L to 15L
-// 30% above 15L
+#include "../../include/database.h"
+#include "../../include/tax.h"
+#include "../../include/logger.h"
 
 /* ============================================================================
  * FUNCTION IMPLEMENTATIONS
@@ -25,13 +15,13 @@
  * @param payroll - Payroll struct
  * @return Total allowances amount
  */
-float payroll_calculate_total_allowances(const Payroll *payroll) {
+Money payroll_calculate_total_allowances(const Payroll *payroll) {
     if (payroll == NULL) {
-        fprintf(stderr, "[ERROR] Payroll pointer is NULL\n");
-        return 0.0f;
+        LOG_ERROR("Payroll pointer is NULL");
+        return 0;
     }
 
-    float total = 0.0f;
+    Money total = 0;
     
     total += payroll->house_rent;
     total += payroll->medical;
@@ -40,10 +30,11 @@ float payroll_calculate_total_allowances(const Payroll *payroll) {
     total += payroll->performance_bonus;
     total += payroll->other_allowances;
 
-    printf("[DEBUG] Total Allowances: HRA=%.2f + Medical=%.2f + Conv=%.2f + DA=%.2f + Bonus=%.2f + Other=%.2f = %.2f\n",
-           payroll->house_rent, payroll->medical, payroll->conveyance,
-           payroll->dearness_allowance, payroll->performance_bonus,
-           payroll->other_allowances, total);
+    LOG_DEBUG("Total Allowances: HRA=" MONEY_FMT " + Medical=" MONEY_FMT " + Conv=" MONEY_FMT
+              " + DA=" MONEY_FMT " + Bonus=" MONEY_FMT " + Other=" MONEY_FMT " = " MONEY_FMT,
+              MONEY_ARGS(payroll->house_rent), MONEY_ARGS(payroll->medical), MONEY_ARGS(payroll->conveyance),
+              MONEY_ARGS(payroll->dearness_allowance), MONEY_ARGS(payroll->performance_bonus),
+              MONEY_ARGS(payroll->other_allowances), MONEY_ARGS(total));
 
     return total;
 }
@@ -54,13 +45,13 @@ float payroll_calculate_total_allowances(const Payroll *payroll) {
  * @param payroll - Payroll struct
  * @return Total deductions amount
  */
-float payroll_calculate_total_deductions(const Payroll *payroll) {
+Money payroll_calculate_total_deductions(const Payroll *payroll) {
     if (payroll == NULL) {
-        fprintf(stderr, "[ERROR] Payroll pointer is NULL\n");
-        return 0.0f;
+        LOG_ERROR("Payroll pointer is NULL");
+        return 0;
     }
 
-    float total = 0.0f;
+    Money total = 0;
 
     total += payroll->income_tax;
     total += payroll->provident_fund;
@@ -68,9 +59,10 @@ float payroll_calculate_total_deductions(const Payroll *payroll) {
     total += payroll->loan_deduction;
     total += payroll->other_deductions;
 
-    printf("[DEBUG] Total Deductions: IT=%.2f + PF=%.2f + Insure=%.2f + Loan=%.2f + Other=%.2f = %.2f\n",
-           payroll->income_tax, payroll->provident_fund, payroll->health_insurance,
-           payroll->loan_deduction, payroll->other_deductions, total);
+    LOG_DEBUG("Total Deductions: IT=" MONEY_FMT " + PF=" MONEY_FMT " + Insure=" MONEY_FMT
+              " + Loan=" MONEY_FMT " + Other=" MONEY_FMT " = " MONEY_FMT,
+              MONEY_ARGS(payroll->income_tax), MONEY_ARGS(payroll->provident_fund), MONEY_ARGS(payroll->health_insurance),
+              MONEY_ARGS(payroll->loan_deduction), MONEY_ARGS(payroll->other_deductions), MONEY_ARGS(total));
 
     return total;
 }
@@ -81,17 +73,17 @@ float payroll_calculate_total_deductions(const Payroll *payroll) {
  * @param payroll - Payroll struct
  * @return Gross salary amount
  */
-float payroll_calculate_gross(const Payroll *payroll) {
+Money payroll_calculate_gross(const Payroll *payroll) {
     if (payroll == NULL) {
-        fprintf(stderr, "[ERROR] Payroll pointer is NULL\n");
-        return 0.0f;
+        LOG_ERROR("Payroll pointer is NULL");
+        return 0;
     }
 
-    float total_allowances = payroll_calculate_total_allowances(payroll);
-    float gross = payroll->basic_salary + total_allowances;
+    Money total_allowances = payroll_calculate_total_allowances(payroll);
+    Money gross = payroll->basic_salary + total_allowances;
 
-    printf("[DEBUG] Gross Salary: Basic=%.2f + Allowances=%.2f = %.2f\n",
-           payroll->basic_salary, total_allowances, gross);
+    LOG_DEBUG("Gross Salary: Basic=" MONEY_FMT " + Allowances=" MONEY_FMT " = " MONEY_FMT,
+              MONEY_ARGS(payroll->basic_salary), MONEY_ARGS(total_allowances), MONEY_ARGS(gross));
 
     return gross;
 }
@@ -103,10 +95,10 @@ float payroll_calculate_gross(const Payroll *payroll) {
  * @param payroll - Payroll struct (will be modified with calculated values)
  * @return Net salary amount
  */
-float payroll_calculate_net(Payroll *payroll) {
+Money payroll_calculate_net(Payroll *payroll) {
     if (payroll == NULL) {
-        fprintf(stderr, "[ERROR] Payroll pointer is NULL\n");
-        return 0.0f;
+        LOG_ERROR("Payroll pointer is NULL");
+        return 0;
     }
 
     // Calculate components
@@ -115,65 +107,38 @@ float payroll_calculate_net(Payroll *payroll) {
     payroll->gross_salary = payroll->basic_salary + payroll->total_allowances;
     payroll->net_salary = payroll->gross_salary - payroll->total_deductions;
 
-    printf("[INFO] ====== SALARY CALCULATION SUMMARY ======\n");
-    printf("[INFO] Basic Salary:         ₹%.2f\n", payroll->basic_salary);
-    printf("[INFO] Total Allowances:    +₹%.2f\n", payroll->total_allowances);
-    printf("[INFO] Gross Salary:         ₹%.2f\n", payroll->gross_salary);
-    printf("[INFO] Total Deductions:    -₹%.2f\n", payroll->total_deductions);
-    printf("[INFO] NET SALARY:           ₹%.2f\n", payroll->net_salary);
-    printf("[INFO] ========================================\n");
+    LOG_DEBUG("====== SALARY CALCULATION SUMMARY ======");
+    LOG_DEBUG("Basic Salary:         ₹" MONEY_FMT, MONEY_ARGS(payroll->basic_salary));
+    LOG_DEBUG("Total Allowances:    +₹" MONEY_FMT, MONEY_ARGS(payroll->total_allowances));
+    LOG_DEBUG("Gross Salary:         ₹" MONEY_FMT, MONEY_ARGS(payroll->gross_salary));
+    LOG_DEBUG("Total Deductions:    -₹" MONEY_FMT, MONEY_ARGS(payroll->total_deductions));
+    LOG_DEBUG("NET SALARY:           ₹" MONEY_FMT, MONEY_ARGS(payroll->net_salary));
+    LOG_DEBUG("========================================");
 
     return payroll->net_salary;
 }
 
 /**
- * Calculate income tax based on Indian tax slabs (2024-25)
- * Progressive tax calculation
- * @param gross_salary - Annual gross salary
- * @return Income tax amount
+ * Calculate income tax based on Indian tax slabs
+ * Uses the slab table for the current financial year (see tax.h)
+ * @param annual_salary - Annual gross salary
+ * @return Monthly income tax amount
  */
-float payroll_calculate_income_tax(float annual_salary) {
-    if (annual_salary <= 0) {
-        return 0.0f;
-    }
-
-    float tax = 0.0f;
-
-    // Tax Slab Calculation (Indian Income Tax)
-    if (annual_salary <= TAX_SLAB_1_LIMIT) {
-        // 0% - No tax
-        tax = 0.0f;
-    }
-    else if (annual_salary <= TAX_SLAB_2_LIMIT) {
-        // 5% on amount above 2.5L
-        tax = (annual_salary - TAX_SLAB_1_LIMIT) * 0.05f;
-    }
-    else if (annual_salary <= TAX_SLAB_3_LIMIT) {
-        // 5% on 2.5L-5L + 20% on 5L-10L
-        tax = (TAX_SLAB_2_LIMIT - TAX_SLAB_1_LIMIT) * 0.05f;
-        tax += (annual_salary - TAX_SLAB_2_LIMIT) * 0.20f;
-    }
-    else if (annual_salary <= TAX_SLAB_4_LIMIT) {
-        // 5% on 2.5L-5L + 20% on 5L-10L + 30% on 10L-15L
-        tax = (TAX_SLAB_2_LIMIT - TAX_SLAB_1_LIMIT) * 0.05f;
-        tax += (TAX_SLAB_3_LIMIT - TAX_SLAB_2_LIMIT) * 0.20f;
-        tax += (annual_salary - TAX_SLAB_3_LIMIT) * 0.30f;
-    }
-    else {
-        // 30% above 15L
-        tax = (TAX_SLAB_2_LIMIT - TAX_SLAB_1_LIMIT) * 0.05f;
-        tax += (TAX_SLAB_3_LIMIT - TAX_SLAB_2_LIMIT) * 0.20f;
-        tax += (TAX_SLAB_4_LIMIT - TAX_SLAB_3_LIMIT) * 0.30f;
-        tax += (annual_salary - TAX_SLAB_4_LIMIT) * 0.30f;
-    }
-
-    // Monthly tax (divide by 12)
-    float monthly_tax = tax / 12.0f;
-
-    printf("[DEBUG] Tax Calculation: Annual Salary=%.2f, Annual Tax=%.2f, Monthly Tax=%.2f\n",
-           annual_salary, tax, monthly_tax);
+Money payroll_calculate_income_tax(Money annual_salary) {
+    return tax_monthly(tax_table_current(), annual_salary);
+}
 
-    return monthly_tax;
+/**
+ * Calculate income tax for a given payroll month
+ * Uses the slab table of the financial year the month falls in, as a
+ * payroll run for that month does
+ * @param annual_salary - Annual gross salary
+ * @param month - Payroll month (1-12)
+ * @param year - Payroll year
+ * @return Monthly income tax amount
+ */
+Money payroll_calculate_income_tax_for_month(Money annual_salary, int month, int year) {
+    return tax_monthly(tax_table_for_year(tax_financial_year(month, year)), annual_salary);
 }
 
 /**
@@ -187,33 +152,34 @@ float payroll_calculate_income_tax(float annual_salary) {
 int payroll_validate(const Payroll *payroll, char *error_msg, size_t error_len) {
     if (payroll == NULL) {
         snprintf(error_msg, error_len, "Payroll structure is NULL");
-        fprintf(stderr, "[ERROR] %s\n", error_msg);
+        LOG_ERROR("%s", error_msg);
         return 0;
     }
 
     if (error_msg == NULL || error_len == 0) {
-        fprintf(stderr, "[ERROR] Error message buffer is invalid\n");
+        LOG_ERROR("Error message buffer is invalid");
         return 0;
     }
 
     // Check emp_id
     if (payroll->emp_id <= 0) {
         snprintf(error_msg, error_len, "Invalid Employee ID: %d (must be > 0)", payroll->emp_id);
-        fprintf(stderr, "[ERROR] %s\n", error_msg);
+        LOG_ERROR("%s", error_msg);
         return 0;
     }
 
     // Check month_year
     if (strlen(payroll->month_year) == 0) {
         snprintf(error_msg, error_len, "Month/Year cannot be empty");
-        fprintf(stderr, "[ERROR] %s\n", error_msg);
+        LOG_ERROR("%s", error_msg);
         return 0;
     }
 
     // Check basic_salary
     if (payroll->basic_salary <= 0) {
-        snprintf(error_msg, error_len, "Basic salary must be greater than 0 (%.2f)", payroll->basic_salary);
-        fprintf(stderr, "[ERROR] %s\n", error_msg);
+        snprintf(error_msg, error_len, "Basic salary must be greater than 0 (" MONEY_FMT ")",
+                 MONEY_ARGS(payroll->basic_salary));
+        LOG_ERROR("%s", error_msg);
         return 0;
     }
 
@@ -222,7 +188,7 @@ int payroll_validate(const Payroll *payroll, char *error_msg, size_t error_len)
         payroll->conveyance < 0 || payroll->dearness_allowance < 0 ||
         payroll->performance_bonus < 0 || payroll->other_allowances < 0) {
         snprintf(error_msg, error_len, "Allowances cannot be negative");
-        fprintf(stderr, "[ERROR] %s\n", error_msg);
+        LOG_ERROR("%s", error_msg);
         return 0;
     }
 
@@ -231,25 +197,25 @@ int payroll_validate(const Payroll *payroll, char *error_msg, size_t error_len)
         payroll->health_insurance < 0 || payroll->loan_deduction < 0 ||
         payroll->other_deductions < 0) {
         snprintf(error_msg, error_len, "Deductions cannot be negative");
-        fprintf(stderr, "[ERROR] %s\n", error_msg);
+        LOG_ERROR("%s", error_msg);
         return 0;
     }
 
     // Check total deductions don't exceed gross salary
-    float total_allow = payroll_calculate_total_allowances(payroll);
-    float total_deduct = payroll_calculate_total_deductions(payroll);
-    float gross = payroll->basic_salary + total_allow;
+    Money total_allow = payroll_calculate_total_allowances(payroll);
+    Money total_deduct = payroll_calculate_total_deductions(payroll);
+    Money gross = payroll->basic_salary + total_allow;
 
     if (total_deduct > gross) {
         snprintf(error_msg, error_len, 
-                 "Total deductions (₹%.2f) cannot exceed gross salary (₹%.2f)",
-                 total_deduct, gross);
-        fprintf(stderr, "[ERROR] %s\n", error_msg);
+                 "Total deductions (₹" MONEY_FMT ") cannot exceed gross salary (₹" MONEY_FMT ")",
+                 MONEY_ARGS(total_deduct), MONEY_ARGS(gross));
+        LOG_ERROR("%s", error_msg);
         return 0;
     }
 
-    printf("[SUCCESS] Payroll validation passed for emp_id=%d, month=%s\n",
-           payroll->emp_id, payroll->month_year);
+    LOG_DEBUG("Payroll validation passed for emp_id=%d, month=%s",
+              payroll->emp_id, payroll->month_year);
     return 1;
 }
 
@@ -263,7 +229,7 @@ int payroll_validate(const Payroll *payroll, char *error_msg, size_t error_len)
  */
 int payroll_build_salary_slip(const Payroll *payroll, SalarySlip *slip) {
     if (payroll == NULL || slip == NULL) {
-        fprintf(stderr, "[ERROR] Payroll or SalarySlip pointer is NULL\n");
+        LOG_ERROR("Payroll or SalarySlip pointer is NULL");
         return 0;
     }
 
@@ -298,8 +264,8 @@ int payroll_build_salary_slip(const Payroll *payroll, SalarySlip *slip) {
 
     strcpy(slip->payment_status, payroll->status);
 
-    printf("[SUCCESS] Salary slip built for payroll_id=%d, emp_id=%d\n",
-           payroll->payroll_id, payroll->emp_id);
+    LOG_DEBUG("Salary slip built for payroll_id=%d, emp_id=%d",
+              payroll->payroll_id, payroll->emp_id);
     return 1;
 }
 
@@ -313,11 +279,12 @@ int payroll_build_salary_slip(const Payroll *payroll, SalarySlip *slip) {
  */
 int payroll_format_slip_text(const SalarySlip *slip, char *buffer, size_t buffer_size) {
     if (slip == NULL || buffer == NULL || buffer_size == 0) {
-        fprintf(stderr, "[ERROR] Invalid parameters for formatting salary slip\n");
+        LOG_ERROR("Invalid parameters for formatting salary slip");
         return 0;
     }
 
     int written = 0;
+    char amount[MONEY_TEXT_SIZE];
 
     // Header
     written += snprintf(buffer + written, buffer_size - written,
@@ -348,23 +315,24 @@ int payroll_format_slip_text(const SalarySlip *slip, char *buffer, size_t buffer
     written += snprintf(buffer + written, buffer_size - written,
         "║ EARNINGS:                                                  ║\n");
     written += snprintf(buffer + written, buffer_size - written,
-        "║   Basic Salary:              ₹ %12.2f           ║\n", slip->basic_salary);
+        "║   Basic Salary:              ₹ %12s           ║\n", money_format(slip->basic_salary, amount, sizeof(amount)));
     written += snprintf(buffer + written, buffer_size - written,
-        "║   House Rent Allowance:      ₹ %12.2f           ║\n", slip->house_rent);
+        "║   House Rent Allowance:      ₹ %12s           ║\n", money_format(slip->house_rent, amount, sizeof(amount)));
     written += snprintf(buffer + written, buffer_size - written,
-        "║   Medical Allowance:         ₹ %12.2f           ║\n", slip->medical);
+        "║   Medical Allowance:         ₹ %12s           ║\n", money_format(slip->medical, amount, sizeof(amount)));
     written += snprintf(buffer + written, buffer_size - written,
-        "║   Conveyance Allowance:      ₹ %12.2f           ║\n", slip->conveyance);
+        "║   Conveyance Allowance:      ₹ %12s           ║\n", money_format(slip->conveyance, amount, sizeof(amount)));
     written += snprintf(buffer + written, buffer_size - written,
-        "║   Dearness Allowance:        ₹ %12.2f           ║\n", slip->dearness_allowance);
+        "║   Dearness Allowance:        ₹ %12s           ║\n", money_format(slip->dearness_allowance, amount, sizeof(amount)));
     written += snprintf(buffer + written, buffer_size - written,
-        "║   Performance Bonus:         ₹ %12.2f           ║\n", slip->performance_bonus);
+        "║   Performance Bonus:         ₹ %12s           ║\n", money_format(slip->performance_bonus, amount, sizeof(amount)));
     written += snprintf(buffer + written, buffer_size - written,
-        "║   Other Allowances:          ₹ %12.2f           ║\n", slip->other_allowances);
+        "║   Other Allowances:          ₹ %12s           ║\n", money_format(slip->other_allowances, amount, sizeof(amount)));
     written += snprintf(buffer + written, buffer_size - written,
         "├────────────────────────────────────────────────────────────┤\n");
     written += snprintf(buffer + written, buffer_size - written,
-        "║ Total Earnings:              ₹ %12.2f           ║\n", slip->total_allowances + slip->basic_salary);
+        "║ Total Earnings:              ₹ %12s           ║\n",
+        money_format(slip->total_allowances + slip->basic_salary, amount, sizeof(amount)));
 
     // Deductions
     written += snprintf(buffer + written, buffer_size - written,
@@ -372,25 +340,25 @@ int payroll_format_slip_text(const SalarySlip *slip, char *buffer, size_t buffer
     written += snprintf(buffer + written, buffer_size - written,
         "║ DEDUCTIONS:                                                ║\n");
     written += snprintf(buffer + written, buffer_size - written,
-        "║   Income Tax:                ₹ %12.2f           ║\n", slip->income_tax);
+        "║   Income Tax:                ₹ %12s           ║\n", money_format(slip->income_tax, amount, sizeof(amount)));
     written += snprintf(buffer + written, buffer_size - written,
-        "║   Provident Fund:            ₹ %12.2f           ║\n", slip->provident_fund);
+        "║   Provident Fund:            ₹ %12s           ║\n", money_format(slip->provident_fund, amount, sizeof(amount)));
     written += snprintf(buffer + written, buffer_size - written,
-        "║   Health Insurance:          ₹ %12.2f           ║\n", slip->health_insurance);
+        "║   Health Insurance:          ₹ %12s           ║\n", money_format(slip->health_insurance, amount, sizeof(amount)));
     written += snprintf(buffer + written, buffer_size - written,
-        "║   Loan Deduction:            ₹ %12.2f           ║\n", slip->loan_deduction);
+        "║   Loan Deduction:            ₹ %12s           ║\n", money_format(slip->loan_deduction, amount, sizeof(amount)));
     written += snprintf(buffer + written, buffer_size - written,
-        "║   Other Deductions:          ₹ %12.2f           ║\n", slip->other_deductions);
+        "║   Other Deductions:          ₹ %12s           ║\n", money_format(slip->other_deductions, amount, sizeof(amount)));
     written += snprintf(buffer + written, buffer_size - written,
         "├────────────────────────────────────────────────────────────┤\n");
     written += snprintf(buffer + written, buffer_size - written,
-        "║ Total Deductions:            ₹ %12.2f           ║\n", slip->total_deductions);
+        "║ Total Deductions:            ₹ %12s           ║\n", money_format(slip->total_deductions, amount, sizeof(amount)));
 
     // Net Salary
     written += snprintf(buffer + written, buffer_size - written,
         "╠════════════════════════════════════════════════════════════╣\n");
     written += snprintf(buffer + written, buffer_size - written,
-        "║ NET SALARY (In Hand):        ₹ %12.2f           ║\n", slip->net_salary);
+        "║ NET SALARY (In Hand):        ₹ %12s           ║\n", money_format(slip->net_salary, amount, sizeof(amount)));
     written += snprintf(buffer + written, buffer_size - written,
         "║ Payment Status:              %-45s ║\n", slip->payment_status);
     written += snprintf(buffer + written, buffer_size - written,
@@ -401,24 +369,25 @@ int payroll_format_slip_text(const SalarySlip *slip, char *buffer, size_t buffer
 
 /**
  * Get monthly payroll summary for a department
+ * Read from the PayrollSummary rollup, which triggers keep in step with
+ * the payroll table; no payroll rows are scanned
  * @param month_year - Month and year (e.g., "Dec-2025")
  * @param department - Department name (NULL for all departments)
- * @return Total payroll amount, -1 on error
+ * @return Total gross payroll for the month, -1 on error
  */
-float payroll_get_monthly_summary(const char *month_year, const char *department) {
+Money payroll_get_monthly_summary(const char *month_year, const char *department) {
     if (month_year == NULL) {
-        fprintf(stderr, "[ERROR] Month/Year cannot be NULL\n");
-        return -1.0f;
+        LOG_ERROR("Month/Year cannot be NULL");
+        return -1;
     }
 
-    printf("[INFO] Calculating payroll summary for %s, Department: %s\n",
-           month_year, department ? department : "All");
-
-    // This will be implemented to query database
-    // For now, return placeholder
-    printf("[WARNING] payroll_get_monthly_summary: Database query not yet implemented\n");
+    PayrollSummary summary;
+    if (db_get_payroll_summary(month_year, department, &summary) < 0) {
+        LOG_ERROR("Payroll summary unavailable for %s", month_year);
+        return -1;
+    }
 
-    return 0.0f;
+    return summary.total_gross;
 }
 
 /**
@@ -427,15 +396,15 @@ float payroll_get_monthly_summary(const char *month_year, const char *department
  * @param basic_salary - Basic salary amount
  * @return PF contribution amount
  */
-float payroll_calculate_pf(float basic_salary) {
+Money payroll_calculate_pf(Money basic_salary) {
     if (basic_salary <= 0) {
-        return 0.0f;
+        return 0;
     }
 
     // Standard PF: 12% of basic salary
-    float pf = basic_salary * 0.12f;
+    Money pf = money_percent(basic_salary, 1200);
 
-    printf("[DEBUG] PF Calculation: Basic=%.2f * 12%% = %.2f\n", basic_salary, pf);
+    LOG_DEBUG("PF Calculation: Basic=" MONEY_FMT " * 12%% = " MONEY_FMT, MONEY_ARGS(basic_salary), MONEY_ARGS(pf));
 
     return pf;
 }
@@ -446,15 +415,15 @@ float payroll_calculate_pf(float basic_salary) {
  * @param basic_salary - Basic salary amount
  * @return HRA amount
  */
-float payroll_calculate_hra(float basic_salary) {
+Money payroll_calculate_hra(Money basic_salary) {
     if (basic_salary <= 0) {
-        return 0.0f;
+        return 0;
     }
 
     // Standard HRA: 40% of basic salary
-    float hra = basic_salary * 0.40f;
+    Money hra = money_percent(basic_salary, 4000);
 
-    printf("[DEBUG] HRA Calculation: Basic=%.2f * 40%% = %.2f\n", basic_salary, hra);
+    LOG_DEBUG("HRA Calculation: Basic=" MONEY_FMT " * 40%% = " MONEY_FMT, MONEY_ARGS(basic_salary), MONEY_ARGS(hra));
 
     return hra;
 }
@@ -465,15 +434,15 @@ float payroll_calculate_hra(float basic_salary) {
  * @param basic_salary - Basic salary amount
  * @return DA amount
  */
-float payroll_calculate_da(float basic_salary) {
+Money payroll_calculate_da(Money basic_salary) {
     if (basic_salary <= 0) {
-        return 0.0f;
+        return 0;
     }
 
     // Standard DA: 50% of basic salary
-    float da = basic_salary * 0.50f;
+    Money da = money_percent(basic_salary, 5000);
 
-    printf("[DEBUG] DA Calculation: Basic=%.2f * 50%% = %.2f\n", basic_salary, da);
+    LOG_DEBUG("DA Calculation: Basic=" MONEY_FMT " * 50%% = " MONEY_FMT, MONEY_ARGS(basic_salary), MONEY_ARGS(da));
 
     return da;
 }
\ No newline at end of file
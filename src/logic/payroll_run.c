@@ -0,0 +1,278 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <glib.h>
+#include "../../include/payroll.h"
+#include "../../include/payroll_run.h"
+#include "../../include/tax.h"
+#include "../../include/logger.h"
+
+
+// ============================================================================
+// BATCH PAYROLL RUN
+//
+// The main thread loads the employees still to be paid, a GThreadPool
+// computes their payroll in slices of RUN_SLICE_SIZE employees, and the
+// main thread writes the results: one payroll row and one salary slip per
+// employee, all in a single transaction. Workers never touch the database.
+//
+// A run pays basic salary plus the standard HRA and DA, less PF and income
+// tax on the annualised gross - the same payroll_calculate_* rules the
+// payroll form uses, with the tax slabs of the run month's financial year
+// applied a slice at a time. Other allowances and deductions are left at 0
+// for the form to adjust afterwards.
+// ============================================================================
+
+#define RUN_SLICE_SIZE 64
+
+typedef struct {
+    Payroll payroll;
+    int valid;
+    char error[200];
+} RunItem;
+
+typedef struct {
+    const Employee *employees;
+    RunItem *items;
+    int count;
+    const char *month_year;
+    const TaxTable *tax;
+} RunContext;
+
+
+static const char *const run_months[] = {
+    "Jan", "Feb", "Mar", "Apr", "May", "Jun",
+    "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
+};
+
+// Splits "Mon-YYYY" into a month (1-12) and year; 1 on success
+static int run_parse_month(const char *month_year, int *month, int *year) {
+    char name[4];
+    char extra;
+
+    if (month_year == NULL || sscanf(month_year, "%3s-%d%c", name, year, &extra) != 2) {
+        return 0;
+    }
+    if (*year < 1900 || *year > 9999) {
+        return 0;
+    }
+    for (int i = 0; i < 12; i++) {
+        if (strcmp(name, run_months[i]) == 0) {
+            *month = i + 1;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Allowances and PF; income tax is filled in for the whole slice at once
+static void run_prepare_employee(const Employee *emp, const char *month_year, RunItem *item) {
+    Payroll *p = &item->payroll;
+
+    memset(item, 0, sizeof(RunItem));
+    p->emp_id = emp->emp_id;
+    g_strlcpy(p->month_year, month_year, sizeof(p->month_year));
+    p->basic_salary = emp->base_salary;
+
+    p->house_rent = payroll_calculate_hra(p->basic_salary);
+    p->dearness_allowance = payroll_calculate_da(p->basic_salary);
+    p->provident_fund = payroll_calculate_pf(p->basic_salary);
+}
+
+static void run_finish_employee(RunItem *item) {
+    Payroll *p = &item->payroll;
+
+    if (!payroll_validate(p, item->error, sizeof(item->error))) {
+        return;
+    }
+    payroll_calculate_net(p);
+
+    strcpy(p->status, "Pending");
+    strcpy(p->remarks, "Payroll run");
+    item->valid = 1;
+}
+
+// GThreadPool worker: data is the index of the slice's first employee + 1
+// (the pool does not accept NULL)
+static void run_compute_slice(gpointer data, gpointer user_data) {
+    RunContext *ctx = (RunContext *)user_data;
+    int first = GPOINTER_TO_INT(data) - 1;
+    int count = MIN(RUN_SLICE_SIZE, ctx->count - first);
+    RunItem *items = &ctx->items[first];
+    Money annual[RUN_SLICE_SIZE];
+    Money monthly_tax[RUN_SLICE_SIZE];
+
+    for (int i = 0; i < count; i++) {
+        run_prepare_employee(&ctx->employees[first + i], ctx->month_year, &items[i]);
+        annual[i] = payroll_calculate_gross(&items[i].payroll) * 12;
+    }
+
+    tax_monthly_batch(ctx->tax, annual, monthly_tax, count);
+
+    for (int i = 0; i < count; i++) {
+        items[i].payroll.income_tax = monthly_tax[i];
+        run_finish_employee(&items[i]);
+    }
+}
+
+static int run_compute_all(RunContext *ctx) {
+    int threads = MAX(1, MIN((int)g_get_num_processors(), (ctx->count + RUN_SLICE_SIZE - 1) / RUN_SLICE_SIZE));
+    GError *error = NULL;
+
+    GThreadPool *pool = g_thread_pool_new(run_compute_slice, ctx, threads, TRUE, &error);
+    if (pool == NULL) {
+        LOG_ERROR("Failed to start payroll workers: %s", error->message);
+        g_error_free(error);
+        return 0;
+    }
+
+    for (int first = 0; first < ctx->count; first += RUN_SLICE_SIZE) {
+        g_thread_pool_push(pool, GINT_TO_POINTER(first + 1), NULL);
+    }
+
+    // Waits for every queued slice
+    g_thread_pool_free(pool, FALSE, TRUE);
+    return 1;
+}
+
+static void run_fill_slip(const Employee *emp, const Payroll *payroll, int month, int year,
+                          const char *slip_date, SalarySlip *slip) {
+    payroll_build_salary_slip(payroll, slip);
+
+    snprintf(slip->emp_no, sizeof(slip->emp_no), "%d", emp->emp_no);
+    g_strlcpy(slip->employee_name, emp->emp_name, sizeof(slip->employee_name));
+    g_strlcpy(slip->designation, emp->designation, sizeof(slip->designation));
+    g_strlcpy(slip->department, emp->department, sizeof(slip->department));
+
+    snprintf(slip->from_date, sizeof(slip->from_date), "01-%02d-%04d", month, year);
+    snprintf(slip->to_date, sizeof(slip->to_date), "%02d-%02d-%04d",
+             g_date_get_days_in_month((GDateMonth)month, (GDateYear)year), month, year);
+    g_strlcpy(slip->slip_date, slip_date, sizeof(slip->slip_date));
+}
+
+// Writes every valid item; any failure rolls the whole run back
+static int run_write_all(const RunContext *ctx, int month, int year, PayrollRunStats *stats) {
+    char slip_date[20];
+    time_t now = time(NULL);
+    strftime(slip_date, sizeof(slip_date), "%d-%m-%Y", localtime(&now));
+
+    if (!db_begin_transaction()) {
+        return 0;
+    }
+
+    for (int i = 0; i < ctx->count; i++) {
+        RunItem *item = &ctx->items[i];
+        if (!item->valid) {
+            continue;
+        }
+
+        int payroll_id = db_add_payroll(&item->payroll);
+        if (payroll_id < 0) {
+            LOG_ERROR("Payroll run stopped at emp_id=%d", item->payroll.emp_id);
+            db_rollback_transaction();
+            stats->written = 0;
+            return 0;
+        }
+        item->payroll.payroll_id = payroll_id;
+
+        SalarySlip slip;
+        run_fill_slip(&ctx->employees[i], &item->payroll, month, year, slip_date, &slip);
+        if (db_add_salary_slip(&slip) < 0) {
+            LOG_ERROR("Payroll run stopped at emp_id=%d", item->payroll.emp_id);
+            db_rollback_transaction();
+            stats->written = 0;
+            return 0;
+        }
+        stats->written++;
+    }
+
+    if (!db_commit_transaction()) {
+        stats->written = 0;
+        return 0;
+    }
+    return 1;
+}
+
+int payroll_run_month(const char *month_year, int dry_run, PayrollRunStats *out_stats) {
+    PayrollRunStats stats;
+    memset(&stats, 0, sizeof(stats));
+    if (out_stats) {
+        *out_stats = stats;
+    }
+
+    int month = 0;
+    int year = 0;
+    if (!run_parse_month(month_year, &month, &year)) {
+        LOG_ERROR("Invalid payroll month '%s' (expected e.g. Dec-2025)",
+                  month_year ? month_year : "");
+        return 0;
+    }
+
+    gint64 started = g_get_monotonic_time();
+
+    Employee *employees = NULL;
+    int count = db_get_payroll_run_employees(month_year, &employees, &stats.already_paid);
+    if (count < 0) {
+        LOG_ERROR("Payroll run could not load employees");
+        return 0;
+    }
+    stats.employees = count + stats.already_paid;
+
+    LOG_INFO("Payroll run%s for %s: %d active employee(s), %d already on payroll",
+             dry_run ? " (dry run)" : "", month_year, stats.employees, stats.already_paid);
+
+    RunContext ctx = { employees, NULL, count, month_year,
+                       tax_table_for_year(tax_financial_year(month, year)) };
+    int ok = 1;
+
+    if (count > 0) {
+        ctx.items = (RunItem *)calloc(count, sizeof(RunItem));
+        ok = ctx.items != NULL && run_compute_all(&ctx);
+        if (ctx.items == NULL) {
+            LOG_ERROR("Memory allocation failed");
+        }
+    }
+
+    for (int i = 0; ok && i < count; i++) {
+        const RunItem *item = &ctx.items[i];
+        if (!item->valid) {
+            stats.failed++;
+            LOG_WARNING("%s (emp_no %d) left out: %s",
+                        employees[i].emp_name, employees[i].emp_no, item->error);
+            continue;
+        }
+        stats.computed++;
+        stats.total_gross += item->payroll.gross_salary;
+        stats.total_deductions += item->payroll.total_deductions;
+        stats.total_net += item->payroll.net_salary;
+    }
+
+    if (ok && !dry_run && stats.computed > 0) {
+        ok = run_write_all(&ctx, month, year, &stats);
+        if (!ok) {
+            LOG_ERROR("Payroll run for %s rolled back; nothing was written", month_year);
+        }
+    }
+
+    free(ctx.items);
+    free(employees);
+
+    stats.seconds = (g_get_monotonic_time() - started) / 1e6;
+
+    if (ok) {
+        LOG_SUCCESS("Payroll run%s for %s: %d computed, %d written, %d left out, %.2fs",
+                    dry_run ? " (dry run)" : "", month_year, stats.computed, stats.written, stats.failed,
+                    stats.seconds);
+        LOG_INFO("  Gross " MONEY_FMT ", deductions " MONEY_FMT ", net " MONEY_FMT,
+                 MONEY_ARGS(stats.total_gross), MONEY_ARGS(stats.total_deductions), MONEY_ARGS(stats.total_net));
+        if (stats.failed > 0) {
+            LOG_INFO("Fix the employees left out and run %s again to pay them", month_year);
+        }
+    }
+
+    if (out_stats) {
+        *out_stats = stats;
+    }
+    return ok;
+}
@@ -0,0 +1,237 @@
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+#include "../../include/student_index.h"
+#include "../../include/logger.h"
+
+
+// One (key, student) pair. key points into the student's keys in
+// index_students, which own the strings.
+typedef struct {
+    const char *key;
+    int student_id;
+} StudentIndexEntry;
+
+static GArray *index_entries = NULL;        // StudentIndexEntry, sorted once loaded
+static GHashTable *index_students = NULL;   // student_id -> gchar** keys
+static gboolean index_loaded = FALSE;
+
+// Name words split on these; a query is split the same way
+#define STUDENT_INDEX_SEPARATORS " \t.,-'"
+
+
+static void student_index_init(void) {
+    if (index_entries == NULL) {
+        index_entries = g_array_new(FALSE, FALSE, sizeof(StudentIndexEntry));
+        index_students = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL,
+                                               (GDestroyNotify)g_strfreev);
+    }
+}
+
+static void student_keys_add(GPtrArray *keys, const char *text) {
+    if (text == NULL || text[0] == '\0') {
+        return;
+    }
+
+    gchar *key = g_utf8_casefold(text, -1);
+    for (guint i = 0; i < keys->len; i++) {
+        if (strcmp(g_ptr_array_index(keys, i), key) == 0) {
+            g_free(key);
+            return;
+        }
+    }
+    g_ptr_array_add(keys, key);
+}
+
+// roll_no, mobile and each word of the name, NULL-terminated
+static gchar** student_keys_new(const char *roll_no, const char *name, const char *mobile) {
+    GPtrArray *keys = g_ptr_array_new();
+
+    student_keys_add(keys, roll_no);
+    student_keys_add(keys, mobile);
+    if (name != NULL) {
+        gchar **words = g_strsplit_set(name, STUDENT_INDEX_SEPARATORS, -1);
+        for (int i = 0; words[i] != NULL; i++) {
+            student_keys_add(keys, words[i]);
+        }
+        g_strfreev(words);
+    }
+
+    g_ptr_array_add(keys, NULL);
+    return (gchar **)g_ptr_array_free(keys, FALSE);
+}
+
+static int entry_compare(const StudentIndexEntry *a, const char *key, int student_id) {
+    int c = strcmp(a->key, key);
+    if (c != 0) {
+        return c;
+    }
+    return (a->student_id > student_id) - (a->student_id < student_id);
+}
+
+static gint entry_sort(gconstpointer a, gconstpointer b) {
+    const StudentIndexEntry *other = (const StudentIndexEntry *)b;
+    return entry_compare((const StudentIndexEntry *)a, other->key, other->student_id);
+}
+
+// First entry not less than (key, student_id)
+static guint entry_lower_bound(const char *key, int student_id) {
+    guint low = 0;
+    guint high = index_entries->len;
+
+    while (low < high) {
+        guint mid = low + (high - low) / 2;
+        if (entry_compare(&g_array_index(index_entries, StudentIndexEntry, mid), key, student_id) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+void student_index_clear(void) {
+    student_index_init();
+    g_array_set_size(index_entries, 0);
+    g_hash_table_remove_all(index_students);
+    index_loaded = FALSE;
+}
+
+void student_index_load_row(int student_id, const char *roll_no, const char *name, const char *mobile) {
+    student_index_init();
+
+    gchar **keys = student_keys_new(roll_no, name, mobile);
+    for (int i = 0; keys[i] != NULL; i++) {
+        StudentIndexEntry entry = { keys[i], student_id };
+        g_array_append_val(index_entries, entry);
+    }
+    g_hash_table_replace(index_students, GINT_TO_POINTER(student_id), keys);
+}
+
+void student_index_load_done(void) {
+    student_index_init();
+
+    gint64 started = g_get_monotonic_time();
+    g_array_sort(index_entries, entry_sort);
+    index_loaded = TRUE;
+
+    LOG_INFO("Student search index: %u students, %u keys, sorted in %.1f ms",
+             g_hash_table_size(index_students), index_entries->len,
+             (g_get_monotonic_time() - started) / 1000.0);
+}
+
+gboolean student_index_ready(void) {
+    return index_loaded;
+}
+
+void student_index_remove(int student_id) {
+    if (!index_loaded) {
+        return;
+    }
+
+    gchar **keys = g_hash_table_lookup(index_students, GINT_TO_POINTER(student_id));
+    if (keys == NULL) {
+        return;
+    }
+
+    for (int i = 0; keys[i] != NULL; i++) {
+        guint pos = entry_lower_bound(keys[i], student_id);
+        if (pos < index_entries->len &&
+            entry_compare(&g_array_index(index_entries, StudentIndexEntry, pos), keys[i], student_id) == 0) {
+            g_array_remove_index(index_entries, pos);
+        }
+    }
+    g_hash_table_remove(index_students, GINT_TO_POINTER(student_id));
+}
+
+void student_index_put(int student_id, const char *roll_no, const char *name, const char *mobile) {
+    if (!index_loaded) {
+        return;
+    }
+
+    student_index_remove(student_id);
+
+    gchar **keys = student_keys_new(roll_no, name, mobile);
+    for (int i = 0; keys[i] != NULL; i++) {
+        StudentIndexEntry entry = { keys[i], student_id };
+        g_array_insert_val(index_entries, entry_lower_bound(keys[i], student_id), entry);
+    }
+    g_hash_table_replace(index_students, GINT_TO_POINTER(student_id), keys);
+}
+
+int student_index_count(void) {
+    return index_students != NULL ? (int)g_hash_table_size(index_students) : 0;
+}
+
+// Students with a key starting with prefix, limited to those in within (if given)
+static GHashTable* student_index_prefix(const char *prefix, GHashTable *within) {
+    GHashTable *found = g_hash_table_new(g_direct_hash, g_direct_equal);
+    size_t prefix_len = strlen(prefix);
+
+    for (guint pos = entry_lower_bound(prefix, G_MININT); pos < index_entries->len; pos++) {
+        const StudentIndexEntry *entry = &g_array_index(index_entries, StudentIndexEntry, pos);
+        if (strncmp(entry->key, prefix, prefix_len) != 0) {
+            break;
+        }
+        if (within == NULL || g_hash_table_contains(within, GINT_TO_POINTER(entry->student_id))) {
+            g_hash_table_add(found, GINT_TO_POINTER(entry->student_id));
+        }
+    }
+    return found;
+}
+
+GHashTable* student_index_search(const char *text) {
+    if (text == NULL || index_entries == NULL) {
+        return NULL;
+    }
+
+    gchar *folded = g_utf8_casefold(text, -1);
+    gchar **words = g_strsplit_set(folded, STUDENT_INDEX_SEPARATORS, -1);
+    GHashTable *result = NULL;
+
+    // Each word narrows the previous words' matches
+    for (int i = 0; words[i] != NULL; i++) {
+        if (words[i][0] == '\0') {
+            continue;
+        }
+        GHashTable *narrowed = student_index_prefix(words[i], result);
+        if (result != NULL) {
+            g_hash_table_unref(result);
+        }
+        result = narrowed;
+        if (g_hash_table_size(result) == 0) {
+            break;
+        }
+    }
+
+    g_strfreev(words);
+    g_free(folded);
+    return result;
+}
+
+static int compare_ids_desc(const void *a, const void *b) {
+    int x = *(const int *)a;
+    int y = *(const int *)b;
+    return (x < y) - (x > y);
+}
+
+int* student_index_ids_desc(int *out_count) {
+    int count = student_index_count();
+    int *ids = g_new(int, count > 0 ? count : 1);
+    int n = 0;
+
+    if (index_students != NULL) {
+        GHashTableIter iter;
+        gpointer key;
+        g_hash_table_iter_init(&iter, index_students);
+        while (g_hash_table_iter_next(&iter, &key, NULL)) {
+            ids[n++] = GPOINTER_TO_INT(key);
+        }
+    }
+
+    qsort(ids, n, sizeof(int), compare_ids_desc);
+    if (out_count != NULL) {
+        *out_count = n;
+    }
+    return ids;
+}
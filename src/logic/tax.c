@@ -0,0 +1,248 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "../../include/tax.h"
+#include "../../include/logger.h"
+
+
+// ============================================================================
+// COMPILED-IN SLABS
+// Lower bounds in rupees, rates in basis points. FY 2024-25 is the table
+// payroll has always used; it stays in force for later years until a
+// newer table is added here or in the config file.
+// ============================================================================
+
+typedef struct {
+    int fy_start;
+    int n_slabs;
+    long long lower_rupees[TAX_MAX_SLABS];
+    int rate_bp[TAX_MAX_SLABS];
+} TaxSlabSource;
+
+static const TaxSlabSource builtin_slabs[] = {
+    // 0% to 2.5L, 5% to 5L, 20% to 10L, 30% above
+    { 2024, 4, { 0, 250000, 500000, 1000000 }, { 0, 500, 2000, 3000 } },
+};
+
+#define TAX_BUILTIN_COUNT ((int)(sizeof(builtin_slabs) / sizeof(builtin_slabs[0])))
+#define TAX_MAX_TABLES 16
+#define TAX_LINE_MAX 256
+
+// Sorted by fy_start; written by tax_init() only
+static TaxTable tax_tables[TAX_MAX_TABLES];
+static int tax_table_count = 0;
+static const TaxTable *tax_current = NULL;
+
+
+// Fills base_tax: each bound's tax is the previous bound's plus the
+// previous slab in full, rounded per slab like the old if/else ladder
+static void tax_prepare(TaxTable *table) {
+    table->base_tax[0] = 0;
+    for (int i = 1; i < table->n_slabs; i++) {
+        table->base_tax[i] = table->base_tax[i - 1] +
+            money_percent(table->lower[i] - table->lower[i - 1], table->rate_bp[i - 1]);
+    }
+}
+
+// Adds table, replacing any table for the same year, keeping the order
+static int tax_register(const TaxTable *table) {
+    int at = 0;
+    while (at < tax_table_count && tax_tables[at].fy_start < table->fy_start) {
+        at++;
+    }
+
+    if (at == tax_table_count || tax_tables[at].fy_start != table->fy_start) {
+        if (tax_table_count == TAX_MAX_TABLES) {
+            LOG_ERROR("Too many tax years (max %d)", TAX_MAX_TABLES);
+            return 0;
+        }
+        memmove(&tax_tables[at + 1], &tax_tables[at], (tax_table_count - at) * sizeof(TaxTable));
+        tax_table_count++;
+    }
+
+    tax_tables[at] = *table;
+    tax_prepare(&tax_tables[at]);
+    return 1;
+}
+
+static void tax_load_builtin(void) {
+    tax_table_count = 0;
+
+    for (int t = 0; t < TAX_BUILTIN_COUNT; t++) {
+        TaxTable table;
+        memset(&table, 0, sizeof(table));
+        table.fy_start = builtin_slabs[t].fy_start;
+        table.n_slabs = builtin_slabs[t].n_slabs;
+        for (int i = 0; i < table.n_slabs; i++) {
+            table.lower[i] = MONEY_RUPEES(builtin_slabs[t].lower_rupees[i]);
+            table.rate_bp[i] = builtin_slabs[t].rate_bp[i];
+        }
+        tax_register(&table);
+    }
+}
+
+static int tax_check_table(const TaxTable *table, const char *path) {
+    if (table->lower[0] != 0) {
+        LOG_ERROR("%s: FY %d must have a slab from 0", path, table->fy_start);
+        return 0;
+    }
+    for (int i = 1; i < table->n_slabs; i++) {
+        if (table->lower[i] <= table->lower[i - 1]) {
+            LOG_ERROR("%s: FY %d slabs must be in ascending order", path, table->fy_start);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Parses the whole file before touching the tables, so a bad file changes
+// nothing. Returns the number of years read, -1 on error.
+static int tax_load_config(const char *path, FILE *in) {
+    TaxTable parsed[TAX_MAX_TABLES];
+    int n_parsed = 0;
+    char line[TAX_LINE_MAX];
+    int line_no = 0;
+
+    while (fgets(line, sizeof(line), in) != NULL) {
+        line_no++;
+
+        char *comment = strchr(line, '#');
+        if (comment != NULL) {
+            *comment = '\0';
+        }
+
+        int fy_start;
+        char from_text[32], rate_text[16], extra[2];
+        int fields = sscanf(line, "%d %31s %15s %1s", &fy_start, from_text, rate_text, extra);
+        if (fields <= 0) {
+            continue;       // blank or comment
+        }
+
+        Money from = 0;
+        Money rate_bp = 0;  // percent with two decimals is basis points
+        if (fields != 3 || fy_start < 1900 || !money_parse(from_text, &from) || from < 0 ||
+            !money_parse(rate_text, &rate_bp) || rate_bp < 0 || rate_bp > 10000) {
+            LOG_ERROR("%s:%d: expected \"<FY start year> <from rupees> <rate %%>\"",
+                      path, line_no);
+            return -1;
+        }
+
+        TaxTable *table = n_parsed > 0 && parsed[n_parsed - 1].fy_start == fy_start
+            ? &parsed[n_parsed - 1] : NULL;
+        if (table == NULL) {
+            for (int t = 0; t < n_parsed; t++) {
+                if (parsed[t].fy_start == fy_start) {
+                    LOG_ERROR("%s:%d: slabs for FY %d must be on consecutive lines",
+                              path, line_no, fy_start);
+                    return -1;
+                }
+            }
+            if (n_parsed == TAX_MAX_TABLES) {
+                LOG_ERROR("%s:%d: too many tax years (max %d)", path, line_no, TAX_MAX_TABLES);
+                return -1;
+            }
+            table = &parsed[n_parsed++];
+            memset(table, 0, sizeof(TaxTable));
+            table->fy_start = fy_start;
+        }
+
+        if (table->n_slabs == TAX_MAX_SLABS) {
+            LOG_ERROR("%s:%d: too many slabs for FY %d (max %d)",
+                      path, line_no, fy_start, TAX_MAX_SLABS);
+            return -1;
+        }
+        table->lower[table->n_slabs] = from;
+        table->rate_bp[table->n_slabs] = (int)rate_bp;
+        table->n_slabs++;
+    }
+
+    for (int t = 0; t < n_parsed; t++) {
+        if (!tax_check_table(&parsed[t], path)) {
+            return -1;
+        }
+    }
+    for (int t = 0; t < n_parsed; t++) {
+        if (!tax_register(&parsed[t])) {
+            return -1;
+        }
+    }
+    return n_parsed;
+}
+
+int tax_financial_year(int month, int year) {
+    return month >= 4 ? year : year - 1;
+}
+
+int tax_init(const char *config_path) {
+    int ok = 1;
+
+    tax_load_builtin();
+
+    const char *path = config_path != NULL ? config_path : TAX_DEFAULT_CONFIG;
+    FILE *in = fopen(path, "r");
+    if (in != NULL) {
+        int years = tax_load_config(path, in);
+        fclose(in);
+        if (years < 0) {
+            LOG_ERROR("Ignoring %s, using the compiled-in tax slabs", path);
+            tax_load_builtin();
+            ok = 0;
+        } else {
+            LOG_INFO("Tax slabs for %d financial year(s) loaded from %s", years, path);
+        }
+    } else if (config_path != NULL) {
+        LOG_ERROR("Cannot open tax slab file: %s", path);
+        ok = 0;
+    }
+
+    time_t now = time(NULL);
+    struct tm *today = localtime(&now);
+    tax_current = tax_table_for_year(tax_financial_year(today->tm_mon + 1, today->tm_year + 1900));
+    return ok;
+}
+
+const TaxTable* tax_table_for_year(int fy_start) {
+    if (tax_table_count == 0) {
+        tax_load_builtin();
+    }
+
+    // Before the first table, its slabs are the best there is
+    const TaxTable *table = &tax_tables[0];
+    for (int t = 1; t < tax_table_count && tax_tables[t].fy_start <= fy_start; t++) {
+        table = &tax_tables[t];
+    }
+    return table;
+}
+
+const TaxTable* tax_table_current(void) {
+    if (tax_current == NULL) {
+        tax_init(NULL);
+    }
+    return tax_current;
+}
+
+Money tax_annual(const TaxTable *table, Money annual_salary) {
+    if (annual_salary <= 0) {
+        return 0;
+    }
+
+    // Slab index = bounds below the salary; a fixed-length count, no search
+    int slab = 0;
+    for (int i = 1; i < table->n_slabs; i++) {
+        slab += annual_salary > table->lower[i];
+    }
+
+    return table->base_tax[slab] +
+        money_percent(annual_salary - table->lower[slab], table->rate_bp[slab]);
+}
+
+Money tax_monthly(const TaxTable *table, Money annual_salary) {
+    return money_divide(tax_annual(table, annual_salary), 12);
+}
+
+void tax_monthly_batch(const TaxTable *table, const Money *annual_salaries,
+                       Money *monthly_tax, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        monthly_tax[i] = tax_monthly(table, annual_salaries[i]);
+    }
+}
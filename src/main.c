@@ -1,13 +1,24 @@
 #include <gtk/gtk.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <time.h>
 #include "../include/database.h"
-int db_create_tables();  
+#include "../include/db_async.h"
+#include "../include/table_fill.h"
 #include "../include/student_ui.h"
 #include "../include/fee_ui.h"
 #include "../include/employee_ui.h"
 #include "../include/payroll.h"
+#include "../include/payroll_run.h"
+#include "../include/tax.h"
 #include "../include/payroll_ui.h"
+#include "../include/logger.h"
+#include "../include/db_latency.h"
+#include "../include/latency_ui.h"
+#ifdef G_OS_UNIX
+#include <glib-unix.h>
+#include <signal.h>
+#endif
 
 GtkWidget *main_window;
 GtkWidget *content_notebook;
@@ -18,47 +29,195 @@ void on_sidebar_button_clicked(GtkButton *button, gpointer user_data) {
     (void)button;
     int page_num = GPOINTER_TO_INT(user_data);
     gtk_notebook_set_current_page(GTK_NOTEBOOK(content_notebook), page_num);
-    printf("[INFO] Switched to module page %d\n", page_num);
+    LOG_INFO("Switched to module page %d", page_num);
+}
+
+
+// --startup-trace: a timeline of startup on stderr, each phase with the time
+// since main() began and since the phase before it
+static int startup_trace = 0;
+static gint64 startup_origin = 0;
+static gint64 startup_last = 0;
+
+static void startup_mark(const char *phase) {
+    if (!startup_trace) {
+        return;
+    }
+
+    gint64 now = g_get_monotonic_time();
+    fprintf(stderr, "[startup] %9.1f ms  (+%8.1f ms)  %s\n",
+            (now - startup_origin) / 1000.0, (now - startup_last) / 1000.0, phase);
+    startup_last = now;
+}
+
+static gboolean on_first_draw(GtkWidget *widget, cairo_t *cr, gpointer user_data) {
+    (void)cr;
+    (void)user_data;
+
+    g_signal_handlers_disconnect_by_func(widget, G_CALLBACK(on_first_draw), NULL);
+    startup_mark("first frame drawn");
+    return FALSE;
+}
+
+static void on_search_index_ready(int ok, void *user_data) {
+    (void)user_data;
+    startup_mark(ok ? "search index ready" : "search index unavailable (LIKE search)");
+}
+
+
+// The module pages, built on first use. Page 0, the dashboard, is built
+// with the window.
+typedef struct {
+    const char *name;
+    void (*create)(GtkWidget *container);
+    void (*page_shown)(void);
+    GtkWidget *container;
+    gboolean built;
+} ModulePage;
+
+static ModulePage module_pages[] = {
+    { "Dashboard", NULL,               NULL,                   NULL, TRUE  },
+    { "Students",  create_student_ui,  student_ui_page_shown,  NULL, FALSE },
+    { "Employees", create_employee_ui, employee_ui_page_shown, NULL, FALSE },
+    { "Fees",      create_fee_ui,      fee_ui_page_shown,      NULL, FALSE },
+    { "Payroll",   create_payroll_ui,  payroll_ui_page_shown,  NULL, FALSE },
+};
+
+#define MODULE_PAGE_COUNT ((int)G_N_ELEMENTS(module_pages))
+
+// Table loads for the page being left are stale work: cancel them. A page
+// whose own load was cut short earlier reloads when it is shown again; a
+// page never shown before is built now, which starts its first load.
+static void on_content_page_switched(GtkNotebook *notebook, GtkWidget *page,
+                                     guint page_num, gpointer user_data) {
+    (void)notebook;
+    (void)page;
+    (void)user_data;
+
+    db_async_cancel_all();
+
+    if (page_num >= (guint)MODULE_PAGE_COUNT) {
+        return;
+    }
+
+    ModulePage *module = &module_pages[page_num];
+    if (module->built) {
+        if (module->page_shown != NULL) {
+            module->page_shown();
+        }
+        return;
+    }
+
+    gint64 started = g_get_monotonic_time();
+    module->create(module->container);
+    module->built = TRUE;
+
+    char phase[64];
+    snprintf(phase, sizeof(phase), "%s page built (%.1f ms)",
+             module->name, (g_get_monotonic_time() - started) / 1000.0);
+    startup_mark(phase);
+}
+
+
+// Ctrl+Shift+L shows the hidden latency panel on the dashboard
+static gboolean on_main_window_key_press(GtkWidget *widget, GdkEventKey *event, gpointer user_data) {
+    (void)widget;
+    (void)user_data;
+
+    GdkModifierType mods = event->state & gtk_accelerator_get_default_mod_mask();
+    if (mods == (GDK_CONTROL_MASK | GDK_SHIFT_MASK) &&
+        (event->keyval == GDK_KEY_L || event->keyval == GDK_KEY_l)) {
+        gtk_notebook_set_current_page(GTK_NOTEBOOK(content_notebook), 0);
+        latency_ui_toggle();
+        return TRUE;
+    }
+    return FALSE;
 }
 
 
 void on_window_destroy(GtkWidget *widget, gpointer data) {
     (void)widget;
     (void)data;
-    printf("[INFO] Main window destroyed\n");
+    LOG_INFO("Main window destroyed");
     gtk_main_quit();
 }
 
 void on_add_student(GtkButton *button, gpointer user_data) {
     (void)button;
     (void)user_data;
-    printf("[INFO] Add Student button clicked - navigating to Student Management\n");
+    LOG_INFO("Add Student button clicked - navigating to Student Management");
     gtk_notebook_set_current_page(GTK_NOTEBOOK(content_notebook), 1);
 }
 
 void on_add_employee(GtkButton *button, gpointer user_data) {
     (void)button;
     (void)user_data;
-    printf("[INFO] Add Employee button clicked - navigating to Employee Management\n");
+    LOG_INFO("Add Employee button clicked - navigating to Employee Management");
     gtk_notebook_set_current_page(GTK_NOTEBOOK(content_notebook), 2);
 }
 
 void on_generate_fee_receipt_clicked(GtkButton *button, gpointer user_data) {
     (void)button;
     (void)user_data;
-    printf("[INFO] Generate Fee Receipt button clicked - navigating to Fee Management\n");
+    LOG_INFO("Generate Fee Receipt button clicked - navigating to Fee Management");
     gtk_notebook_set_current_page(GTK_NOTEBOOK(content_notebook), 3);
 }
 
 void on_generate_payroll_clicked(GtkButton *button, gpointer user_data) {
     (void)button;
     (void)user_data;
-    printf("[INFO] Generate Payroll button clicked - navigating to Payroll Management\n");
+    LOG_INFO("Generate Payroll button clicked - navigating to Payroll Management");
     gtk_notebook_set_current_page(GTK_NOTEBOOK(content_notebook), 4);
 }
 
 
 
+// Dashboard stat values, refilled whenever the counters change
+static GtkWidget *stat_students_value = NULL;
+static GtkWidget *stat_employees_value = NULL;
+static GtkWidget *stat_payroll_value = NULL;
+
+static void dashboard_set_stat(GtkWidget *label, const char *color, const char *text) {
+    char *markup = g_markup_printf_escaped(
+        "<span font='20' weight='bold' foreground='%s'>%s</span>", color, text);
+    gtk_label_set_markup(GTK_LABEL(label), markup);
+    g_free(markup);
+}
+
+// Reads DashboardStats (a few rows, no table scans); also the
+// db_stats_watch() callback, so the cards follow every save
+static void dashboard_refresh_stats(void *user_data) {
+    (void)user_data;
+
+    if (stat_students_value == NULL) {
+        return;
+    }
+
+    // Gross for the current month, in the "Mon-YYYY" form the payroll form saves
+    static const char *months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                   "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+    time_t now = time(NULL);
+    struct tm *today = localtime(&now);
+    char month_year[20];
+    snprintf(month_year, sizeof(month_year), "%s-%d", months[today->tm_mon], today->tm_year + 1900);
+
+    DashboardStats stats = {0};
+    int ok = db_get_dashboard_stats(month_year, &stats);
+
+    char text[MONEY_TEXT_SIZE + 8];
+    char amount[MONEY_TEXT_SIZE];
+
+    snprintf(text, sizeof(text), "%d", stats.students);
+    dashboard_set_stat(stat_students_value, "#2196F3", ok ? text : "—");
+
+    snprintf(text, sizeof(text), "%d", stats.employees);
+    dashboard_set_stat(stat_employees_value, "#FF9800", ok ? text : "—");
+
+    snprintf(text, sizeof(text), "₹ %s", money_format(stats.month_payroll, amount, sizeof(amount)));
+    dashboard_set_stat(stat_payroll_value, "#4CAF50", ok ? text : "—");
+}
+
+
 GtkWidget* create_dashboard_ui() {
     GtkWidget *dashboard_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 15);
     gtk_widget_set_margin_start(dashboard_box, 30);
@@ -114,13 +273,8 @@ GtkWidget* create_dashboard_ui() {
         "<span font='13' weight='bold' foreground='#555555'>👨‍🎓 Total Students</span>");
     gtk_grid_attach(GTK_GRID(stats_grid), stat1_title, 0, 0, 1, 1);
 
-    GtkWidget *stat1_value = gtk_label_new(NULL);
-    int student_count = db_get_student_count();
-    char count_markup[100];
-    snprintf(count_markup, sizeof(count_markup),
-        "<span font='20' weight='bold' foreground='#2196F3'>%d</span>", student_count);
-    gtk_label_set_markup(GTK_LABEL(stat1_value), count_markup);
-    gtk_grid_attach(GTK_GRID(stats_grid), stat1_value, 0, 1, 1, 1);
+    stat_students_value = gtk_label_new(NULL);
+    gtk_grid_attach(GTK_GRID(stats_grid), stat_students_value, 0, 1, 1, 1);
 
 
     // Stat 2: Total Employees
@@ -129,13 +283,8 @@ GtkWidget* create_dashboard_ui() {
         "<span font='13' weight='bold' foreground='#555555'>👨‍💼 Total Employees</span>");
     gtk_grid_attach(GTK_GRID(stats_grid), stat2_title, 1, 0, 1, 1);
 
-    GtkWidget *stat2_value = gtk_label_new(NULL);
-    int employee_count = db_get_employee_count();  
-    char emp_markup[100];
-    snprintf(emp_markup, sizeof(emp_markup),
-        "<span font='20' weight='bold' foreground='#FF9800'>%d</span>", employee_count);
-    gtk_label_set_markup(GTK_LABEL(stat2_value), emp_markup);
-    gtk_grid_attach(GTK_GRID(stats_grid), stat2_value, 1, 1, 1, 1);
+    stat_employees_value = gtk_label_new(NULL);
+    gtk_grid_attach(GTK_GRID(stats_grid), stat_employees_value, 1, 1, 1, 1);
 
     // Stat 3: Pending Fees
     GtkWidget *stat3_title = gtk_label_new(NULL);
@@ -143,10 +292,11 @@ GtkWidget* create_dashboard_ui() {
         "<span font='13' weight='bold' foreground='#555555'>💰 Pending Fees</span>");
     gtk_grid_attach(GTK_GRID(stats_grid), stat3_title, 2, 0, 1, 1);
 
-    GtkWidget *stat3_value = gtk_label_new(NULL);
-    gtk_label_set_markup(GTK_LABEL(stat3_value),
-        "<span font='20' weight='bold' foreground='#F44336'>Loading...</span>");
-    gtk_grid_attach(GTK_GRID(stats_grid), stat3_value, 2, 1, 1, 1);
+    // Fees records payments only; nothing in the schema says what is due
+    GtkWidget *stat_pending_fees_value = gtk_label_new(NULL);
+    dashboard_set_stat(stat_pending_fees_value, "#9E9E9E", "N/A");
+    gtk_widget_set_tooltip_text(stat_pending_fees_value, "No fee dues are recorded, only payments");
+    gtk_grid_attach(GTK_GRID(stats_grid), stat_pending_fees_value, 2, 1, 1, 1);
 
 
     // Stat 4: Monthly Payroll
@@ -155,10 +305,11 @@ GtkWidget* create_dashboard_ui() {
         "<span font='13' weight='bold' foreground='#555555'>💵 Monthly Payroll</span>");
     gtk_grid_attach(GTK_GRID(stats_grid), stat4_title, 3, 0, 1, 1);
 
-    GtkWidget *stat4_value = gtk_label_new(NULL);
-    gtk_label_set_markup(GTK_LABEL(stat4_value),
-        "<span font='20' weight='bold' foreground='#4CAF50'>Loading...</span>");
-    gtk_grid_attach(GTK_GRID(stats_grid), stat4_value, 3, 1, 1, 1);
+    stat_payroll_value = gtk_label_new(NULL);
+    gtk_grid_attach(GTK_GRID(stats_grid), stat_payroll_value, 3, 1, 1, 1);
+
+    dashboard_refresh_stats(NULL);
+    db_stats_watch(dashboard_refresh_stats, NULL);
 
     gtk_box_pack_start(GTK_BOX(dashboard_box), stats_frame, FALSE, FALSE, 0);
 
@@ -251,6 +402,9 @@ GtkWidget* create_dashboard_ui() {
 
     gtk_box_pack_start(GTK_BOX(dashboard_box), activities_frame, FALSE, FALSE, 0);
 
+    // Hidden until Ctrl+Shift+L
+    gtk_box_pack_start(GTK_BOX(dashboard_box), latency_ui_create_panel(), FALSE, FALSE, 0);
+
 
     // Add scrollable area for future expansion
     GtkWidget *scrolled = gtk_scrolled_window_new(NULL, NULL);
@@ -263,7 +417,7 @@ GtkWidget* create_dashboard_ui() {
     gtk_widget_set_vexpand_set(scrolled, TRUE);
     gtk_widget_set_hexpand_set(scrolled, TRUE);
 
-    printf("[INFO] Redesigned Dashboard UI created successfully\n");
+    LOG_INFO("Redesigned Dashboard UI created successfully");
     return scrolled;
 }
 
@@ -275,7 +429,7 @@ void create_main_window() {
     gtk_window_set_default_size(GTK_WINDOW(main_window), 1000, 700);
     gtk_window_set_position(GTK_WINDOW(main_window), GTK_WIN_POS_CENTER);
    
-    printf("[INFO] Main window created\n");
+    LOG_INFO("Main window created");
 
 
     GtkWidget *main_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 0);
@@ -333,8 +487,7 @@ void create_main_window() {
     };
 
 
-    printf("[INFO] Creating sidebar buttons\n");
-        printf("[INFO] Creating sidebar buttons\n");
+    LOG_INFO("Creating sidebar buttons");
     for (int i = 0; i < 5; i++) {
         sidebar_buttons[i] = gtk_button_new_with_label(button_labels[i]);
         gtk_widget_set_size_request(sidebar_buttons[i], -1, 60);
@@ -362,7 +515,7 @@ void create_main_window() {
     gtk_box_pack_start(GTK_BOX(content_box), content_notebook, TRUE, TRUE, 0);
 
 
-    printf("[INFO] Creating notebook pages\n");
+    LOG_INFO("Creating notebook pages");
 
 
     // Page 0: Dashboard with financial overview
@@ -370,28 +523,12 @@ void create_main_window() {
     gtk_notebook_append_page(GTK_NOTEBOOK(content_notebook), dashboard_page, NULL);
 
 
-    // Page 1: Student Management
-    GtkWidget *student_container = gtk_box_new(GTK_ORIENTATION_VERTICAL, 0);
-    create_student_ui(student_container);
-    gtk_notebook_append_page(GTK_NOTEBOOK(content_notebook), student_container, NULL);
-
-
-    // Page 2: Employee Management
-    GtkWidget *employee_container = gtk_box_new(GTK_ORIENTATION_VERTICAL, 0);
-    create_employee_ui(employee_container);
-    gtk_notebook_append_page(GTK_NOTEBOOK(content_notebook), employee_container, NULL);
-
-
-    // Page 3: Fee Management
-    GtkWidget *fee_container = gtk_box_new(GTK_ORIENTATION_VERTICAL, 0);
-    create_fee_ui(fee_container);
-    gtk_notebook_append_page(GTK_NOTEBOOK(content_notebook), fee_container, NULL);
-
-
-    // Page 4: Payroll Management
-    GtkWidget *payroll_tab = gtk_box_new(GTK_ORIENTATION_VERTICAL, 0);
-    create_payroll_ui(payroll_tab);
-    gtk_notebook_append_page(GTK_NOTEBOOK(content_notebook), payroll_tab, NULL);
+    // Pages 1-4 start as empty boxes; each module is built the first time
+    // its page is selected (see on_content_page_switched)
+    for (int i = 1; i < MODULE_PAGE_COUNT; i++) {
+        module_pages[i].container = gtk_box_new(GTK_ORIENTATION_VERTICAL, 0);
+        gtk_notebook_append_page(GTK_NOTEBOOK(content_notebook), module_pages[i].container, NULL);
+    }
 
 
     // Footer
@@ -410,41 +547,221 @@ void create_main_window() {
 
 
     g_signal_connect(main_window, "destroy", G_CALLBACK(on_window_destroy), NULL);
-    printf("[INFO] Main UI creation complete\n");
+    g_signal_connect(main_window, "key-press-event", G_CALLBACK(on_main_window_key_press), NULL);
+    LOG_INFO("Main UI creation complete");
 }
 
 
+// --latency-json=PATH: where the latency histograms go at exit and on SIGUSR1
+static const char *latency_json = NULL;
+
+static void dump_latency_at_exit(void) {
+    db_latency_dump_json(latency_json);
+}
+
+#ifdef G_OS_UNIX
+static gboolean on_latency_signal(gpointer user_data) {
+    (void)user_data;
+    db_latency_dump_json(latency_json);
+    return G_SOURCE_CONTINUE;
+}
+#endif
+
+
 int main(int argc, char *argv[]) {
+    startup_origin = startup_last = g_get_monotonic_time();
+
     printf("\n");
     printf("╔════════════════════════════════════════════════════════════════╗\n");
     printf("║                   College Finance Management System            ║\n");
     printf("║               L.D.A.H Rajkiya Engineering College Mainpuri     ║\n");
     printf("╚════════════════════════════════════════════════════════════════╝\n");
     printf("\n");
-    printf("[INFO] Initializing database...\n");
-    if (!db_init("data/college_finance.db")) {
-        printf("[ERROR] Database init failed\n");
+    // Connection profile: --db-profile=NAME wins over CFMS_DB_PROFILE.
+    // Our options are removed from argv so GTK never sees them.
+    const char *profile = getenv("CFMS_DB_PROFILE");
+    int rebuild_fee_summary = 0;
+    const char *import_fees = NULL;
+    const char *import_students = NULL;
+    int import_batch = 0;               // 0: each importer's default
+    int check_query_plans = 0;
+    int bench_table_fill = 0;
+    const char *payroll_run = NULL;
+    int payroll_dry_run = 0;
+    const char *tax_slabs = NULL;
+    const char *log_level = NULL;
+    int kept = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--db-profile=", 13) == 0) {
+            profile = argv[i] + 13;
+        } else if (strcmp(argv[i], "--rebuild-fee-summary") == 0) {
+            rebuild_fee_summary = 1;
+        } else if (strcmp(argv[i], "--check-query-plans") == 0) {
+            check_query_plans = 1;
+        } else if (strcmp(argv[i], "--bench-table-fill") == 0) {
+            bench_table_fill = 50000;
+        } else if (strncmp(argv[i], "--bench-table-fill=", 19) == 0) {
+            bench_table_fill = atoi(argv[i] + 19);
+        } else if (strncmp(argv[i], "--import-fees=", 14) == 0) {
+            import_fees = argv[i] + 14;
+        } else if (strncmp(argv[i], "--import-students=", 18) == 0) {
+            import_students = argv[i] + 18;
+        } else if (strncmp(argv[i], "--import-batch=", 15) == 0) {
+            import_batch = atoi(argv[i] + 15);
+        } else if (strncmp(argv[i], "--payroll-run=", 14) == 0) {
+            payroll_run = argv[i] + 14;
+        } else if (strcmp(argv[i], "--payroll-dry-run") == 0) {
+            payroll_dry_run = 1;
+        } else if (strncmp(argv[i], "--tax-slabs=", 12) == 0) {
+            tax_slabs = argv[i] + 12;
+        } else if (strncmp(argv[i], "--log-level=", 12) == 0) {
+            log_level = argv[i] + 12;
+        } else if (strncmp(argv[i], "--latency-json=", 15) == 0) {
+            latency_json = argv[i] + 15;
+        } else if (strcmp(argv[i], "--startup-trace") == 0) {
+            startup_trace = 1;
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    argc = kept;
+    argv[argc] = NULL;
+
+    // Console plus logs/college_finance.log; --log-level= wins over CFMS_LOG_LEVEL
+    log_init(NULL);
+    if (log_level != NULL) {
+        int level = log_level_from_name(log_level);
+        if (level < 0) {
+            LOG_ERROR("Unknown log level '%s' (debug, info, success, warning, error, off)", log_level);
+            return 1;
+        }
+        log_set_level((LogLevel)level);
+    }
+    startup_mark("logger ready");
+
+    // Registered after the logger, so it runs while the logger is still up
+    if (latency_json != NULL) {
+        atexit(dump_latency_at_exit);
+    }
+
+    if (profile != NULL) {
+        db_set_profile(profile);
+    }
+
+    // Benchmark mode: GtkListStore refresh, row by row vs bulk; no database
+    if (bench_table_fill) {
+        return table_fill_benchmark(bench_table_fill);
+    }
+
+    // Compiled-in slabs, replaced per year by data/tax_slabs.conf or --tax-slabs=
+    if (!tax_init(tax_slabs) && tax_slabs != NULL) {
         return 1;
     }
-    if (!db_create_tables()) {
-        printf("[ERROR] Failed to create tables: %s\n", db_get_error());
+    startup_mark("tax slabs loaded");
+
+    // The plan check seeds its own throwaway database, never the real one
+    const char *db_path = check_query_plans ? ":memory:" : "data/college_finance.db";
+
+    LOG_INFO("Initializing database...");
+    if (!db_init(db_path)) {
+        LOG_ERROR("Database init failed");
+        return 1;
+    }
+    startup_mark("database opened");
+
+    // Pending migrations must run before anything reads the schema; on an
+    // up-to-date database this is a single PRAGMA
+    if (!db_migrate()) {
+        LOG_ERROR("Failed to create tables: %s", db_get_error());
         db_close();
         return 1;
     }
-    printf("[INFO] Database tables initialized\n");
-    printf("[INFO] Initializing GTK...\n");
+    LOG_INFO("Database tables initialized");
+    startup_mark("schema up to date");
+
+    // Batch modes build a missing search index up front; the window does it
+    // in the background once it is on screen
+    int batch_mode = rebuild_fee_summary || check_query_plans || import_fees != NULL ||
+                     import_students != NULL || payroll_run != NULL;
+    if (batch_mode) {
+        db_create_search_index();
+    }
+
+    // Maintenance mode: verify/repair FeeSummary against Fees, and recount
+    // the dashboard stats while at it, no UI
+    if (rebuild_fee_summary) {
+        int repaired = 0;
+        int ok = db_rebuild_fee_summary(&repaired);
+        if (ok) {
+            LOG_SUCCESS("Fee summary rebuild complete: %d row(s) repaired", repaired);
+        } else {
+            LOG_ERROR("Fee summary rebuild failed: %s", db_get_error());
+        }
+        ok = db_rebuild_dashboard_stats() && ok;
+        db_close();
+        return ok ? 0 : 1;
+    }
+
+    // Diagnostic mode: fail if any hot query falls back to a full table scan
+    if (check_query_plans) {
+        int failures = db_run_query_plan_check();
+        db_close();
+        return failures == 0 ? 0 : 1;
+    }
+
+    // Batch mode: load a bank/UPI settlement file into the fee ledger, no UI
+    if (import_fees != NULL) {
+        FeeImportStats stats;
+        int ok = db_import_fee_settlement(import_fees, import_batch, &stats);
+        db_close();
+        return ok ? 0 : 1;
+    }
+
+    // Batch mode: load an admission list (CSV or TSV) into Students, no UI
+    if (import_students != NULL) {
+        StudentImportStats stats;
+        int ok = db_import_students(import_students, import_batch, &stats);
+        db_close();
+        return ok ? 0 : 1;
+    }
+
+    // Batch mode: pay every active employee for a month, no UI. Fails if
+    // any employee was left out, so a script knows to fix and re-run.
+    if (payroll_run != NULL) {
+        PayrollRunStats stats;
+        int ok = payroll_run_month(payroll_run, payroll_dry_run, &stats);
+        db_close();
+        return ok && stats.failed == 0 ? 0 : 1;
+    }
+
+    LOG_INFO("Initializing GTK...");
     gtk_init(&argc, &argv);
+    startup_mark("GTK initialized");
+
     create_main_window();
-    printf("[INFO] Showing main window\n");
+    g_signal_connect(content_notebook, "switch-page", G_CALLBACK(on_content_page_switched), NULL);
+    startup_mark("main window built");
+
+    LOG_INFO("Showing main window");
+    if (startup_trace) {
+        g_signal_connect(main_window, "draw", G_CALLBACK(on_first_draw), NULL);
+    }
     gtk_widget_show_all(main_window);
     gtk_notebook_set_current_page(GTK_NOTEBOOK(content_notebook), 0);
-    printf("[INFO] Dashboard loaded on startup\n");
+    LOG_INFO("Dashboard loaded on startup");
+    startup_mark("main window shown");
+
+    db_create_search_index_async(on_search_index_ready, NULL);
     
-    printf("[INFO] Application started - waiting for user interaction\n\n");
+    LOG_INFO("Application started - waiting for user interaction");
+#ifdef G_OS_UNIX
+    // kill -USR1 <pid> writes the latency report without stopping the app
+    g_unix_signal_add(SIGUSR1, on_latency_signal, NULL);
+#endif
     gtk_main();
-    printf("\n[INFO] Cleaning up...\n");
+    LOG_INFO("Cleaning up...");
+    db_async_shutdown();
     db_close();
-    printf("[INFO] Application closed successfully\n");
-    printf("\n");
+    LOG_INFO("Application closed successfully");
     return 0;
 }
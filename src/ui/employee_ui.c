@@ -4,13 +4,16 @@
 #include <stdlib.h>
 #include "../../include/employee_ui.h"
 #include "../../include/database.h"
+#include "../../include/db_async.h"
+#include "../../include/db_tree_model.h"
+#include "../../include/table_fill.h"
 #include "../../include/validators.h"
+#include "../../include/logger.h"
 
 // Global Variables
 static GtkWidget *employee_table = NULL;
 static GtkWidget *form_box = NULL;
 static GtkWidget *main_box = NULL;
-static GtkListStore *employee_store = NULL;
 
 // Employee Details
 static GtkWidget *emp_no_entry;
@@ -61,66 +64,165 @@ void clear_employee_form(void) {
     editing_emp_id = -1;
 }
 
-void refresh_employee_list(void) {
-    printf("[INFO] Refreshing employee table\n");
-    
-    if (!employee_store) return;
-    gtk_list_store_clear(employee_store);
-    
-    sqlite3_stmt *stmt = NULL;
-    if (db_get_all_employees(&stmt) == 0 || stmt == NULL) {
-        printf("[WARNING] No employees found\n");
-        return;
-    }
-    
+// The full table is a virtual model over db_employee_list_sql, counted in
+// the background; a count cut short by a tab switch leaves the table stale
+// until the page is shown again. Search results go into employee_store.
+static GCancellable *employee_load = NULL;
+static gboolean employee_table_stale = FALSE;
+static GtkListStore *employee_store = NULL;
+
+#define EMPLOYEE_COLUMNS 16
+
+// 0-1: edit/delete icons, 2: emp_id (hidden), 3-15: shown columns, all text
+static const GType employee_column_types[EMPLOYEE_COLUMNS] = {
+    G_TYPE_STRING, G_TYPE_STRING, G_TYPE_INT, G_TYPE_STRING,
+    G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING,
+    G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING,
+    G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING
+};
+
+static void append_employee_row(GtkListStore *store, int emp_id, int emp_no, const char *emp_name,
+                                const char *emp_dob, const char *dept, const char *desig,
+                                const char *cat, const char *rep_name, int rep_id, const char *email,
+                                const char *mobile, const char *addr, Money salary,
+                                const char *status) {
+    char emp_no_str[20], rep_id_str[20], salary_str[MONEY_TEXT_SIZE];  
+    snprintf(emp_no_str, sizeof(emp_no_str), "%d", emp_no);
+    snprintf(rep_id_str, sizeof(rep_id_str), "%d", rep_id);
+    money_format(salary, salary_str, sizeof(salary_str));
+    
+    gtk_list_store_insert_with_values(store, NULL, -1,
+        0, "✏️",                    // Edit
+        1, "🗑️",                    // Delete
+        2, emp_id,                  // ID (hidden)
+        3, emp_no_str,              
+        4, emp_name ? emp_name : "—",
+        5, emp_dob ? emp_dob : "—",
+        6, dept ? dept : "—",
+        7, desig ? desig : "—",
+        8, cat ? cat : "—",
+        9, rep_name ? rep_name : "—",
+        10, rep_id_str,
+        11, email ? email : "—",
+        12, mobile ? mobile : "—",
+        13, addr ? addr : "—",
+        14, salary_str,
+        15, status ? status : "—",
+        -1);
+}
+
+// Appends every row of a db_get_all_employees()-shaped statement and
+// finalizes it; returns the number of rows added
+static int append_employee_rows(GtkListStore *store, sqlite3_stmt *stmt) {
     int count = 0;
     while (sqlite3_step(stmt) == SQLITE_ROW) {
         // Read all 14 columns from SELECT
-        int emp_id = sqlite3_column_int(stmt, 0);
-        int emp_no = sqlite3_column_int(stmt, 1);
-        const char *emp_name = (const char *)sqlite3_column_text(stmt, 2);
-        const char *emp_dob = (const char *)sqlite3_column_text(stmt, 3);
-        const char *dept = (const char *)sqlite3_column_text(stmt, 4);
-        const char *desig = (const char *)sqlite3_column_text(stmt, 5);
-        const char *cat = (const char *)sqlite3_column_text(stmt, 6);
-        const char *rep_name = (const char *)sqlite3_column_text(stmt, 7);
-        int rep_id = sqlite3_column_int(stmt, 8);
-        const char *email = (const char *)sqlite3_column_text(stmt, 9);
-        const char *mobile = (const char *)sqlite3_column_text(stmt, 10);
-        const char *addr = (const char *)sqlite3_column_text(stmt, 11);
-        double salary = sqlite3_column_double(stmt, 12);
-        const char *status = (const char *)sqlite3_column_text(stmt, 13);
-        
-        char emp_no_str[20], rep_id_str[20], salary_str[20];  
-        snprintf(emp_no_str, sizeof(emp_no_str), "%d", emp_no);
-        snprintf(rep_id_str, sizeof(rep_id_str), "%d", rep_id);
-        snprintf(salary_str, sizeof(salary_str), "%.2f", salary);
-        
-        GtkTreeIter iter;
-        gtk_list_store_append(employee_store, &iter);
-        gtk_list_store_set(employee_store, &iter,
-            0, "✏️",                    // Edit
-            1, "🗑️",                    // Delete
-            2, emp_id,                  // ID (hidden)
-            3, emp_no_str,              
-            4, emp_name ? emp_name : "—",
-            5, emp_dob ? emp_dob : "—",
-            6, dept ? dept : "—",
-            7, desig ? desig : "—",
-            8, cat ? cat : "—",
-            9, rep_name ? rep_name : "—",
-            10, rep_id_str,
-            11, email ? email : "—",
-            12, mobile ? mobile : "—",
-            13, addr ? addr : "—",
-            14, salary_str,
-            15, status ? status : "—",
-            -1);
+        append_employee_row(store,
+            sqlite3_column_int(stmt, 0),
+            sqlite3_column_int(stmt, 1),
+            (const char *)sqlite3_column_text(stmt, 2),
+            (const char *)sqlite3_column_text(stmt, 3),
+            (const char *)sqlite3_column_text(stmt, 4),
+            (const char *)sqlite3_column_text(stmt, 5),
+            (const char *)sqlite3_column_text(stmt, 6),
+            (const char *)sqlite3_column_text(stmt, 7),
+            sqlite3_column_int(stmt, 8),
+            (const char *)sqlite3_column_text(stmt, 9),
+            (const char *)sqlite3_column_text(stmt, 10),
+            (const char *)sqlite3_column_text(stmt, 11),
+            sqlite3_column_int64(stmt, 12),
+            (const char *)sqlite3_column_text(stmt, 13));
         count++;
     }
     
     sqlite3_finalize(stmt);
-    printf("[INFO] Loaded %d employees\n", count);
+    return count;
+}
+
+// table_fill_list_store() callback for employee_store
+static void fill_employee_rows(GtkListStore *store, gpointer user_data) {
+    append_employee_rows(store, (sqlite3_stmt *)user_data);
+}
+
+// Fills one cell of the virtual model, formatted as append_employee_row()
+// does. Table column c shows query column c - 2 (db_employee_list_sql order).
+static void employee_model_value(const DbAsyncChunk *page, int row, int column, GValue *value, gpointer user_data) {
+    (void)user_data;
+
+    switch (column) {
+        case 0:
+            g_value_set_string(value, "✏️");
+            break;
+        case 1:
+            g_value_set_string(value, "🗑️");
+            break;
+        case 2:
+            g_value_set_int(value, db_async_int(page, row, 0));
+            break;
+        case 3:
+        case 10:
+            g_value_take_string(value, g_strdup_printf("%d", db_async_int(page, row, column - 2)));
+            break;
+        case 14: {
+            char salary_str[MONEY_TEXT_SIZE];
+            g_value_set_string(value, money_format(db_async_int64(page, row, 12), salary_str, sizeof(salary_str)));
+            break;
+        }
+        default: {
+            const char *text = db_async_text(page, row, column - 2);
+            g_value_set_string(value, text ? text : "—");
+            break;
+        }
+    }
+}
+
+static void on_employee_model_ready(DbTreeModel *model, GCancellable *load, gboolean cancelled, gpointer user_data) {
+    (void)user_data;
+
+    // A newer refresh or a search has replaced this load
+    if (load != employee_load) {
+        return;
+    }
+    g_clear_object(&employee_load);
+
+    if (cancelled) {
+        employee_table_stale = TRUE;
+        LOG_INFO("Employee table load cancelled");
+        return;
+    }
+
+    int total_rows = db_tree_model_get_n_rows(model);
+    gtk_tree_view_set_model(GTK_TREE_VIEW(employee_table), GTK_TREE_MODEL(model));
+
+    if (total_rows == 0) {
+        LOG_WARNING("No employees found");
+        return;
+    }
+    LOG_INFO("Loaded %d employees", total_rows);
+}
+
+void refresh_employee_list(void) {
+    LOG_INFO("Refreshing employee table");
+    
+    if (!employee_table) return;
+
+    db_async_cancel(&employee_load);
+    employee_table_stale = FALSE;
+    
+    DbTreeModel *model = db_tree_model_new(db_employee_list_sql, NULL, EMPLOYEE_COLUMNS,
+                                           employee_column_types, employee_model_value, NULL);
+    employee_load = db_tree_model_load(model, on_employee_model_ready, NULL);
+    g_object_unref(model);
+
+    if (employee_load == NULL) {
+        LOG_ERROR("Failed to start employee table load");
+    }
+}
+
+void employee_ui_page_shown(void) {
+    if (employee_table_stale) {
+        refresh_employee_list();
+    }
 }
 
 void on_add_employee_clicked(GtkButton *button, gpointer user_data) {
@@ -163,7 +265,7 @@ void on_save_employee_clicked(GtkButton *button, gpointer user_data) {
     strncpy(emp.email, gtk_entry_get_text(GTK_ENTRY(email_entry)), sizeof(emp.email) - 1);
     strncpy(emp.mobile_number, gtk_entry_get_text(GTK_ENTRY(mobile_entry)), sizeof(emp.mobile_number) - 1);
     strncpy(emp.address, gtk_entry_get_text(GTK_ENTRY(address_entry)), sizeof(emp.address) - 1);
-    emp.base_salary = atof(gtk_entry_get_text(GTK_ENTRY(salary_entry)));
+    int salary_ok = money_parse(gtk_entry_get_text(GTK_ENTRY(salary_entry)), &emp.base_salary);
     strncpy(emp.status, "Active", sizeof(emp.status) - 1);
     
     // Collect bank data
@@ -207,6 +309,14 @@ void on_save_employee_clicked(GtkButton *button, gpointer user_data) {
         return;
     }
     
+    if (!salary_ok || emp.base_salary < 0) {
+        GtkWidget *d = gtk_message_dialog_new(NULL, GTK_DIALOG_MODAL, GTK_MESSAGE_ERROR, GTK_BUTTONS_OK,
+            "❌ Invalid salary (e.g. 45000 or 45000.50)");
+        gtk_dialog_run(GTK_DIALOG(d));
+        gtk_widget_destroy(d);
+        return;
+    }
+    
     // Save
     int emp_id;
     if (editing_emp_id > 0) {
@@ -242,6 +352,38 @@ void on_save_employee_clicked(GtkButton *button, gpointer user_data) {
     }
 }
 
+static void on_employee_search_find(GtkButton *button, gpointer user_data) {
+    (void)button;
+    
+    const char *text = gtk_entry_get_text(GTK_ENTRY(user_data));
+    if (!text || strlen(text) == 0) {
+        refresh_employee_list();
+        return;
+    }
+    
+    LOG_INFO("Searching employees: %s", text);
+    
+    if (!employee_table) return;
+    db_async_cancel(&employee_load);
+    
+    sqlite3_stmt *stmt = NULL;
+    if (db_search_employees(text, &stmt) != 0 || stmt == NULL) {
+        LOG_ERROR("Employee search failed");
+        return;
+    }
+    
+    int count = table_fill_list_store(GTK_TREE_VIEW(employee_table), employee_store,
+                                      fill_employee_rows, stmt);
+    LOG_INFO("Found %d employee(s)", count);
+}
+
+static void on_employee_search_clear(GtkButton *button, gpointer user_data) {
+    (void)button;
+    
+    gtk_entry_set_text(GTK_ENTRY(user_data), "");
+    refresh_employee_list();
+}
+
 void on_search_employee_clicked(GtkButton *button, gpointer user_data) {
     (void)button;
     (void)user_data;
@@ -271,6 +413,10 @@ void on_search_employee_clicked(GtkButton *button, gpointer user_data) {
         gtk_box_pack_start(GTK_BOX(search_box), search_do_btn, FALSE, FALSE, 0);
         gtk_box_pack_start(GTK_BOX(search_box), search_clear_btn, FALSE, FALSE, 0);
         
+        g_signal_connect(search_do_btn, "clicked", G_CALLBACK(on_employee_search_find), search_entry);
+        g_signal_connect(search_entry, "activate", G_CALLBACK(on_employee_search_find), search_entry);
+        g_signal_connect(search_clear_btn, "clicked", G_CALLBACK(on_employee_search_clear), search_entry);
+        
         gtk_box_pack_start(GTK_BOX(main_box), search_box, FALSE, FALSE, 0);
     }
     
@@ -282,16 +428,17 @@ void on_edit_employee_clicked(GtkCellRenderer *renderer, gchar *path_str, gpoint
     (void)renderer;
     (void)user_data;
     
+    GtkTreeModel *model = gtk_tree_view_get_model(GTK_TREE_VIEW(employee_table));
     GtkTreeIter iter;
-    if (!gtk_tree_model_get_iter_from_string(GTK_TREE_MODEL(employee_store), &iter, path_str)) {
+    if (!gtk_tree_model_get_iter_from_string(model, &iter, path_str)) {
         return;
     }
     
     int emp_id;
-    gtk_tree_model_get(GTK_TREE_MODEL(employee_store), &iter, 2, &emp_id, -1);
+    gtk_tree_model_get(model, &iter, 2, &emp_id, -1);
     
     if (db_get_employee_by_id(emp_id, &current_emp) <= 0) {
-        printf("[ERROR] Could not load employee %d\n", emp_id);
+        LOG_ERROR("Could not load employee %d", emp_id);
         return;
     }
     
@@ -313,8 +460,8 @@ void on_edit_employee_clicked(GtkCellRenderer *renderer, gchar *path_str, gpoint
     snprintf(rep_id_str, sizeof(rep_id_str), "%d", current_emp.reporting_person_id);
     gtk_entry_set_text(GTK_ENTRY(reporting_person_id_entry), rep_id_str);
     
-    char salary_str[20];
-    snprintf(salary_str, sizeof(salary_str), "%.2f", current_emp.base_salary);
+    char salary_str[MONEY_TEXT_SIZE];
+    money_format(current_emp.base_salary, salary_str, sizeof(salary_str));
     gtk_entry_set_text(GTK_ENTRY(salary_entry), salary_str);
     
     gtk_entry_set_text(GTK_ENTRY(account_holder_entry), current_bank.account_holder_name);
@@ -325,7 +472,7 @@ void on_edit_employee_clicked(GtkCellRenderer *renderer, gchar *path_str, gpoint
     
     editing_emp_id = emp_id;
     gtk_widget_show_all(form_box);
-    printf("[INFO] Editing employee %d\n", emp_id);
+    LOG_INFO("Editing employee %d", emp_id);
 }
 
 // Delete button callback
@@ -333,13 +480,14 @@ void on_delete_employee_clicked(GtkCellRenderer *renderer, gchar *path_str, gpoi
     (void)renderer;
     (void)user_data;
     
+    GtkTreeModel *model = gtk_tree_view_get_model(GTK_TREE_VIEW(employee_table));
     GtkTreeIter iter;
-    if (!gtk_tree_model_get_iter_from_string(GTK_TREE_MODEL(employee_store), &iter, path_str)) {
+    if (!gtk_tree_model_get_iter_from_string(model, &iter, path_str)) {
         return;
     }
     
     int emp_id;
-    gtk_tree_model_get(GTK_TREE_MODEL(employee_store), &iter, 2, &emp_id, -1);
+    gtk_tree_model_get(model, &iter, 2, &emp_id, -1);
     
     GtkWidget *dialog = gtk_message_dialog_new(NULL, GTK_DIALOG_MODAL, GTK_MESSAGE_QUESTION, GTK_BUTTONS_YES_NO,
         "Delete employee %d?", emp_id);
@@ -370,7 +518,7 @@ void on_row_activated(GtkTreeView *treeview, GtkTreePath *path, GtkTreeViewColum
     if (col_num == 0) {
         // Edit column clicked - load employee into form
         if (db_get_employee_by_id(emp_id, &current_emp) <= 0) {
-            printf("[ERROR] Could not load employee %d\n", emp_id);
+            LOG_ERROR("Could not load employee %d", emp_id);
             return;
         }
         db_get_bank_details(emp_id, &current_bank);
@@ -390,8 +538,8 @@ void on_row_activated(GtkTreeView *treeview, GtkTreePath *path, GtkTreeViewColum
         snprintf(rep_id_str, sizeof(rep_id_str), "%d", current_emp.reporting_person_id);
         gtk_entry_set_text(GTK_ENTRY(reporting_person_id_entry), rep_id_str);
         
-        char salary_str[20];
-        snprintf(salary_str, sizeof(salary_str), "%.2f", current_emp.base_salary);
+        char salary_str[MONEY_TEXT_SIZE];
+        money_format(current_emp.base_salary, salary_str, sizeof(salary_str));
         gtk_entry_set_text(GTK_ENTRY(salary_entry), salary_str);
         
         gtk_entry_set_text(GTK_ENTRY(account_holder_entry), current_bank.account_holder_name);
@@ -402,7 +550,7 @@ void on_row_activated(GtkTreeView *treeview, GtkTreePath *path, GtkTreeViewColum
         
         editing_emp_id = emp_id;
         gtk_widget_show_all(form_box);
-        printf("[INFO] Editing employee %d\n", emp_id);
+        LOG_INFO("Editing employee %d", emp_id);
         
     } else if (col_num == 1) {
         // Delete column clicked
@@ -427,7 +575,7 @@ void setup_employee_table_styling(GtkTreeView *tree_view) {
 }
 
 void create_employee_ui(GtkWidget *container) {
-    printf("[INFO] Creating Employee Management UI\n");
+    LOG_INFO("Creating Employee Management UI");
     
     main_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 10);
     gtk_container_add(GTK_CONTAINER(container), main_box);
@@ -591,14 +739,9 @@ void create_employee_ui(GtkWidget *container) {
     // ============================================
     // TABLE SECTION
     // ============================================
-    employee_store = gtk_list_store_new(16,
-        G_TYPE_STRING, G_TYPE_STRING, G_TYPE_INT, G_TYPE_STRING,
-        G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING,
-        G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING,
-        G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING);
-    
-    employee_table = gtk_tree_view_new_with_model(GTK_TREE_MODEL(employee_store));
-    g_object_unref(employee_store);
+    // The model is attached by refresh_employee_list()
+    employee_table = gtk_tree_view_new();
+    employee_store = gtk_list_store_newv(EMPLOYEE_COLUMNS, (GType *)employee_column_types);
 
     setup_employee_table_styling(GTK_TREE_VIEW(employee_table));
     
@@ -623,12 +766,18 @@ void create_employee_ui(GtkWidget *container) {
             // Data columns
             col = gtk_tree_view_column_new_with_attributes(titles[i], text_renderer, "text", i + 1, NULL);
             gtk_tree_view_column_set_min_width(col, 80);
+            gtk_tree_view_column_set_fixed_width(col, 110);
+            gtk_tree_view_column_set_sizing(col, GTK_TREE_VIEW_COLUMN_FIXED);
             gtk_tree_view_column_set_resizable(col, TRUE);  // ✅ Resizable
         }
         
         gtk_tree_view_append_column(GTK_TREE_VIEW(employee_table), col);
     }
 
+    // Fixed-width columns let the view skip measuring rows, so it reads
+    // only the model pages on screen
+    gtk_tree_view_set_fixed_height_mode(GTK_TREE_VIEW(employee_table), TRUE);
+
     // Connect signal ONCE
     g_signal_connect(employee_table, "row-activated", G_CALLBACK(on_row_activated), NULL);
     
@@ -643,5 +792,5 @@ void create_employee_ui(GtkWidget *container) {
     gtk_widget_show_all(main_box);
     gtk_widget_hide(form_box);
     refresh_employee_list();
-    printf("[SUCCESS] Employee UI created\n");
+    LOG_SUCCESS("Employee UI created");
 }
@@ -4,6 +4,11 @@
 #include <glib.h>
 #include "../../include/fee_ui.h"
 #include "../../include/database.h"
+#include "../../include/db_async.h"
+#include "../../include/db_tree_model.h"
+#include "../../include/table_fill.h"
+#include "../../include/photo_cache.h"
+#include "../../include/logger.h"
 
 // Global variables
 static GtkWidget *fee_table = NULL;
@@ -28,8 +33,33 @@ static GtkWidget *form_other_paid_entry = NULL;
 static GtkWidget *form_other_date_entry = NULL;
 static GtkWidget *form_other_mode_entry = NULL;
 
+// Student ID card, shown once the roll number matches a student
+static GtkWidget *card_box = NULL;
+static GtkWidget *card_photo = NULL;
+static GtkWidget *card_details = NULL;
+
 static FeeRecord current_fee_form;
 
+// The fee table is a virtual model over db_fee_summary_list_sql: rows are
+// read a page at a time as the view scrolls to them, each page keyed on the
+// previous page's last roll_no (db_fee_summary_page_sql)
+#define FEE_COLUMNS 9
+
+static const GType fee_column_types[FEE_COLUMNS] = {
+    G_TYPE_STRING,  // 0: Edit
+    G_TYPE_STRING,  // 1: Delete
+    G_TYPE_STRING,  // 2: Roll No
+    G_TYPE_STRING,  // 3: Name
+    G_TYPE_STRING,  // 4: Institute
+    G_TYPE_STRING,  // 5: Hostel
+    G_TYPE_STRING,  // 6: Mess
+    G_TYPE_STRING,  // 7: Other
+    G_TYPE_STRING   // 8: Total
+};
+
+static GCancellable *fee_load = NULL;          // row count in flight
+static gboolean fee_table_stale = FALSE;       // a load was cut short by a tab switch
+
 // ============================================================================
 // Helper Functions
 // ============================================================================
@@ -54,29 +84,71 @@ static void clear_form(void) {
     gtk_entry_set_text(GTK_ENTRY(form_other_date_entry), "");
     gtk_entry_set_text(GTK_ENTRY(form_other_mode_entry), "");
     
+    gtk_widget_hide(card_box);
     gtk_widget_hide(error_label);
 }
 
+// Looks the student up as the roll number is typed; the photo comes from
+// the thumbnail cache, so flipping between students reads nothing twice
+static void on_form_roll_changed(GtkEditable *editable, gpointer user_data) {
+    (void)user_data;
+    const char *roll = gtk_entry_get_text(GTK_ENTRY(editable));
+    StudentIDCard card;
+
+    if (strlen(roll) != 13 || !db_get_student_for_card_by_roll(roll, &card)) {
+        gtk_widget_hide(card_box);
+        return;
+    }
+
+    GdkPixbuf *thumbnail = photo_cache_get(card.student_id);
+    if (thumbnail != NULL) {
+        gtk_image_set_from_pixbuf(GTK_IMAGE(card_photo), thumbnail);
+        g_object_unref(thumbnail);
+    } else {
+        gtk_image_set_from_icon_name(GTK_IMAGE(card_photo), "avatar-default", GTK_ICON_SIZE_DIALOG);
+    }
+
+    char *markup = g_markup_printf_escaped(
+        "<span weight='bold'>%s</span>\n"
+        "S/o, D/o: %s\n"
+        "%s · Year %d · Semester %d\n"
+        "%s · 📞 %s",
+        card.name, card.father_name, card.branch, card.year, card.semester,
+        card.category, card.mobile);
+    gtk_label_set_markup(GTK_LABEL(card_details), markup);
+    g_free(markup);
+
+    gtk_widget_show_all(card_box);
+}
+
+// Empty means nothing paid; returns 0 if the text is not an amount
+static int get_amount_entry(GtkWidget *entry, Money *out) {
+    const char *text = gtk_entry_get_text(GTK_ENTRY(entry));
+
+    *out = 0;
+    return text == NULL || text[0] == '\0' || money_parse(text, out);
+}
+
 // ✅ FIXED: Remove all *_due field references
 static void load_add_fee_data(void) {
-    char text[64];
+    char text[MONEY_TEXT_SIZE];
 
-    printf("[INFO] Loading fee data into form\n");
+    LOG_INFO("Loading fee data into form");
 
     // Institute paid ONLY
-    snprintf(text, sizeof(text), "%.2f", current_fee_form.institute_paid);
+    money_format(current_fee_form.institute_paid, text, sizeof(text));
     gtk_entry_set_text(GTK_ENTRY(form_inst_paid_entry), text);
 
     // Hostel paid ONLY
-    snprintf(text, sizeof(text), "%.2f", current_fee_form.hostel_paid);
+    money_format(current_fee_form.hostel_paid, text, sizeof(text));
     gtk_entry_set_text(GTK_ENTRY(form_hostel_paid_entry), text);
 
     // Mess paid ONLY
-    snprintf(text, sizeof(text), "%.2f", current_fee_form.mess_paid);
+    money_format(current_fee_form.mess_paid, text, sizeof(text));
     gtk_entry_set_text(GTK_ENTRY(form_mess_paid_entry), text);
 
     // Other paid ONLY
-    snprintf(text, sizeof(text), "%.2f", current_fee_form.other_paid);
+    money_format(current_fee_form.other_paid, text, sizeof(text));
     gtk_entry_set_text(GTK_ENTRY(form_other_paid_entry), text);
 
     // Set dates and modes if they exist
@@ -101,54 +173,98 @@ static void load_add_fee_data(void) {
         current_fee_form.other_mode[0] != '\0' ? current_fee_form.other_mode : "");
 }
 
-static void refresh_fee_table(void) {
-    printf("[INFO] Refreshing fee table\n");
+// Fills one cell of the fee table; columns follow db_fee_summary_list_sql
+static void fee_model_value(const DbAsyncChunk *page, int row, int column, GValue *value, gpointer user_data) {
+    (void)user_data;
+
+    switch (column) {
+        case 0:
+            g_value_set_string(value, "✏️");
+            break;
+        case 1:
+            g_value_set_string(value, "🗑️");
+            break;
+        case 2: {
+            const char *roll_no = db_async_text(page, row, 2);
+            g_value_set_string(value, roll_no ? roll_no : "");
+            break;
+        }
+        case 3: {
+            const char *name = db_async_text(page, row, 1);
+            g_value_set_string(value, name ? name : "");
+            break;
+        }
+        default: {
+            // 4-8: institute, hostel, mess, other and total paid
+            char amount[MONEY_TEXT_SIZE];
+            g_value_set_string(value, money_format(db_async_int64(page, row, column + 4), amount, sizeof(amount)));
+            break;
+        }
+    }
+}
 
-    GtkListStore *store = GTK_LIST_STORE(gtk_tree_view_get_model(GTK_TREE_VIEW(fee_table)));
-    if (!store) {
-        printf("[ERROR] Fee table store is NULL\n");
+static void fill_fee_placeholder(GtkListStore *store, gpointer user_data) {
+    (void)user_data;
+    gtk_list_store_insert_with_values(store, NULL, -1,
+        0, "—", 1, "—", 2, "—", 3, "No records", 4, "—", 5, "—", 6, "—",
+        -1);
+}
+
+static void on_fee_model_ready(DbTreeModel *model, GCancellable *load, gboolean cancelled, gpointer user_data) {
+    (void)user_data;
+
+    // A refresh has replaced this load
+    if (load != fee_load) {
         return;
     }
+    g_clear_object(&fee_load);
 
-    gtk_list_store_clear(store);
+    if (cancelled) {
+        fee_table_stale = TRUE;
+        LOG_INFO("Fee table load cancelled");
+        return;
+    }
 
-    FeeTableRow *rows = NULL;
-    int row_count = db_get_all_fee_summary_rows(&rows);
+    int total_rows = db_tree_model_get_n_rows(model);
 
-    if (row_count == 0) {
-        printf("[INFO] No fee records found\n");
-        GtkTreeIter iter;
-        gtk_list_store_append(store, &iter);
-        gtk_list_store_set(store, &iter,
-            0, "—", 1, "—", 2, "—", 3, "No records", 4, "—", 5, "—", 6, "—",
-            -1);
+    if (total_rows == 0) {
+        LOG_INFO("No fee records found");
+        GtkListStore *store = gtk_list_store_newv(FEE_COLUMNS, (GType *)fee_column_types);
+        table_fill_list_store(GTK_TREE_VIEW(fee_table), store, fill_fee_placeholder, NULL);
+        g_object_unref(store);
         return;
     }
 
-    for (int i = 0; i < row_count; i++) {
-        FeeTableRow *row = &rows[i];
-        
-        char inst_str[20], hostel_str[20], mess_str[20], other_str[20], total_str[20];
-        snprintf(inst_str, sizeof(inst_str), "%.2f", row->institute_paid);
-        snprintf(hostel_str, sizeof(hostel_str), "%.2f", row->hostel_paid);
-        snprintf(mess_str, sizeof(mess_str), "%.2f", row->mess_paid);
-        snprintf(other_str, sizeof(other_str), "%.2f", row->other_paid);
-        snprintf(total_str, sizeof(total_str), "%.2f", row->total_paid);
-
-        GtkTreeIter iter;
-        gtk_list_store_append(store, &iter);
-        gtk_list_store_set(store, &iter,
-            0, "✏️", 1, "🗑️", 2, row->roll_no, 3, row->student_name,
-            4, inst_str, 5, hostel_str, 6, mess_str, 7, other_str,
-            8, total_str,
-            -1);
+    gtk_tree_view_set_model(GTK_TREE_VIEW(fee_table), GTK_TREE_MODEL(model));
+    LOG_INFO("Loaded %d fee records", total_rows);
+}
+
+static void refresh_fee_table(void) {
+    LOG_INFO("Refreshing fee table");
+
+    if (fee_table == NULL) {
+        LOG_ERROR("Fee table is NULL");
+        return;
     }
 
-    if (rows) {
-        db_free_fee_table_rows(rows);
+    db_async_cancel(&fee_load);
+    fee_table_stale = FALSE;
+
+    DbTreeModel *model = db_tree_model_new(db_fee_summary_list_sql, NULL, FEE_COLUMNS,
+                                           fee_column_types, fee_model_value, NULL);
+    db_tree_model_set_keyset(model, db_fee_summary_page_sql, 2);     // roll_no
+    fee_load = db_tree_model_load(model, on_fee_model_ready, NULL);
+    g_object_unref(model);
+
+    if (fee_load == NULL) {
+        LOG_ERROR("Failed to start fee table load");
     }
+}
 
-    printf("[INFO] Loaded %d fee records\n", row_count);
+void fee_ui_page_shown(void) {
+    if (fee_table_stale) {
+        refresh_fee_table();
+    }
 }
 
 // ============================================================================
@@ -160,7 +276,7 @@ static void on_form_save_clicked(GtkButton *button, gpointer user_data) {
     (void)button;
     (void)user_data;
 
-    printf("[INFO] Save button clicked\n");
+    LOG_INFO("Save button clicked");
 
     FeeRecord fee;
     memset(&fee, 0, sizeof(FeeRecord));
@@ -175,33 +291,34 @@ static void on_form_save_clicked(GtkButton *button, gpointer user_data) {
 
     g_strlcpy(fee.roll_no, roll, sizeof(fee.roll_no));
 
+    if (!get_amount_entry(form_inst_paid_entry, &fee.institute_paid) ||
+        !get_amount_entry(form_hostel_paid_entry, &fee.hostel_paid) ||
+        !get_amount_entry(form_mess_paid_entry, &fee.mess_paid) ||
+        !get_amount_entry(form_other_paid_entry, &fee.other_paid)) {
+        gtk_label_set_text(GTK_LABEL(error_label), "❌ Invalid amount (e.g. 1500 or 1500.50)");
+        gtk_widget_show(error_label);
+        return;
+    }
+
     // Institute fee (paid only)
-    fee.institute_paid = g_strtod(
-        gtk_entry_get_text(GTK_ENTRY(form_inst_paid_entry)), NULL);
     const char *inst_date = gtk_entry_get_text(GTK_ENTRY(form_inst_date_entry));
     const char *inst_mode = gtk_entry_get_text(GTK_ENTRY(form_inst_mode_entry));
     if (inst_date) g_strlcpy(fee.institute_date, inst_date, sizeof(fee.institute_date));
     if (inst_mode) g_strlcpy(fee.institute_mode, inst_mode, sizeof(fee.institute_mode));
 
     // Hostel fee (paid only)
-    fee.hostel_paid = g_strtod(
-        gtk_entry_get_text(GTK_ENTRY(form_hostel_paid_entry)), NULL);
     const char *host_date = gtk_entry_get_text(GTK_ENTRY(form_hostel_date_entry));
     const char *host_mode = gtk_entry_get_text(GTK_ENTRY(form_hostel_mode_entry));
     if (host_date) g_strlcpy(fee.hostel_date, host_date, sizeof(fee.hostel_date));
     if (host_mode) g_strlcpy(fee.hostel_mode, host_mode, sizeof(fee.hostel_mode));
 
     // Mess fee (paid only)
-    fee.mess_paid = g_strtod(
-        gtk_entry_get_text(GTK_ENTRY(form_mess_paid_entry)), NULL);
     const char *mess_date = gtk_entry_get_text(GTK_ENTRY(form_mess_date_entry));
     const char *mess_mode = gtk_entry_get_text(GTK_ENTRY(form_mess_mode_entry));
     if (mess_date) g_strlcpy(fee.mess_date, mess_date, sizeof(fee.mess_date));
     if (mess_mode) g_strlcpy(fee.mess_mode, mess_mode, sizeof(fee.mess_mode));
 
     // Other fee (paid only)
-    fee.other_paid = g_strtod(
-        gtk_entry_get_text(GTK_ENTRY(form_other_paid_entry)), NULL);
     const char *other_date = gtk_entry_get_text(GTK_ENTRY(form_other_date_entry));
     const char *other_mode = gtk_entry_get_text(GTK_ENTRY(form_other_mode_entry));
     if (other_date) g_strlcpy(fee.other_date, other_date, sizeof(fee.other_date));
@@ -214,12 +331,12 @@ static void on_form_save_clicked(GtkButton *button, gpointer user_data) {
     // ✅ FIXED: status is char array, not int
     g_strlcpy(fee.status, "Submitted", sizeof(fee.status));
 
-    printf("[INFO] Saving fee record for roll: %s (Total: %.2f)\n", 
-           fee.roll_no, fee.total_paid);
+    LOG_INFO("Saving fee record for roll: %s (Total: " MONEY_FMT ")", 
+             fee.roll_no, MONEY_ARGS(fee.total_paid));
 
     // Save to database
     if (db_save_fee_record(&fee)) {
-        printf("[SUCCESS] Fee record saved successfully\n");
+        LOG_SUCCESS("Fee record saved successfully");
         gtk_label_set_text(GTK_LABEL(error_label), 
             "✅ Fee record saved successfully!");
         gtk_widget_show(error_label);
@@ -227,7 +344,7 @@ static void on_form_save_clicked(GtkButton *button, gpointer user_data) {
         clear_form();
         refresh_fee_table();
     } else {
-        printf("[ERROR] Failed to save fee record\n");
+        LOG_ERROR("Failed to save fee record");
         gtk_label_set_text(GTK_LABEL(error_label), 
             "❌ Database error: Failed to save fee record");
         gtk_widget_show(error_label);
@@ -238,7 +355,7 @@ static void on_form_cancel_clicked(GtkButton *button, gpointer user_data) {
     (void)button;
     (void)user_data;
 
-    printf("[INFO] Cancel button clicked\n");
+    LOG_INFO("Cancel button clicked");
     clear_form();
     gtk_widget_hide(form_box);
 }
@@ -248,7 +365,7 @@ void on_add_fee_clicked(GtkButton *button, gpointer user_data) {
     (void)button;
     (void)user_data;
 
-    printf("[INFO] Add fee button clicked\n");
+    LOG_INFO("Add fee button clicked");
 
     if (gtk_widget_get_visible(form_box)) {
         gtk_widget_hide(form_box);
@@ -257,6 +374,7 @@ void on_add_fee_clicked(GtkButton *button, gpointer user_data) {
         load_add_fee_data();
         gtk_widget_show_all(form_box);
         gtk_widget_hide(error_label);
+        on_form_roll_changed(GTK_EDITABLE(form_roll_entry), NULL);
         gtk_widget_grab_focus(form_roll_entry);
     }
 }
@@ -266,7 +384,7 @@ void on_refresh_clicked(GtkButton *button, gpointer user_data) {
     (void)button;
     (void)user_data;
 
-    printf("[INFO] Refresh button clicked\n");
+    LOG_INFO("Refresh button clicked");
     refresh_fee_table();
 }
 
@@ -274,7 +392,7 @@ static void on_delete_fee_clicked(GtkButton *button, gpointer user_data) {
     (void)button;
     (void)user_data;
 
-    printf("[INFO] Delete button clicked\n");
+    LOG_INFO("Delete button clicked");
 
     GtkTreeView *tree = GTK_TREE_VIEW(fee_table);
     GtkTreeSelection *selection = gtk_tree_view_get_selection(tree);
@@ -287,13 +405,13 @@ static void on_delete_fee_clicked(GtkButton *button, gpointer user_data) {
 
         if (roll_no && strlen(roll_no) > 0) {
             if (db_delete_fee_record(roll_no)) {
-                printf("[SUCCESS] Fee record deleted: %s\n", roll_no);
+                LOG_SUCCESS("Fee record deleted: %s", roll_no);
                 gtk_label_set_text(GTK_LABEL(error_label), 
                     "✅ Fee record deleted successfully!");
                 gtk_widget_show(error_label);
                 refresh_fee_table();
             } else {
-                printf("[ERROR] Failed to delete fee record\n");
+                LOG_ERROR("Failed to delete fee record");
                 gtk_label_set_text(GTK_LABEL(error_label), 
                     "❌ Failed to delete fee record");
                 gtk_widget_show(error_label);
@@ -312,7 +430,7 @@ static void on_delete_fee_clicked(GtkButton *button, gpointer user_data) {
 // ============================================================================
 
 void create_fee_ui(GtkWidget *container) {
-    printf("[INFO] Creating Fee Management UI\n");
+    LOG_INFO("Creating Fee Management UI");
 
     GtkWidget *main_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 10);
     gtk_container_add(GTK_CONTAINER(container), main_box);
@@ -365,6 +483,19 @@ void create_fee_ui(GtkWidget *container) {
     gtk_box_pack_start(GTK_BOX(form_box), error_label, FALSE, FALSE, 0);
     gtk_widget_hide(error_label);
 
+    // Student ID card
+    card_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 12);
+    gtk_box_pack_start(GTK_BOX(form_box), card_box, FALSE, FALSE, 0);
+
+    card_photo = gtk_image_new();
+    gtk_widget_set_size_request(card_photo, PHOTO_THUMBNAIL_SIZE, PHOTO_THUMBNAIL_SIZE);
+    gtk_box_pack_start(GTK_BOX(card_box), card_photo, FALSE, FALSE, 0);
+
+    card_details = gtk_label_new(NULL);
+    gtk_widget_set_halign(card_details, GTK_ALIGN_START);
+    gtk_label_set_xalign(GTK_LABEL(card_details), 0.0);
+    gtk_box_pack_start(GTK_BOX(card_box), card_details, FALSE, FALSE, 0);
+
     GtkWidget *grid = gtk_grid_new();
     gtk_grid_set_column_spacing(GTK_GRID(grid), 10);
     gtk_grid_set_row_spacing(GTK_GRID(grid), 8);
@@ -377,6 +508,7 @@ void create_fee_ui(GtkWidget *container) {
     form_roll_entry = gtk_entry_new();
     gtk_entry_set_placeholder_text(GTK_ENTRY(form_roll_entry), "2408400100031");
     gtk_grid_attach(GTK_GRID(grid), form_roll_entry, 1, 0, 3, 1);
+    g_signal_connect(form_roll_entry, "changed", G_CALLBACK(on_form_roll_changed), NULL);
 
     // Row 1: Institute Fee - PAID ONLY
     GtkWidget *inst_paid_label = gtk_label_new("Institute Paid:");
@@ -498,20 +630,8 @@ void create_fee_ui(GtkWidget *container) {
         GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
     gtk_box_pack_start(GTK_BOX(main_box), scroll, TRUE, TRUE, 0);
 
-    GtkListStore *store = gtk_list_store_new(9,
-        G_TYPE_STRING,  // 0: Edit
-        G_TYPE_STRING,  // 1: Delete
-        G_TYPE_STRING,  // 2: Roll No
-        G_TYPE_STRING,  // 3: Name
-        G_TYPE_STRING,  // 4: Institute
-        G_TYPE_STRING,  // 5: Hostel
-        G_TYPE_STRING,  // 6: Mess
-        G_TYPE_STRING,  // 7: Other
-        G_TYPE_STRING   // 8: Total
-    );
-
-    fee_table = gtk_tree_view_new_with_model(GTK_TREE_MODEL(store));
-    g_object_unref(G_OBJECT(store));
+    // The model is attached by refresh_fee_table()
+    fee_table = gtk_tree_view_new();
     gtk_tree_view_set_grid_lines(GTK_TREE_VIEW(fee_table), GTK_TREE_VIEW_GRID_LINES_BOTH);
     gtk_container_add(GTK_CONTAINER(scroll), fee_table);
 
@@ -524,18 +644,21 @@ void create_fee_ui(GtkWidget *container) {
     };
     int col_widths[] = {40, 40, 110, 120, 90, 90, 90, 90, 100};
 
-    for (int i = 0; i < 9; i++) {
+    for (int i = 0; i < FEE_COLUMNS; i++) {
         col = gtk_tree_view_column_new_with_attributes(col_titles[i], renderer, "text", i, NULL);
         gtk_tree_view_column_set_fixed_width(col, col_widths[i]);
         gtk_tree_view_column_set_sizing(col, GTK_TREE_VIEW_COLUMN_FIXED);
         gtk_tree_view_append_column(GTK_TREE_VIEW(fee_table), col);
     }
 
+    // Fixed-size rows: only the pages on screen are read from the model
+    gtk_tree_view_set_fixed_height_mode(GTK_TREE_VIEW(fee_table), TRUE);
+
     gtk_widget_show_all(container);
     gtk_widget_hide(form_box);
     gtk_widget_hide(error_label);
 
-    printf("[INFO] Fee Management UI created successfully\n");
+    LOG_INFO("Fee Management UI created successfully");
 
     refresh_fee_table();
 }
\ No newline at end of file
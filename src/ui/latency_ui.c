@@ -0,0 +1,202 @@
+#include <gtk/gtk.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../../include/latency_ui.h"
+#include "../../include/db_latency.h"
+#include "../../include/table_fill.h"
+#include "../../include/logger.h"
+
+enum {
+    LATENCY_COL_KIND,
+    LATENCY_COL_NAME,
+    LATENCY_COL_COUNT,
+    LATENCY_COL_P50,
+    LATENCY_COL_P99,
+    LATENCY_COL_MAX,
+    LATENCY_COLUMNS
+};
+
+#define LATENCY_REFRESH_SECONDS 1
+#define LATENCY_MAX_ROWS 512
+
+static GtkWidget *latency_panel = NULL;
+static GtkWidget *latency_view = NULL;
+static GtkListStore *latency_store = NULL;
+static GtkWidget *latency_status = NULL;
+static guint latency_timer = 0;
+
+typedef struct {
+    DbLatencyStats *stats;
+    int n;
+} LatencyRows;
+
+
+static void latency_fill(GtkListStore *store, gpointer user_data) {
+    const LatencyRows *rows = user_data;
+    const DbLatencyStats *stats = rows->stats;
+
+    for (int i = 0; i < rows->n; i++) {
+        gtk_list_store_insert_with_values(store, NULL, -1,
+            LATENCY_COL_KIND, stats[i].kind == DB_LATENCY_FUNCTION ? "call" : "SQL",
+            LATENCY_COL_NAME, stats[i].name,
+            LATENCY_COL_COUNT, (guint64)stats[i].count,
+            LATENCY_COL_P50, stats[i].p50_ns / 1000.0,
+            LATENCY_COL_P99, stats[i].p99_ns / 1000.0,
+            LATENCY_COL_MAX, stats[i].max_ns / 1000.0,
+            -1);
+    }
+}
+
+static void latency_refresh(void) {
+    LatencyRows rows;
+    rows.stats = g_new(DbLatencyStats, LATENCY_MAX_ROWS);
+    rows.n = db_latency_snapshot(rows.stats, LATENCY_MAX_ROWS);
+
+    table_fill_list_store(GTK_TREE_VIEW(latency_view), latency_store, latency_fill, &rows);
+    g_free(rows.stats);
+}
+
+static gboolean on_latency_timer(gpointer user_data) {
+    (void)user_data;
+
+    if (latency_panel == NULL || !gtk_widget_get_visible(latency_panel)) {
+        latency_timer = 0;
+        return G_SOURCE_REMOVE;
+    }
+    latency_refresh();
+    return G_SOURCE_CONTINUE;
+}
+
+static void on_latency_reset_clicked(GtkButton *button, gpointer user_data) {
+    (void)button;
+    (void)user_data;
+    db_latency_reset();
+    latency_refresh();
+    gtk_label_set_text(GTK_LABEL(latency_status), "Counters reset");
+}
+
+static void on_latency_save_clicked(GtkButton *button, gpointer user_data) {
+    (void)button;
+    (void)user_data;
+
+    char message[256];
+    if (db_latency_dump_json(NULL)) {
+        snprintf(message, sizeof(message), "Saved to %s", DB_LATENCY_JSON_FILE);
+    } else {
+        snprintf(message, sizeof(message), "Could not write %s", DB_LATENCY_JSON_FILE);
+    }
+    gtk_label_set_text(GTK_LABEL(latency_status), message);
+}
+
+// Microsecond columns: one decimal, right-aligned
+static void latency_format_us(GtkTreeViewColumn *col, GtkCellRenderer *renderer,
+                              GtkTreeModel *model, GtkTreeIter *iter, gpointer user_data) {
+    (void)col;
+    gdouble value = 0;
+    char text[32];
+
+    gtk_tree_model_get(model, iter, GPOINTER_TO_INT(user_data), &value, -1);
+    snprintf(text, sizeof(text), "%.1f", value);
+    g_object_set(renderer, "text", text, NULL);
+}
+
+GtkWidget* latency_ui_create_panel(void) {
+    GtkWidget *frame = gtk_frame_new(NULL);
+    gtk_frame_set_shadow_type(GTK_FRAME(frame), GTK_SHADOW_IN);
+
+    GtkWidget *box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 10);
+    gtk_widget_set_margin_start(box, 15);
+    gtk_widget_set_margin_end(box, 15);
+    gtk_widget_set_margin_top(box, 15);
+    gtk_widget_set_margin_bottom(box, 15);
+    gtk_container_add(GTK_CONTAINER(frame), box);
+
+    GtkWidget *header = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 10);
+    gtk_box_pack_start(GTK_BOX(box), header, FALSE, FALSE, 0);
+
+    GtkWidget *title = gtk_label_new(NULL);
+    gtk_label_set_markup(GTK_LABEL(title),
+        "<span font='14' weight='bold' foreground='#333333'>⏱️ Database Latency (µs)</span>");
+    gtk_box_pack_start(GTK_BOX(header), title, FALSE, FALSE, 0);
+
+    GtkWidget *save_btn = gtk_button_new_with_label("💾 Save JSON");
+    g_signal_connect(save_btn, "clicked", G_CALLBACK(on_latency_save_clicked), NULL);
+    gtk_box_pack_end(GTK_BOX(header), save_btn, FALSE, FALSE, 0);
+
+    GtkWidget *reset_btn = gtk_button_new_with_label("🔄 Reset");
+    g_signal_connect(reset_btn, "clicked", G_CALLBACK(on_latency_reset_clicked), NULL);
+    gtk_box_pack_end(GTK_BOX(header), reset_btn, FALSE, FALSE, 0);
+
+    latency_status = gtk_label_new("");
+    gtk_box_pack_end(GTK_BOX(header), latency_status, FALSE, FALSE, 0);
+
+    GtkWidget *scroll = gtk_scrolled_window_new(NULL, NULL);
+    gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(scroll),
+        GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
+    gtk_widget_set_size_request(scroll, -1, 280);
+    gtk_box_pack_start(GTK_BOX(box), scroll, TRUE, TRUE, 0);
+
+    latency_store = gtk_list_store_new(LATENCY_COLUMNS,
+        G_TYPE_STRING, G_TYPE_STRING, G_TYPE_UINT64,
+        G_TYPE_DOUBLE, G_TYPE_DOUBLE, G_TYPE_DOUBLE);
+    gtk_tree_sortable_set_sort_column_id(GTK_TREE_SORTABLE(latency_store),
+        LATENCY_COL_P99, GTK_SORT_DESCENDING);
+
+    latency_view = gtk_tree_view_new_with_model(GTK_TREE_MODEL(latency_store));
+    g_object_unref(latency_store);
+    gtk_tree_view_set_grid_lines(GTK_TREE_VIEW(latency_view), GTK_TREE_VIEW_GRID_LINES_BOTH);
+    gtk_tree_view_set_tooltip_column(GTK_TREE_VIEW(latency_view), LATENCY_COL_NAME);
+    gtk_container_add(GTK_CONTAINER(scroll), latency_view);
+
+    const char *col_titles[] = { "Kind", "Function / SQL", "Count", "p50", "p99", "Max" };
+    int col_widths[] = { 50, 420, 80, 80, 80, 80 };
+
+    for (int i = 0; i < LATENCY_COLUMNS; i++) {
+        GtkCellRenderer *renderer = gtk_cell_renderer_text_new();
+        GtkTreeViewColumn *col;
+
+        if (i >= LATENCY_COL_P50) {
+            g_object_set(renderer, "xalign", 1.0, NULL);
+            col = gtk_tree_view_column_new();
+            gtk_tree_view_column_set_title(col, col_titles[i]);
+            gtk_tree_view_column_pack_start(col, renderer, TRUE);
+            gtk_tree_view_column_set_cell_data_func(col, renderer, latency_format_us,
+                                                    GINT_TO_POINTER(i), NULL);
+        } else {
+            if (i == LATENCY_COL_NAME) {
+                g_object_set(renderer, "ellipsize", PANGO_ELLIPSIZE_END, NULL);
+            }
+            col = gtk_tree_view_column_new_with_attributes(col_titles[i], renderer, "text", i, NULL);
+        }
+        gtk_tree_view_column_set_fixed_width(col, col_widths[i]);
+        gtk_tree_view_column_set_sizing(col, GTK_TREE_VIEW_COLUMN_FIXED);
+        gtk_tree_view_column_set_resizable(col, TRUE);
+        gtk_tree_view_column_set_sort_column_id(col, i);
+        gtk_tree_view_append_column(GTK_TREE_VIEW(latency_view), col);
+    }
+
+    latency_panel = frame;
+    gtk_widget_set_no_show_all(latency_panel, TRUE);
+    return latency_panel;
+}
+
+void latency_ui_toggle(void) {
+    if (latency_panel == NULL) {
+        return;
+    }
+
+    if (gtk_widget_get_visible(latency_panel)) {
+        gtk_widget_hide(latency_panel);
+        LOG_INFO("Latency panel hidden");
+        return;
+    }
+
+    // no_show_all keeps show_all() away from the contents too
+    gtk_widget_set_no_show_all(latency_panel, FALSE);
+    gtk_widget_show_all(latency_panel);
+    latency_refresh();
+    if (latency_timer == 0) {
+        latency_timer = g_timeout_add_seconds(LATENCY_REFRESH_SECONDS, on_latency_timer, NULL);
+    }
+    LOG_INFO("Latency panel shown");
+}
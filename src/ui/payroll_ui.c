@@ -3,6 +3,11 @@
 #include <string.h>
 #include <gtk/gtk.h>
 #include "../../include/payroll.h"
+#include "../../include/payroll_ui.h"
+#include "../../include/payroll_run.h"
+#include "../../include/db_async.h"
+#include "../../include/db_tree_model.h"
+#include "../../include/logger.h"
 
 // Main containers
 static GtkWidget *payroll_main_box = NULL;
@@ -41,7 +46,8 @@ static GtkWidget *net_label = NULL;
 
 // Payroll Table
 static GtkWidget *payroll_tree_view = NULL;
-static GtkListStore *payroll_store = NULL;
+static GCancellable *payroll_load = NULL;      // background row count in flight
+static gboolean payroll_table_stale = FALSE;
 
 // Current payroll being edited
 static Payroll current_payroll = {0};
@@ -53,26 +59,26 @@ static int current_payroll_id = -1;
  * ============================================================================ */
 
 /**
- * Get float value from entry widget, return 0 if empty or invalid
+ * Get amount from entry widget, return 0 if empty or invalid
  */
-static float get_entry_float(GtkWidget *entry) {
-    if (entry == NULL) return 0.0f;
+static Money get_entry_money(GtkWidget *entry) {
+    if (entry == NULL) return 0;
     
     const char *text = gtk_entry_get_text(GTK_ENTRY(entry));
-    if (text == NULL || strlen(text) == 0) return 0.0f;
+    Money amount = 0;
+    if (text == NULL || !money_parse(text, &amount)) return 0;
     
-    return (float)atof(text);
+    return amount;
 }
 
 /**
- * Set entry widget with float value
+ * Set entry widget with amount
  */
-static void set_entry_float(GtkWidget *entry, float value) {
+static void set_entry_money(GtkWidget *entry, Money value) {
     if (entry == NULL) return;
     
-    char buffer[32];
-    snprintf(buffer, sizeof(buffer), "%.2f", value);
-    gtk_entry_set_text(GTK_ENTRY(entry), buffer);
+    char buffer[MONEY_TEXT_SIZE];
+    gtk_entry_set_text(GTK_ENTRY(entry), money_format(value, buffer, sizeof(buffer)));
 }
 
 /**
@@ -82,42 +88,43 @@ static void update_calculations() {
     if (payroll_form_box == NULL) return;
 
     // Read all values from UI
-    current_payroll.house_rent = get_entry_float(hra_entry);
-    current_payroll.medical = get_entry_float(medical_entry);
-    current_payroll.conveyance = get_entry_float(conveyance_entry);
-    current_payroll.dearness_allowance = get_entry_float(da_entry);
-    current_payroll.performance_bonus = get_entry_float(bonus_entry);
-    current_payroll.other_allowances = get_entry_float(other_allow_entry);
-
-    current_payroll.income_tax = get_entry_float(it_entry);
-    current_payroll.provident_fund = get_entry_float(pf_entry);
-    current_payroll.health_insurance = get_entry_float(insurance_entry);
-    current_payroll.loan_deduction = get_entry_float(loan_entry);
-    current_payroll.other_deductions = get_entry_float(other_deduct_entry);
+    current_payroll.house_rent = get_entry_money(hra_entry);
+    current_payroll.medical = get_entry_money(medical_entry);
+    current_payroll.conveyance = get_entry_money(conveyance_entry);
+    current_payroll.dearness_allowance = get_entry_money(da_entry);
+    current_payroll.performance_bonus = get_entry_money(bonus_entry);
+    current_payroll.other_allowances = get_entry_money(other_allow_entry);
+
+    current_payroll.income_tax = get_entry_money(it_entry);
+    current_payroll.provident_fund = get_entry_money(pf_entry);
+    current_payroll.health_insurance = get_entry_money(insurance_entry);
+    current_payroll.loan_deduction = get_entry_money(loan_entry);
+    current_payroll.other_deductions = get_entry_money(other_deduct_entry);
 
     // Calculate totals
-    float total_allow = payroll_calculate_total_allowances(&current_payroll);
-    float total_deduct = payroll_calculate_total_deductions(&current_payroll);
-    float gross = payroll_calculate_gross(&current_payroll);
-    float net = gross - total_deduct;
+    Money total_allow = payroll_calculate_total_allowances(&current_payroll);
+    Money total_deduct = payroll_calculate_total_deductions(&current_payroll);
+    Money gross = payroll_calculate_gross(&current_payroll);
+    Money net = gross - total_deduct;
 
     // Update labels
     char buffer[64];
 
-    snprintf(buffer, sizeof(buffer), "₹ %.2f", total_allow);
+    snprintf(buffer, sizeof(buffer), "₹ " MONEY_FMT, MONEY_ARGS(total_allow));
     gtk_label_set_text(GTK_LABEL(total_allow_label), buffer);
 
-    snprintf(buffer, sizeof(buffer), "₹ %.2f", total_deduct);
+    snprintf(buffer, sizeof(buffer), "₹ " MONEY_FMT, MONEY_ARGS(total_deduct));
     gtk_label_set_text(GTK_LABEL(total_deduct_label), buffer);
 
-    snprintf(buffer, sizeof(buffer), "₹ %.2f", gross);
+    snprintf(buffer, sizeof(buffer), "₹ " MONEY_FMT, MONEY_ARGS(gross));
     gtk_label_set_text(GTK_LABEL(gross_label), buffer);
 
-    snprintf(buffer, sizeof(buffer), "₹ %.2f", net);
+    snprintf(buffer, sizeof(buffer), "₹ " MONEY_FMT, MONEY_ARGS(net));
     gtk_label_set_text(GTK_LABEL(net_label), buffer);
 
-    printf("[DEBUG] Calculations updated: Allowances=%.2f, Deductions=%.2f, Gross=%.2f, Net=%.2f\n",
-           total_allow, total_deduct, gross, net);
+    LOG_DEBUG("Calculations updated: Allowances=" MONEY_FMT ", Deductions=" MONEY_FMT
+              ", Gross=" MONEY_FMT ", Net=" MONEY_FMT,
+              MONEY_ARGS(total_allow), MONEY_ARGS(total_deduct), MONEY_ARGS(gross), MONEY_ARGS(net));
 }
 
 /**
@@ -143,7 +150,7 @@ static void on_employee_combo_changed(GtkComboBox *combo, gpointer user_data) {
     GtkTreeIter iter;
     // Rest of function    
     if (!gtk_combo_box_get_active_iter(combo, &iter)) {
-        printf("[WARNING] No employee selected\n");
+        LOG_WARNING("No employee selected");
         return;
     }
 
@@ -152,7 +159,7 @@ static void on_employee_combo_changed(GtkComboBox *combo, gpointer user_data) {
     char emp_name[100] = "";
     char emp_dept[50] = "";
     char emp_designation[50] = "";
-    float emp_salary = 0.0f;
+    gint64 emp_salary = 0;          // Money, column 4 is G_TYPE_INT64
 
     gtk_tree_model_get(model, &iter,
         0, &emp_id,
@@ -162,7 +169,7 @@ static void on_employee_combo_changed(GtkComboBox *combo, gpointer user_data) {
         4, &emp_salary,
         -1);
 
-    printf("[INFO] Employee selected: ID=%d, Name=%s\n", emp_id, emp_name);
+    LOG_INFO("Employee selected: ID=%d, Name=%s", emp_id, emp_name);
 
     // Update labels
     gtk_label_set_text(GTK_LABEL(emp_name_label), emp_name);
@@ -170,7 +177,7 @@ static void on_employee_combo_changed(GtkComboBox *combo, gpointer user_data) {
     gtk_label_set_text(GTK_LABEL(emp_designation_label), emp_designation);
 
     char buffer[64];
-    snprintf(buffer, sizeof(buffer), "₹ %.2f", emp_salary);
+    snprintf(buffer, sizeof(buffer), "₹ " MONEY_FMT, MONEY_ARGS(emp_salary));
     gtk_label_set_text(GTK_LABEL(emp_salary_label), buffer);
 
     // Store basic salary
@@ -178,18 +185,18 @@ static void on_employee_combo_changed(GtkComboBox *combo, gpointer user_data) {
     current_payroll.basic_salary = emp_salary;
 
     // Clear form for new entry
-    set_entry_float(hra_entry, 0.0f);
-    set_entry_float(medical_entry, 0.0f);
-    set_entry_float(conveyance_entry, 0.0f);
-    set_entry_float(da_entry, 0.0f);
-    set_entry_float(bonus_entry, 0.0f);
-    set_entry_float(other_allow_entry, 0.0f);
-
-    set_entry_float(it_entry, 0.0f);
-    set_entry_float(pf_entry, 0.0f);
-    set_entry_float(insurance_entry, 0.0f);
-    set_entry_float(loan_entry, 0.0f);
-    set_entry_float(other_deduct_entry, 0.0f);
+    set_entry_money(hra_entry, 0);
+    set_entry_money(medical_entry, 0);
+    set_entry_money(conveyance_entry, 0);
+    set_entry_money(da_entry, 0);
+    set_entry_money(bonus_entry, 0);
+    set_entry_money(other_allow_entry, 0);
+
+    set_entry_money(it_entry, 0);
+    set_entry_money(pf_entry, 0);
+    set_entry_money(insurance_entry, 0);
+    set_entry_money(loan_entry, 0);
+    set_entry_money(other_deduct_entry, 0);
 
     update_calculations();
 }
@@ -205,10 +212,19 @@ static void on_calculate_clicked(GtkButton *button, gpointer user_data) {
     (void)button;
     (void)user_data;
     
-    printf("[INFO] Calculate button clicked\n");
+    LOG_INFO("Calculate button clicked");
     // Rest of function
     char error_msg[500] = "";
 
+    // Income tax on the annualised gross, from the slabs of the payroll's
+    // own month so a back-dated entry matches a payroll run for that month
+    gint active_month = gtk_combo_box_get_active(GTK_COMBO_BOX(month_combo));
+    if (active_month >= 0) {
+        gint year = (gint)gtk_spin_button_get_value(GTK_SPIN_BUTTON(year_spin));
+        Money annual = payroll_calculate_gross(&current_payroll) * 12;
+        set_entry_money(it_entry, payroll_calculate_income_tax_for_month(annual, active_month + 1, year));
+    }
+
     // Validate payroll data
     if (!payroll_validate(&current_payroll, error_msg, sizeof(error_msg))) {
         GtkWidget *dialog = gtk_message_dialog_new(NULL,
@@ -227,7 +243,7 @@ static void on_calculate_clicked(GtkButton *button, gpointer user_data) {
     // Update display
     update_calculations();
 
-    printf("[SUCCESS] Payroll calculated successfully\n");
+    LOG_SUCCESS("Payroll calculated successfully");
 }
 
 /**
@@ -237,7 +253,7 @@ static void on_save_payroll_clicked(GtkButton *button, gpointer user_data) {
     (void)button;
     (void)user_data;
     
-    printf("[INFO] Save Payroll button clicked\n");
+    LOG_INFO("Save Payroll button clicked");
     // Rest of function
     // Get month/year from combo/spinner
     gint active_month = gtk_combo_box_get_active(GTK_COMBO_BOX(month_combo));
@@ -298,23 +314,23 @@ static void on_reset_clicked(GtkButton *button, gpointer user_data) {
     (void)button;
     (void)user_data;
     
-    printf("[INFO] Reset button clicked\n");
+    LOG_INFO("Reset button clicked");
     // Rest of function
     gtk_combo_box_set_active(GTK_COMBO_BOX(employee_combo), -1);
     gtk_combo_box_set_active(GTK_COMBO_BOX(month_combo), -1);
 
-    set_entry_float(hra_entry, 0.0f);
-    set_entry_float(medical_entry, 0.0f);
-    set_entry_float(conveyance_entry, 0.0f);
-    set_entry_float(da_entry, 0.0f);
-    set_entry_float(bonus_entry, 0.0f);
-    set_entry_float(other_allow_entry, 0.0f);
+    set_entry_money(hra_entry, 0);
+    set_entry_money(medical_entry, 0);
+    set_entry_money(conveyance_entry, 0);
+    set_entry_money(da_entry, 0);
+    set_entry_money(bonus_entry, 0);
+    set_entry_money(other_allow_entry, 0);
 
-    set_entry_float(it_entry, 0.0f);
-    set_entry_float(pf_entry, 0.0f);
-    set_entry_float(insurance_entry, 0.0f);
-    set_entry_float(loan_entry, 0.0f);
-    set_entry_float(other_deduct_entry, 0.0f);
+    set_entry_money(it_entry, 0);
+    set_entry_money(pf_entry, 0);
+    set_entry_money(insurance_entry, 0);
+    set_entry_money(loan_entry, 0);
+    set_entry_money(other_deduct_entry, 0);
 
     gtk_label_set_text(GTK_LABEL(emp_name_label), "---");
     gtk_label_set_text(GTK_LABEL(emp_dept_label), "---");
@@ -335,7 +351,7 @@ static void on_delete_payroll_clicked(GtkButton *button, gpointer user_data) {
     (void)button;
     (void)user_data;
     
-    printf("[INFO] Delete Payroll button clicked\n");
+    LOG_INFO("Delete Payroll button clicked");
     // Rest of function
     if (current_payroll_id <= 0) {
         GtkWidget *dialog = gtk_message_dialog_new(NULL,
@@ -389,7 +405,7 @@ static void on_mark_paid_clicked(GtkButton *button, gpointer user_data) {
     (void)button;
     (void)user_data;
     
-    printf("[INFO] Mark Paid button clicked\n");
+    LOG_INFO("Mark Paid button clicked");
     // Rest of function
     if (current_payroll_id <= 0) {
         GtkWidget *dialog = gtk_message_dialog_new(NULL,
@@ -422,6 +438,94 @@ static void on_mark_paid_clicked(GtkButton *button, gpointer user_data) {
     }
 }
 
+/**
+ * Run payroll for every active employee for the selected month
+ * Computes a dry run first and asks before writing anything
+ */
+static void on_run_payroll_clicked(GtkButton *button, gpointer user_data) {
+    (void)button;
+    (void)user_data;
+
+    LOG_INFO("Run Payroll button clicked");
+
+    gint active_month = gtk_combo_box_get_active(GTK_COMBO_BOX(month_combo));
+    gint year = (gint)gtk_spin_button_get_value(GTK_SPIN_BUTTON(year_spin));
+
+    const char *months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                            "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+    if (active_month < 0) {
+        GtkWidget *dialog = gtk_message_dialog_new(NULL,
+            GTK_DIALOG_MODAL,
+            GTK_MESSAGE_ERROR,
+            GTK_BUTTONS_OK,
+            "Please select a month");
+        gtk_dialog_run(GTK_DIALOG(dialog));
+        gtk_widget_destroy(dialog);
+        return;
+    }
+
+    char month_year[20];
+    snprintf(month_year, sizeof(month_year), "%s-%d", months[active_month], year);
+
+    PayrollRunStats stats;
+    if (!payroll_run_month(month_year, 1, &stats)) {
+        GtkWidget *dialog = gtk_message_dialog_new(NULL,
+            GTK_DIALOG_MODAL,
+            GTK_MESSAGE_ERROR,
+            GTK_BUTTONS_OK,
+            "Could not prepare the payroll run for %s", month_year);
+        gtk_dialog_run(GTK_DIALOG(dialog));
+        gtk_widget_destroy(dialog);
+        return;
+    }
+
+    if (stats.computed == 0) {
+        GtkWidget *dialog = gtk_message_dialog_new(NULL,
+            GTK_DIALOG_MODAL,
+            GTK_MESSAGE_INFO,
+            GTK_BUTTONS_OK,
+            "Nothing to run for %s\n%d employee(s) already on payroll, %d left out",
+            month_year, stats.already_paid, stats.failed);
+        gtk_dialog_run(GTK_DIALOG(dialog));
+        gtk_widget_destroy(dialog);
+        return;
+    }
+
+    char net[MONEY_TEXT_SIZE];
+    GtkWidget *confirm = gtk_message_dialog_new(NULL,
+        GTK_DIALOG_MODAL,
+        GTK_MESSAGE_QUESTION,
+        GTK_BUTTONS_YES_NO,
+        "Run payroll for %s?\n\n%d employee(s) to pay, net ₹ %s\n"
+        "%d already on payroll, %d left out (see log)",
+        month_year, stats.computed, money_format(stats.total_net, net, sizeof(net)),
+        stats.already_paid, stats.failed);
+
+    gint response = gtk_dialog_run(GTK_DIALOG(confirm));
+    gtk_widget_destroy(confirm);
+
+    if (response != GTK_RESPONSE_YES) {
+        return;
+    }
+
+    int ok = payroll_run_month(month_year, 0, &stats);
+
+    GtkWidget *dialog = gtk_message_dialog_new(NULL,
+        GTK_DIALOG_MODAL,
+        ok ? GTK_MESSAGE_INFO : GTK_MESSAGE_ERROR,
+        GTK_BUTTONS_OK,
+        ok ? "Payroll run complete for %s\n%d payroll record(s) and salary slip(s) written"
+           : "Payroll run for %s failed and was rolled back (%d written)",
+        month_year, stats.written);
+    gtk_dialog_run(GTK_DIALOG(dialog));
+    gtk_widget_destroy(dialog);
+
+    if (ok) {
+        refresh_payroll_table();
+    }
+}
+
 /**
  * Print/View salary slip
  */
@@ -429,7 +533,7 @@ static void on_print_slip_clicked(GtkButton *button, gpointer user_data) {
     (void)button;
     (void)user_data;
     
-    printf("[INFO] Print Slip button clicked\n");
+    LOG_INFO("Print Slip button clicked");
     // Rest of function 
     if (current_payroll_id <= 0) {
         GtkWidget *dialog = gtk_message_dialog_new(NULL,
@@ -477,7 +581,7 @@ static void on_print_slip_clicked(GtkButton *button, gpointer user_data) {
     gint response = gtk_dialog_run(GTK_DIALOG(dialog));
 
     if (response == GTK_RESPONSE_OK) {
-        printf("[INFO] Print functionality would be triggered here\n");
+        LOG_INFO("Print functionality would be triggered here");
         // TODO: Implement actual printing
     }
 
@@ -488,58 +592,108 @@ static void on_print_slip_clicked(GtkButton *button, gpointer user_data) {
  * PAYROLL TABLE FUNCTIONS
  * ============================================================================ */
 
+#define PAYROLL_COLUMNS 6
+
+// payroll_id, emp_id, month_year, basic, net, status
+static const GType payroll_column_types[PAYROLL_COLUMNS] = {
+    G_TYPE_INT,     // payroll_id
+    G_TYPE_INT,     // emp_id
+    G_TYPE_STRING,  // month_year
+    G_TYPE_STRING,  // basic
+    G_TYPE_STRING,  // net
+    G_TYPE_STRING   // status
+};
+
+/**
+ * Fill one cell of the payroll table's virtual model
+ * Columns follow db_payroll_list_sql
+ */
+static void payroll_model_value(const DbAsyncChunk *page, int row, int column, GValue *value, gpointer user_data) {
+    (void)user_data;
+
+    switch (column) {
+        case 0:
+            g_value_set_int(value, db_async_int(page, row, 0));
+            break;
+        case 1:
+            g_value_set_int(value, db_async_int(page, row, 1));
+            break;
+        case 2: {
+            const char *month_year = db_async_text(page, row, 2);
+            g_value_set_string(value, month_year ? month_year : "");
+            break;
+        }
+        case 3:
+        case 4: {
+            char amount[MONEY_TEXT_SIZE];
+            Money paise = db_async_int64(page, row, column == 3 ? 3 : 18);
+            g_value_set_string(value, money_format(paise, amount, sizeof(amount)));
+            break;
+        }
+        case 5: {
+            const char *status = db_async_text(page, row, 21);
+            g_value_set_string(value, status ? status : "");
+            break;
+        }
+    }
+}
+
+/**
+ * Called once the payroll row count has been taken or cancelled
+ * @param load - The load's handle; ignored unless it is still the current load
+ */
+static void on_payroll_model_ready(DbTreeModel *model, GCancellable *load, gboolean cancelled, gpointer user_data) {
+    (void)user_data;
+
+    if (load != payroll_load) {
+        return;
+    }
+    g_clear_object(&payroll_load);
+
+    if (cancelled) {
+        payroll_table_stale = TRUE;
+        LOG_INFO("Payroll table load cancelled");
+        return;
+    }
+
+    gtk_tree_view_set_model(GTK_TREE_VIEW(payroll_tree_view), GTK_TREE_MODEL(model));
+    LOG_SUCCESS("Payroll table refreshed: %d records", db_tree_model_get_n_rows(model));
+}
+
 /**
  * Refresh payroll table with current data from database
+ * The rows are counted in the background; the view then reads them a page
+ * at a time as it scrolls
  */
 void refresh_payroll_table() {
-    if (payroll_store == NULL) {
-        fprintf(stderr, "[ERROR] Payroll store is NULL\n");
+    if (payroll_tree_view == NULL) {
+        LOG_ERROR("Payroll table is NULL");
         return;
     }
 
-    printf("[INFO] Refreshing payroll table...\n");
+    LOG_INFO("Refreshing payroll table...");
 
-    // Clear existing data
-    gtk_list_store_clear(payroll_store);
+    // Drop any load still in flight; the old rows stay until the new model is ready
+    db_async_cancel(&payroll_load);
+    payroll_table_stale = FALSE;
 
-    // Get all payroll records from database
-    sqlite3_stmt *stmt = db_get_all_payroll();
+    DbTreeModel *model = db_tree_model_new(db_payroll_list_sql, NULL, PAYROLL_COLUMNS,
+                                           payroll_column_types, payroll_model_value, NULL);
+    payroll_load = db_tree_model_load(model, on_payroll_model_ready, NULL);
+    g_object_unref(model);
 
-    if (stmt == NULL) {
-        fprintf(stderr, "[ERROR] Failed to get payroll records: %s\n",
-                db_payroll_get_error());
-        return;
+    if (payroll_load == NULL) {
+        LOG_ERROR("Failed to start payroll table load");
     }
+}
 
-    int count = 0;
-
-    // Add rows to store
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        GtkTreeIter iter;
-        gtk_list_store_append(payroll_store, &iter);
-
-        int payroll_id = sqlite3_column_int(stmt, 0);
-        int emp_id = sqlite3_column_int(stmt, 1);
-        const char *month_year = (const char *)sqlite3_column_text(stmt, 2);
-        float basic = sqlite3_column_double(stmt, 3);
-        float net = sqlite3_column_double(stmt, 18);
-        const char *status = (const char *)sqlite3_column_text(stmt, 21);
-
-        gtk_list_store_set(payroll_store, &iter,
-            0, payroll_id,
-            1, emp_id,
-            2, month_year,
-            3, basic,
-            4, net,
-            5, status,
-            -1);
-
-        count++;
+/**
+ * Reload the payroll table if its last load was cut short by a tab switch
+ */
+void payroll_ui_page_shown(void) {
+    if (payroll_table_stale) {
+        refresh_payroll_table();
     }
-
-    sqlite3_finalize(stmt);
-
-    printf("[SUCCESS] Payroll table refreshed: %d records\n", count);
 }
 
 /**
@@ -557,25 +711,25 @@ static void on_payroll_row_selected(GtkTreeView *tree_view, GtkTreePath *path,
         int payroll_id = 0;
         gtk_tree_model_get(model, &iter, 0, &payroll_id, -1);
 
-        printf("[INFO] Payroll row selected: ID=%d\n", payroll_id);
+        LOG_INFO("Payroll row selected: ID=%d", payroll_id);
 
         // Load payroll data
         if (db_get_payroll(payroll_id, &current_payroll) == 1) {
             current_payroll_id = payroll_id;
 
             // Update form with payroll data
-            set_entry_float(hra_entry, current_payroll.house_rent);
-            set_entry_float(medical_entry, current_payroll.medical);
-            set_entry_float(conveyance_entry, current_payroll.conveyance);
-            set_entry_float(da_entry, current_payroll.dearness_allowance);
-            set_entry_float(bonus_entry, current_payroll.performance_bonus);
-            set_entry_float(other_allow_entry, current_payroll.other_allowances);
-
-            set_entry_float(it_entry, current_payroll.income_tax);
-            set_entry_float(pf_entry, current_payroll.provident_fund);
-            set_entry_float(insurance_entry, current_payroll.health_insurance);
-            set_entry_float(loan_entry, current_payroll.loan_deduction);
-            set_entry_float(other_deduct_entry, current_payroll.other_deductions);
+            set_entry_money(hra_entry, current_payroll.house_rent);
+            set_entry_money(medical_entry, current_payroll.medical);
+            set_entry_money(conveyance_entry, current_payroll.conveyance);
+            set_entry_money(da_entry, current_payroll.dearness_allowance);
+            set_entry_money(bonus_entry, current_payroll.performance_bonus);
+            set_entry_money(other_allow_entry, current_payroll.other_allowances);
+
+            set_entry_money(it_entry, current_payroll.income_tax);
+            set_entry_money(pf_entry, current_payroll.provident_fund);
+            set_entry_money(insurance_entry, current_payroll.health_insurance);
+            set_entry_money(loan_entry, current_payroll.loan_deduction);
+            set_entry_money(other_deduct_entry, current_payroll.other_deductions);
 
             update_calculations();
         }
@@ -590,10 +744,10 @@ static void on_payroll_row_selected(GtkTreeView *tree_view, GtkTreePath *path,
  * Create main payroll UI
  */
 void create_payroll_ui(GtkWidget *container) {
-    printf("[INFO] Creating Payroll UI...\n");
+    LOG_INFO("Creating Payroll UI...");
 
     if (container == NULL) {
-        fprintf(stderr, "[ERROR] Container is NULL\n");
+        LOG_ERROR("Container is NULL");
         return;
     }
 
@@ -843,22 +997,17 @@ void create_payroll_ui(GtkWidget *container) {
     g_signal_connect(delete_btn, "clicked", G_CALLBACK(on_delete_payroll_clicked), NULL);
     gtk_box_pack_start(GTK_BOX(button_box), delete_btn, FALSE, FALSE, 0);
 
+    GtkWidget *run_btn = gtk_button_new_with_label("⚙️ Run Payroll (All Staff)");
+    g_signal_connect(run_btn, "clicked", G_CALLBACK(on_run_payroll_clicked), NULL);
+    gtk_box_pack_start(GTK_BOX(button_box), run_btn, FALSE, FALSE, 0);
+
     // ===== PAYROLL TABLE =====
     // ===== PAYROLL TABLE =====
     GtkWidget *table_frame = gtk_frame_new("Payroll Records");
     gtk_box_pack_start(GTK_BOX(payroll_main_box), table_frame, TRUE, TRUE, 0);
 
-    // Create list store: payroll_id, emp_id, month_year, basic, net, status
-    payroll_store = gtk_list_store_new(6,
-        G_TYPE_INT,     // payroll_id
-        G_TYPE_INT,     // emp_id
-        G_TYPE_STRING,  // month_year
-        G_TYPE_DOUBLE,  // basic
-        G_TYPE_DOUBLE,  // net
-        G_TYPE_STRING   // status
-    );
-
-    payroll_tree_view = gtk_tree_view_new_with_model(GTK_TREE_MODEL(payroll_store));
+    // The model is attached by refresh_payroll_table()
+    payroll_tree_view = gtk_tree_view_new();
 
     g_signal_connect(payroll_tree_view, "row-activated",
                     G_CALLBACK(on_payroll_row_selected), NULL);
@@ -866,29 +1015,19 @@ void create_payroll_ui(GtkWidget *container) {
     // Add columns
     GtkCellRenderer *renderer = gtk_cell_renderer_text_new();
 
-    GtkTreeViewColumn *col = gtk_tree_view_column_new_with_attributes("ID",
-        renderer, "text", 0, NULL);
-    gtk_tree_view_append_column(GTK_TREE_VIEW(payroll_tree_view), col);
-
-    col = gtk_tree_view_column_new_with_attributes("Emp ID",
-        renderer, "text", 1, NULL);
-    gtk_tree_view_append_column(GTK_TREE_VIEW(payroll_tree_view), col);
+    const char *col_titles[] = { "ID", "Emp ID", "Month/Year", "Basic", "Net Salary", "Status" };
+    int col_widths[] = { 60, 70, 110, 110, 110, 100 };
 
-    col = gtk_tree_view_column_new_with_attributes("Month/Year",
-        renderer, "text", 2, NULL);
-    gtk_tree_view_append_column(GTK_TREE_VIEW(payroll_tree_view), col);
-
-    col = gtk_tree_view_column_new_with_attributes("Basic",
-        renderer, "text", 3, NULL);
-    gtk_tree_view_append_column(GTK_TREE_VIEW(payroll_tree_view), col);
-
-    col = gtk_tree_view_column_new_with_attributes("Net Salary",
-        renderer, "text", 4, NULL);
-    gtk_tree_view_append_column(GTK_TREE_VIEW(payroll_tree_view), col);
+    for (int i = 0; i < PAYROLL_COLUMNS; i++) {
+        GtkTreeViewColumn *col = gtk_tree_view_column_new_with_attributes(col_titles[i],
+            renderer, "text", i, NULL);
+        gtk_tree_view_column_set_fixed_width(col, col_widths[i]);
+        gtk_tree_view_column_set_sizing(col, GTK_TREE_VIEW_COLUMN_FIXED);
+        gtk_tree_view_append_column(GTK_TREE_VIEW(payroll_tree_view), col);
+    }
 
-    col = gtk_tree_view_column_new_with_attributes("Status",
-        renderer, "text", 5, NULL);
-    gtk_tree_view_append_column(GTK_TREE_VIEW(payroll_tree_view), col);
+    // Fixed-size rows: only the model pages on screen are read
+    gtk_tree_view_set_fixed_height_mode(GTK_TREE_VIEW(payroll_tree_view), TRUE);
 
     // ✅ SCROLLING WRAPPER
     GtkWidget *scrolled = gtk_scrolled_window_new(NULL, NULL);
@@ -899,6 +1038,6 @@ void create_payroll_ui(GtkWidget *container) {
 
     gtk_widget_show_all(payroll_main_box);
 
-    printf("[SUCCESS] Payroll UI created successfully\n");
+    LOG_SUCCESS("Payroll UI created successfully");
 
 }
\ No newline at end of file
@@ -0,0 +1,142 @@
+#include <gtk/gtk.h>
+#include <stdio.h>
+#include "../../include/photo_cache.h"
+#include "../../include/database.h"
+#include "../../include/logger.h"
+
+// One decoded thumbnail. The entry embeds its own LRU link, so a hit is a
+// hash lookup plus an O(1) move to the front of the queue.
+typedef struct {
+    GList link;                 // in photo_lru, most recent first; data is the entry
+    int student_id;
+    GdkPixbuf *pixbuf;          // NULL: the student has no photo
+} PhotoCacheEntry;
+
+static GHashTable *photo_index = NULL;      // student_id -> PhotoCacheEntry
+static GQueue photo_lru = G_QUEUE_INIT;
+
+
+static void photo_entry_free(gpointer data) {
+    PhotoCacheEntry *entry = (PhotoCacheEntry *)data;
+
+    g_queue_unlink(&photo_lru, &entry->link);
+    g_clear_object(&entry->pixbuf);
+    g_free(entry);
+}
+
+static void photo_cache_put(int student_id, GdkPixbuf *pixbuf) {
+    if (photo_index == NULL) {
+        photo_index = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, photo_entry_free);
+    }
+
+    PhotoCacheEntry *entry = g_new0(PhotoCacheEntry, 1);
+    entry->link.data = entry;
+    entry->student_id = student_id;
+    entry->pixbuf = pixbuf ? g_object_ref(pixbuf) : NULL;
+
+    // Replacing frees (and unlinks) any older entry for the student
+    g_hash_table_replace(photo_index, GINT_TO_POINTER(student_id), entry);
+    g_queue_push_head_link(&photo_lru, &entry->link);
+
+    while (photo_lru.length > PHOTO_CACHE_CAPACITY) {
+        PhotoCacheEntry *oldest = (PhotoCacheEntry *)photo_lru.tail->data;
+        g_hash_table_remove(photo_index, GINT_TO_POINTER(oldest->student_id));
+    }
+}
+
+static GdkPixbuf* photo_decode(const unsigned char *data, int size) {
+    GdkPixbufLoader *loader = gdk_pixbuf_loader_new();
+    GdkPixbuf *pixbuf = NULL;
+    GError *error = NULL;
+
+    if (gdk_pixbuf_loader_write(loader, data, size, &error) &&
+        gdk_pixbuf_loader_close(loader, &error)) {
+        pixbuf = gdk_pixbuf_loader_get_pixbuf(loader);
+        if (pixbuf != NULL) {
+            g_object_ref(pixbuf);
+        }
+    } else {
+        LOG_WARNING("Stored thumbnail could not be decoded: %s", error->message);
+        g_error_free(error);
+        gdk_pixbuf_loader_close(loader, NULL);
+    }
+
+    g_object_unref(loader);
+    return pixbuf;
+}
+
+GdkPixbuf* photo_cache_get(int student_id) {
+    PhotoCacheEntry *entry = photo_index ? g_hash_table_lookup(photo_index, GINT_TO_POINTER(student_id)) : NULL;
+
+    if (entry != NULL) {
+        g_queue_unlink(&photo_lru, &entry->link);
+        g_queue_push_head_link(&photo_lru, &entry->link);
+        return entry->pixbuf ? g_object_ref(entry->pixbuf) : NULL;
+    }
+
+    unsigned char *data = NULL;
+    int size = 0;
+    GdkPixbuf *pixbuf = NULL;
+
+    if (db_get_student_thumbnail(student_id, &data, &size)) {
+        pixbuf = photo_decode(data, size);
+        g_free(data);
+    }
+
+    photo_cache_put(student_id, pixbuf);
+    return pixbuf;
+}
+
+void photo_cache_invalidate(int student_id) {
+    if (photo_index != NULL) {
+        g_hash_table_remove(photo_index, GINT_TO_POINTER(student_id));
+    }
+}
+
+void photo_cache_clear(void) {
+    if (photo_index != NULL) {
+        g_hash_table_remove_all(photo_index);
+    }
+}
+
+int photo_ingest_file(int student_id, const char *path, char *error, size_t error_len) {
+    GError *gerror = NULL;
+
+    // The only full decode a photo ever gets; loaders that can (JPEG)
+    // decode straight to the smaller size
+    GdkPixbuf *scaled = gdk_pixbuf_new_from_file_at_scale(path, PHOTO_THUMBNAIL_SIZE,
+                                                          PHOTO_THUMBNAIL_SIZE, TRUE, &gerror);
+    if (scaled == NULL) {
+        LOG_ERROR("Cannot read photo %s: %s", path, gerror->message);
+        if (error) snprintf(error, error_len, "Not a readable image: %s", gerror->message);
+        g_error_free(gerror);
+        return 0;
+    }
+
+    // Phone cameras store portrait shots sideways plus an EXIF rotation
+    GdkPixbuf *thumbnail = gdk_pixbuf_apply_embedded_orientation(scaled);
+    g_object_unref(scaled);
+
+    gchar *buffer = NULL;
+    gsize length = 0;
+    if (!gdk_pixbuf_save_to_buffer(thumbnail, &buffer, &length, "png", &gerror, NULL)) {
+        LOG_ERROR("Cannot encode thumbnail: %s", gerror->message);
+        if (error) snprintf(error, error_len, "Could not make a thumbnail");
+        g_error_free(gerror);
+        g_object_unref(thumbnail);
+        return 0;
+    }
+
+    int ok = db_save_student_photo(student_id, path, (const unsigned char *)buffer, (int)length);
+    g_free(buffer);
+
+    if (ok) {
+        photo_cache_put(student_id, thumbnail);
+    } else if (error) {
+        snprintf(error, error_len, "Could not save the photo (at most %d MB)",
+                 DB_PHOTO_MAX_BYTES / (1024 * 1024));
+    }
+
+    g_object_unref(thumbnail);
+    return ok;
+}
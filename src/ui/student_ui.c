@@ -4,7 +4,13 @@
 #include <stdlib.h>
 #include "../../include/student_ui.h"
 #include "../../include/database.h"
+#include "../../include/db_async.h"
+#include "../../include/db_tree_model.h"
+#include "../../include/table_fill.h"
 #include "../../include/validators.h"
+#include "../../include/photo_cache.h"
+#include "../../include/student_index.h"
+#include "../../include/logger.h"
 
 
 // Global variables
@@ -25,63 +31,329 @@ static GtkWidget *search_bar = NULL;
 static GtkWidget *search_entry = NULL;
 
 
-void refresh_student_table() {
-    printf("[INFO] Refreshing student table\n");
+// The full table is a virtual model over db_student_list_sql; its row count
+// is taken in the background, and a count cut short by a tab switch leaves
+// the table stale until the page is shown again. Search results and the
+// empty-table placeholder go into student_store, which has the same columns.
+static GCancellable *student_load = NULL;
+static gboolean student_table_stale = FALSE;
+static GtkListStore *student_store = NULL;
+
+// Search-as-you-type filters the loaded model in memory instead of querying.
+// student_index.c answers with a set of ids, and because the model lists
+// students by student_id DESC, a sorted snapshot of the index's ids maps
+// each one to its row; the filter's visible function then only looks at a
+// row number, so no page is read for rows the view never draws. When the
+// index is still loading or out of step with the table, the search goes to
+// the database as before.
+static DbTreeModel *student_model = NULL;
+static GtkTreeModel *student_filter = NULL;
+static int *student_row_ids = NULL;         // row -> student_id, taken lazily
+static int student_row_id_count = 0;
+static guint8 *student_row_visible = NULL;
+static int student_row_visible_count = 0;
+static GCancellable *student_index_load = NULL;
+static guint student_search_timeout = 0;
+
+#define STUDENT_COLUMNS 13
+#define STUDENT_SEARCH_DELAY_MS 200         // typing pause before filtering
+
+static const GType student_column_types[STUDENT_COLUMNS] = {
+    G_TYPE_STRING,  // 0: Edit
+    G_TYPE_STRING,  // 1: Delete
+    G_TYPE_INT,     // 2: Student ID
+    G_TYPE_STRING,  // 3: Name
+    G_TYPE_STRING,  // 4: Gender
+    G_TYPE_STRING,  // 5: Father Name
+    G_TYPE_STRING,  // 6: Branch
+    G_TYPE_STRING,  // 7: Year
+    G_TYPE_INT,     // 8: Semester
+    G_TYPE_STRING,  // 9: Roll No
+    G_TYPE_STRING,  // 10: Category
+    G_TYPE_STRING,  // 11: Mobile
+    G_TYPE_STRING   // 12: Email
+};
+
+// Query column shown in each table column (db_student_list_sql order)
+static const int student_query_column[STUDENT_COLUMNS] = { -1, -1, 0, 2, 3, 4, 5, 6, 7, 1, 8, 9, 10 };
+
+static void append_student_row(GtkListStore *store, int student_id, const char *roll_no,
+                               const char *name, const char *gender, const char *father,
+                               const char *branch, int year, int semester, const char *category,
+                               const char *mobile, const char *email) {
+    char year_str[20];
+    snprintf(year_str, sizeof(year_str), "%d", year);
+
+    gtk_list_store_insert_with_values(store, NULL, -1,
+        0, "✏️", 1, "🗑️", 2, student_id, 3, name ? name : "—",
+        4, gender ? gender : "—",
+        5, father ? father : "—",
+        6, branch ? branch : "—",
+        7, year_str,
+        8, semester,
+        9, roll_no ? roll_no : "—",
+        10, category ? category : "—",
+        11, mobile ? mobile : "—",
+        12, email ? email : "—",
+        -1);
+}
+
+// Appends every row of a db_get_all_students()-shaped statement and
+// finalizes it; returns the number of rows added
+static int append_student_rows(GtkListStore *store, sqlite3_stmt *stmt) {
+    int count = 0;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        append_student_row(store,
+            sqlite3_column_int(stmt, 0),
+            (const char *)sqlite3_column_text(stmt, 1),
+            (const char *)sqlite3_column_text(stmt, 2),
+            (const char *)sqlite3_column_text(stmt, 3),
+            (const char *)sqlite3_column_text(stmt, 4),
+            (const char *)sqlite3_column_text(stmt, 5),
+            sqlite3_column_int(stmt, 6),
+            sqlite3_column_int(stmt, 7),
+            (const char *)sqlite3_column_text(stmt, 8),
+            (const char *)sqlite3_column_text(stmt, 9),
+            (const char *)sqlite3_column_text(stmt, 10));
+        count++;
+    }
 
-    GtkListStore *store = GTK_LIST_STORE(gtk_tree_view_get_model(GTK_TREE_VIEW(student_table)));
-    if (store) {
-        gtk_list_store_clear(store);
+    sqlite3_finalize(stmt);
+    return count;
+}
+
+// table_fill_list_store() callbacks for student_store
+static void fill_student_rows(GtkListStore *store, gpointer user_data) {
+    sqlite3_stmt *stmt = (sqlite3_stmt *)user_data;
+    if (stmt != NULL) {
+        append_student_rows(store, stmt);
     }
+}
 
-    sqlite3_stmt *stmt = db_get_all_students();
-    if (stmt == NULL) {
-        printf("[WARNING] No students found in database\n");
+static void fill_student_placeholder(GtkListStore *store, gpointer user_data) {
+    (void)user_data;
+    gtk_list_store_insert_with_values(store, NULL, -1,
+        0, "—", 1, "—", 2, 0, 3, "No student added",
+        4, "—", 5, "—", 6, "—", 7, "—", 8, 0, 9, "—", 10, "—", 11, "—", 12, "—",
+        -1);
+}
 
-        GtkTreeIter iter;
-        gtk_list_store_append(store, &iter);
-        gtk_list_store_set(store, &iter,
-            0, "—", 1, "—", 2, "—", 3, 0, 4, "No student added",
-            5, "—", 6, "—", 7, "—", 8, "—", 9, "—", 10, "—", 11, "—", 12, "—",
-            -1);
+// Fills one cell of the virtual model, formatted as append_student_row() does
+static void student_model_value(const DbAsyncChunk *page, int row, int column, GValue *value, gpointer user_data) {
+    (void)user_data;
+    int query_column = student_query_column[column];
+
+    switch (column) {
+        case 0:
+            g_value_set_string(value, "✏️");
+            break;
+        case 1:
+            g_value_set_string(value, "🗑️");
+            break;
+        case 2:
+        case 8:
+            g_value_set_int(value, db_async_int(page, row, query_column));
+            break;
+        case 7:
+            g_value_take_string(value, g_strdup_printf("%d", db_async_int(page, row, query_column)));
+            break;
+        default: {
+            const char *text = db_async_text(page, row, query_column);
+            g_value_set_string(value, text ? text : "—");
+            break;
+        }
+    }
+}
+
+// The search index is loaded once in the background, then kept current by
+// on_add_student_save_clicked()
+static void on_student_index_rows(const DbAsyncChunk *chunk, gpointer user_data) {
+    (void)user_data;
+    for (int row = 0; row < chunk->n_rows; row++) {
+        student_index_load_row(db_async_int(chunk, row, 0), db_async_text(chunk, row, 1),
+                               db_async_text(chunk, row, 2), db_async_text(chunk, row, 3));
+    }
+}
+
+static void student_row_ids_clear(void) {
+    g_clear_pointer(&student_row_ids, g_free);
+    student_row_id_count = 0;
+}
+
+static void on_student_index_loaded(GCancellable *load, int total_rows, gboolean cancelled, gpointer user_data) {
+    (void)total_rows;
+    (void)user_data;
+
+    if (load != student_index_load) {
         return;
     }
+    g_clear_object(&student_index_load);
 
-    int count = 0;
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        int student_id      = sqlite3_column_int(stmt, 0);
-        const char *roll_no = (const char *)sqlite3_column_text(stmt, 1);
-        const char *name    = (const char *)sqlite3_column_text(stmt, 2);
-        const char *gender  = (const char *)sqlite3_column_text(stmt, 3);
-        const char *father  = (const char *)sqlite3_column_text(stmt, 4);
-        const char *branch  = (const char *)sqlite3_column_text(stmt, 5);
-        int year            = sqlite3_column_int(stmt, 6);
-        int semester        = sqlite3_column_int(stmt, 7);
-        const char *category = (const char *)sqlite3_column_text(stmt, 8);
-        const char *mobile  = (const char *)sqlite3_column_text(stmt, 9);
-        const char *email   = (const char *)sqlite3_column_text(stmt, 10);
-
-        char year_str[20];
-        snprintf(year_str, sizeof(year_str), "%d", year);
-
-        GtkTreeIter iter;
-        gtk_list_store_append(store, &iter);
-        gtk_list_store_set(store, &iter,
-            0, "✏️", 1, "🗑️", 2, student_id, 3, name,
-            4, gender ? gender : "—",
-            5, father ? father : "—",
-            6, branch ? branch : "—",
-            7, year_str,
-            8, semester,
-            9, roll_no ? roll_no : "—",
-            10, category ? category : "—",
-            11, mobile ? mobile : "—",
-            12, email ? email : "—",
-            -1);
-        count++;
+    if (cancelled) {
+        LOG_INFO("Student search index load cancelled");
+        return;
     }
+    student_index_load_done();
+    student_row_ids_clear();
+}
 
-    sqlite3_finalize(stmt);
-    printf("[INFO] Loaded %d students from database\n", count);
+static void student_index_reload(void) {
+    db_async_cancel(&student_index_load);
+    student_index_clear();
+    student_row_ids_clear();
+
+    student_index_load = db_async_query(db_student_index_sql, NULL, on_student_index_rows,
+                                        on_student_index_loaded, NULL);
+    if (student_index_load == NULL) {
+        LOG_ERROR("Failed to start student search index load");
+    }
+}
+
+static gboolean student_row_is_visible(GtkTreeModel *model, GtkTreeIter *iter, gpointer user_data) {
+    (void)user_data;
+
+    GtkTreePath *path = gtk_tree_model_get_path(model, iter);
+    int row = gtk_tree_path_get_indices(path)[0];
+    gtk_tree_path_free(path);
+
+    return row < student_row_visible_count && student_row_visible[row];
+}
+
+// The search entry's text, or NULL when the search bar is closed or empty
+static const char* student_search_text(void) {
+    if (search_bar == NULL || !gtk_widget_get_visible(search_bar)) {
+        return NULL;
+    }
+    const char *text = gtk_entry_get_text(GTK_ENTRY(search_entry));
+    return (text != NULL && text[0] != '\0') ? text : NULL;
+}
+
+static void show_search_result(int found) {
+    char message[64];
+    if (found > 0) {
+        snprintf(message, sizeof(message), "✅ %d student(s) found", found);
+    } else {
+        snprintf(message, sizeof(message), "❌ No matching student found");
+    }
+    gtk_label_set_text(GTK_LABEL(error_label), message);
+    gtk_widget_show(error_label);
+}
+
+// Filters the loaded table down to the students matching text. Returns
+// FALSE when the index can't answer for this table, leaving the caller to
+// search the database.
+static gboolean student_live_search(const char *text) {
+    if (student_model == NULL || student_filter == NULL || !student_index_ready()) {
+        return FALSE;
+    }
+
+    int rows = db_tree_model_get_n_rows(student_model);
+    if (student_row_ids == NULL) {
+        student_row_ids = student_index_ids_desc(&student_row_id_count);
+    }
+    if (student_row_id_count != rows) {
+        LOG_DEBUG("Student index has %d students, table %d rows", student_row_id_count, rows);
+        // Changed behind our back rather than mid-refresh: index it again
+        if (student_load == NULL && student_index_load == NULL) {
+            student_index_reload();
+        }
+        return FALSE;
+    }
+
+    GHashTable *matches = student_index_search(text);
+    if (matches == NULL) {
+        return FALSE;
+    }
+
+    g_free(student_row_visible);
+    student_row_visible = g_new(guint8, rows);
+    student_row_visible_count = rows;
+    for (int row = 0; row < rows; row++) {
+        student_row_visible[row] = g_hash_table_contains(matches, GINT_TO_POINTER(student_row_ids[row]));
+    }
+    int found = (int)g_hash_table_size(matches);
+    g_hash_table_unref(matches);
+
+    // Detached while refiltering, so the view doesn't react to every row
+    gtk_tree_view_set_model(GTK_TREE_VIEW(student_table), NULL);
+    gtk_tree_model_filter_refilter(GTK_TREE_MODEL_FILTER(student_filter));
+    gtk_tree_view_set_model(GTK_TREE_VIEW(student_table), student_filter);
+
+    show_search_result(found);
+    LOG_DEBUG("Live search '%s': %d student(s)", text, found);
+    return TRUE;
+}
+
+static void on_student_model_ready(DbTreeModel *model, GCancellable *load, gboolean cancelled, gpointer user_data) {
+    (void)user_data;
+
+    // A newer refresh or a search has replaced this load
+    if (load != student_load) {
+        return;
+    }
+    g_clear_object(&student_load);
+
+    if (cancelled) {
+        student_table_stale = TRUE;
+        LOG_INFO("Student table load cancelled");
+        return;
+    }
+
+    int total_rows = db_tree_model_get_n_rows(model);
+
+    g_clear_object(&student_filter);
+    student_row_ids_clear();
+
+    if (total_rows == 0) {
+        g_clear_object(&student_model);
+        LOG_WARNING("No students found in database");
+        table_fill_list_store(GTK_TREE_VIEW(student_table), student_store, fill_student_placeholder, NULL);
+        return;
+    }
+
+    g_set_object(&student_model, model);
+    student_filter = gtk_tree_model_filter_new(GTK_TREE_MODEL(model), NULL);
+    gtk_tree_model_filter_set_visible_func(GTK_TREE_MODEL_FILTER(student_filter),
+                                           student_row_is_visible, NULL, NULL);
+    LOG_INFO("Loaded %d students from database", total_rows);
+
+    // Keep a search typed while the table was loading
+    const char *search_text = student_search_text();
+    if (search_text != NULL && student_live_search(search_text)) {
+        return;
+    }
+    gtk_tree_view_set_model(GTK_TREE_VIEW(student_table), GTK_TREE_MODEL(model));
+}
+
+void refresh_student_table() {
+    LOG_INFO("Refreshing student table");
+
+    if (student_table == NULL) {
+        return;
+    }
+
+    db_async_cancel(&student_load);
+    student_table_stale = FALSE;
+
+    // The view keeps showing the old rows until the new model is counted
+    DbTreeModel *model = db_tree_model_new(db_student_list_sql, NULL, STUDENT_COLUMNS,
+                                           student_column_types, student_model_value, NULL);
+    student_load = db_tree_model_load(model, on_student_model_ready, NULL);
+    g_object_unref(model);
+
+    if (student_load == NULL) {
+        LOG_ERROR("Failed to start student table load");
+    }
+}
+
+void student_ui_page_shown(void) {
+    if (student_table_stale) {
+        refresh_student_table();
+    }
+    // A load cut short by a tab switch starts over
+    if (!student_index_ready() && student_index_load == NULL) {
+        student_index_reload();
+    }
 }
 
 
@@ -113,16 +385,16 @@ void on_add_student_save_clicked(GtkButton *button, gpointer user_data) {
     const char *mobile_str = gtk_entry_get_text(GTK_ENTRY(mobile_entry));
     const char *email = gtk_entry_get_text(GTK_ENTRY(email_entry));
 
-    printf("[INFO] Add Student - Validating input\n");
-    printf("[DEBUG] Name: %s, Roll: %s, Year: %d, Mobile: %s\n",
-           name, roll_no_str, year, mobile_str);
+    LOG_INFO("Add Student - Validating input");
+    LOG_DEBUG("Name: %s, Roll: %s, Year: %d, Mobile: %s",
+              name, roll_no_str, year, mobile_str);
 
     // VALIDATIONS
     if (!validate_roll_no(roll_no_str)) {
         gtk_label_set_text(GTK_LABEL(error_label),
             "❌ Invalid Roll No (must be 14 digits)");
         gtk_widget_show(error_label);
-        printf("[WARNING] Invalid roll number: %s\n", roll_no_str);
+        LOG_WARNING("Invalid roll number: %s", roll_no_str);
         return;
     }
 
@@ -180,7 +452,7 @@ void on_add_student_save_clicked(GtkButton *button, gpointer user_data) {
         return;
     }
 
-    printf("[INFO] All validations passed - Adding student\n");
+    LOG_INFO("All validations passed - Adding student");
 
     // Call db_add_student without photo parameters
     int result = db_add_student(
@@ -197,7 +469,15 @@ void on_add_student_save_clicked(GtkButton *button, gpointer user_data) {
     );
 
     if (result > 0) {
-        printf("[SUCCESS] Student added with ID: %d\n", result);
+        LOG_SUCCESS("Student added with ID: %d", result);
+
+        // A load still running may have read the table before this row
+        if (student_index_load != NULL) {
+            student_index_reload();
+        } else {
+            student_index_put(result, roll_no_str, name, mobile_str);
+            student_row_ids_clear();
+        }
 
         GtkWidget *dialog = gtk_message_dialog_new(
             NULL, GTK_DIALOG_MODAL,
@@ -216,7 +496,7 @@ void on_add_student_save_clicked(GtkButton *button, gpointer user_data) {
 
         refresh_student_table();
     } else {
-        printf("[ERROR] Failed to add student\n");
+        LOG_ERROR("Failed to add student");
         gtk_label_set_text(GTK_LABEL(error_label),
             "❌ Database error: Failed to add student");
         gtk_widget_show(error_label);
@@ -228,14 +508,14 @@ void on_add_student_clicked(GtkButton *button, gpointer user_data) {
     (void)button;
     (void)user_data;
     
-    printf("[INFO] Add Student button clicked\n");
+    LOG_INFO("Add Student button clicked");
     
     if (gtk_widget_get_visible(form_box)) {
-        printf("[INFO] Hiding form\n");
+        LOG_INFO("Hiding form");
         gtk_widget_hide(form_box);
         gtk_widget_hide(error_label);
     } else {
-        printf("[INFO] Showing form\n");
+        LOG_INFO("Showing form");
         gtk_widget_show_all(form_box);
         gtk_widget_hide(error_label);  // Hide error on new form
         gtk_widget_grab_focus(roll_no_entry);
@@ -243,10 +523,59 @@ void on_add_student_clicked(GtkButton *button, gpointer user_data) {
 }
 
 
+static void show_photo_message(GtkWindow *parent, GtkMessageType type, const char *text) {
+    GtkWidget *dialog = gtk_message_dialog_new(parent, GTK_DIALOG_MODAL, type, GTK_BUTTONS_OK, "%s", text);
+    gtk_dialog_run(GTK_DIALOG(dialog));
+    gtk_widget_destroy(dialog);
+}
+
+// Sets the selected student's photo; the thumbnail is made here, once
+void on_student_photo_clicked(GtkButton *button, gpointer user_data) {
+    (void)user_data;
+    GtkWindow *parent = GTK_WINDOW(gtk_widget_get_toplevel(GTK_WIDGET(button)));
+    GtkTreeSelection *selection = gtk_tree_view_get_selection(GTK_TREE_VIEW(student_table));
+    GtkTreeModel *model = NULL;
+    GtkTreeIter iter;
+    int student_id = 0;
+
+    if (gtk_tree_selection_get_selected(selection, &model, &iter)) {
+        gtk_tree_model_get(model, &iter, 2, &student_id, -1);
+    }
+    if (student_id <= 0) {
+        show_photo_message(parent, GTK_MESSAGE_WARNING, "Select a student first");
+        return;
+    }
+
+    GtkWidget *chooser = gtk_file_chooser_dialog_new("Choose Student Photo", parent,
+        GTK_FILE_CHOOSER_ACTION_OPEN, "_Cancel", GTK_RESPONSE_CANCEL, "_Open", GTK_RESPONSE_ACCEPT, NULL);
+    GtkFileFilter *filter = gtk_file_filter_new();
+    gtk_file_filter_set_name(filter, "Images");
+    gtk_file_filter_add_pixbuf_formats(filter);
+    gtk_file_chooser_add_filter(GTK_FILE_CHOOSER(chooser), filter);
+
+    char *path = NULL;
+    if (gtk_dialog_run(GTK_DIALOG(chooser)) == GTK_RESPONSE_ACCEPT) {
+        path = gtk_file_chooser_get_filename(GTK_FILE_CHOOSER(chooser));
+    }
+    gtk_widget_destroy(chooser);
+    if (path == NULL) {
+        return;
+    }
+
+    char error[256];
+    if (photo_ingest_file(student_id, path, error, sizeof(error))) {
+        show_photo_message(parent, GTK_MESSAGE_INFO, "✅ Photo saved");
+    } else {
+        show_photo_message(parent, GTK_MESSAGE_ERROR, error);
+    }
+    g_free(path);
+}
+
+
 void on_view_students_clicked(GtkButton *button, gpointer user_data) {
     (void)button;
     (void)user_data;
-    printf("[INFO] Refreshing student list\n");
+    LOG_INFO("Refreshing student list");
     refresh_student_table();
 }
 
@@ -255,11 +584,11 @@ void on_search_student_clicked(GtkButton *button, gpointer user_data) {
     (void)button;
     (void)user_data;
     
-    printf("[INFO] Search button clicked\n");
+    LOG_INFO("Search button clicked");
     
     // If search bar exists and is visible, hide it
     if (search_bar && gtk_widget_get_visible(search_bar)) {
-        printf("[INFO] Hiding search bar\n");
+        LOG_INFO("Hiding search bar");
         gtk_widget_hide(search_bar);
         refresh_student_table();
         return;
@@ -267,20 +596,20 @@ void on_search_student_clicked(GtkButton *button, gpointer user_data) {
     
     // Create search bar if it doesn't exist
     if (search_bar == NULL) {
-        printf("[INFO] Creating search bar\n");
+        LOG_INFO("Creating search bar");
         
         search_bar = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 10);
         gtk_container_set_border_width(GTK_CONTAINER(search_bar), 10);
         gtk_widget_set_name(search_bar, "search_bar");
         
         // Label
-        GtkWidget *label = gtk_label_new("🔍 Search by Roll No:");
+        GtkWidget *label = gtk_label_new("🔍 Search Students:");
         gtk_widget_set_size_request(label, 150, -1);
         gtk_box_pack_start(GTK_BOX(search_bar), label, FALSE, FALSE, 0);
         
         // Entry
         search_entry = gtk_entry_new();
-        gtk_entry_set_placeholder_text(GTK_ENTRY(search_entry), "Enter Roll No (e.g., 1001)");
+        gtk_entry_set_placeholder_text(GTK_ENTRY(search_entry), "Name, roll no or mobile");
         gtk_widget_set_size_request(search_entry, 200, -1);
         gtk_box_pack_start(GTK_BOX(search_bar), search_entry, FALSE, FALSE, 0);
         
@@ -295,85 +624,91 @@ void on_search_student_clicked(GtkButton *button, gpointer user_data) {
         gtk_box_pack_start(GTK_BOX(search_bar), clear_btn, FALSE, FALSE, 0);
         
         // Connect signals
+        g_signal_connect(search_entry, "changed", G_CALLBACK(on_student_search_changed), NULL);
+        g_signal_connect(search_entry, "activate", G_CALLBACK(on_search_perform_inline), NULL);
         g_signal_connect(search_btn, "clicked", G_CALLBACK(on_search_perform_inline), NULL);
         g_signal_connect(clear_btn, "clicked", G_CALLBACK(on_search_clear), NULL);
     }
     
     // Show search bar
-    printf("[INFO] Showing search bar\n");
+    LOG_INFO("Showing search bar");
     gtk_widget_show_all(search_bar);
     gtk_widget_grab_focus(search_entry);
 }
 
 
+// Full-text search in the database, for when the index can't answer
+static void student_search_database(const char *search_text) {
+    LOG_INFO("Searching students: %s", search_text);
+    
+    db_async_cancel(&student_load);
+    
+    // Ranked: best matches first
+    sqlite3_stmt *stmt = db_search_students(search_text);
+    int found = table_fill_list_store(GTK_TREE_VIEW(student_table), student_store,
+                                      fill_student_rows, stmt);
+    
+    show_search_result(found);
+    if (found > 0) {
+        LOG_SUCCESS("Found %d student(s)", found);
+    } else {
+        LOG_WARNING("Student not found");
+    }
+}
+
+
+static gboolean on_student_search_timeout(gpointer user_data) {
+    (void)user_data;
+    student_search_timeout = 0;
+
+    const char *search_text = student_search_text();
+    if (search_text == NULL) {
+        return G_SOURCE_REMOVE;
+    }
+    if (!student_live_search(search_text)) {
+        student_search_database(search_text);
+    }
+    return G_SOURCE_REMOVE;
+}
+
+// Filters once typing pauses; clearing the entry shows every student again
+void on_student_search_changed(GtkEditable *editable, gpointer user_data) {
+    (void)editable;
+    (void)user_data;
+
+    if (student_search_timeout != 0) {
+        g_source_remove(student_search_timeout);
+        student_search_timeout = 0;
+    }
+
+    if (student_search_text() != NULL) {
+        student_search_timeout = g_timeout_add(STUDENT_SEARCH_DELAY_MS, on_student_search_timeout, NULL);
+    } else if (student_model != NULL && student_load == NULL) {
+        gtk_tree_view_set_model(GTK_TREE_VIEW(student_table), GTK_TREE_MODEL(student_model));
+        gtk_widget_hide(error_label);
+    }
+}
+
+
 void on_search_perform_inline(GtkButton *button, gpointer user_data) {
     (void)button;
     (void)user_data;
     
-    const char *search_roll_no = gtk_entry_get_text(GTK_ENTRY(search_entry));
+    const char *search_text = gtk_entry_get_text(GTK_ENTRY(search_entry));
     
-    if (!search_roll_no || strlen(search_roll_no) == 0) {
-        gtk_label_set_text(GTK_LABEL(error_label), "❌ Please enter a roll number");
+    if (!search_text || strlen(search_text) == 0) {
+        gtk_label_set_text(GTK_LABEL(error_label), "❌ Please enter a name, roll number or mobile");
         gtk_widget_show(error_label);
         return;
     }
     
-    printf("[INFO] Searching for roll: %s\n", search_roll_no);
-    
-    GtkListStore *store = GTK_LIST_STORE(gtk_tree_view_get_model(GTK_TREE_VIEW(student_table)));
-    gtk_list_store_clear(store);
-    
-    sqlite3_stmt *stmt = db_get_all_students();
-    int found = 0;
-    
-    if (stmt != NULL) {
-        while (sqlite3_step(stmt) == SQLITE_ROW) {
-            int student_id      = sqlite3_column_int(stmt, 0);
-            const char *roll_no = (const char *)sqlite3_column_text(stmt, 1);
-            const char *name    = (const char *)sqlite3_column_text(stmt, 2);
-            const char *gender  = (const char *)sqlite3_column_text(stmt, 3);
-            const char *father  = (const char *)sqlite3_column_text(stmt, 4);
-            const char *branch  = (const char *)sqlite3_column_text(stmt, 5);
-            int year            = sqlite3_column_int(stmt, 6);
-            int semester        = sqlite3_column_int(stmt, 7);
-            const char *category = (const char *)sqlite3_column_text(stmt, 8);
-            const char *mobile  = (const char *)sqlite3_column_text(stmt, 9);
-            const char *email   = (const char *)sqlite3_column_text(stmt, 10);
-
-            // Only add row if roll number MATCHES search
-            if (roll_no && strcmp(roll_no, search_roll_no) == 0) {
-                char year_str[20];
-                snprintf(year_str, sizeof(year_str), "%d", year);
-
-                GtkTreeIter iter;
-                gtk_list_store_append(store, &iter);
-                gtk_list_store_set(store, &iter,
-                    0, "✏️", 1, "🗑️", 2, student_id, 3, name,
-                    4, gender ? gender : "—",
-                    5, father ? father : "—",
-                    6, branch ? branch : "—",
-                    7, year_str,
-                    8, semester,
-                    9, roll_no,
-                    10, category ? category : "—",
-                    11, mobile ? mobile : "—",
-                    12, email ? email : "—",
-                    -1);
-                found++;
-            }
-        }
-        sqlite3_finalize(stmt);
+    // Enter or Find: no need to wait out the typing pause
+    if (student_search_timeout != 0) {
+        g_source_remove(student_search_timeout);
+        student_search_timeout = 0;
     }
-    
-    if (found > 0) {
-        gtk_label_set_text(GTK_LABEL(error_label), "✅ Student found!");
-        gtk_widget_show(error_label);
-        printf("[SUCCESS] Found %d student(s)\n", found);
-    } else {
-        gtk_label_set_text(GTK_LABEL(error_label), 
-            "❌ No student found with this roll number");
-        gtk_widget_show(error_label);
-        printf("[WARNING] Student not found\n");
+    if (!student_live_search(search_text)) {
+        student_search_database(search_text);
     }
 }
 
@@ -382,7 +717,7 @@ void on_search_clear(GtkButton *button, gpointer user_data) {
     (void)button;
     (void)user_data;
     
-    printf("[INFO] Clear search\n");
+    LOG_INFO("Clear search");
     
     gtk_entry_set_text(GTK_ENTRY(search_entry), "");
     gtk_widget_hide(search_bar);
@@ -393,7 +728,7 @@ void on_search_clear(GtkButton *button, gpointer user_data) {
 
 
 void create_student_ui(GtkWidget *container) {
-    printf("[INFO] Creating Student Management UI\n");
+    LOG_INFO("Creating Student Management UI");
     
     GtkWidget *main_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 10);
     gtk_container_add(GTK_CONTAINER(container), main_box);
@@ -424,6 +759,11 @@ void create_student_ui(GtkWidget *container) {
     g_signal_connect(search_btn, "clicked", G_CALLBACK(on_search_student_clicked), NULL);
     gtk_box_pack_start(GTK_BOX(button_box), search_btn, FALSE, FALSE, 0);
     
+    GtkWidget *photo_btn = gtk_button_new_with_label("📷 Photo");
+    gtk_widget_set_size_request(photo_btn, 150, 40);
+    g_signal_connect(photo_btn, "clicked", G_CALLBACK(on_student_photo_clicked), NULL);
+    gtk_box_pack_start(GTK_BOX(button_box), photo_btn, FALSE, FALSE, 0);
+    
     // ====================================================================
     // INLINE ADD STUDENT FORM (Hidden by default)
     // ====================================================================
@@ -573,14 +913,16 @@ void create_student_ui(GtkWidget *container) {
     gtk_box_pack_start(GTK_BOX(main_box), search_bar, FALSE, FALSE, 0);
     gtk_widget_hide(search_bar);
 
-    GtkWidget *search_label = gtk_label_new("🔍 Search by Roll No:");
+    GtkWidget *search_label = gtk_label_new("🔍 Search Students:");
     gtk_widget_set_size_request(search_label, 150, -1);
     gtk_box_pack_start(GTK_BOX(search_bar), search_label, FALSE, FALSE, 0);
 
     search_entry = gtk_entry_new();
-    gtk_entry_set_placeholder_text(GTK_ENTRY(search_entry), "Enter Roll No");
+    gtk_entry_set_placeholder_text(GTK_ENTRY(search_entry), "Name, roll no or mobile");
     gtk_widget_set_size_request(search_entry, 200, -1);
     gtk_box_pack_start(GTK_BOX(search_bar), search_entry, FALSE, FALSE, 0);
+    g_signal_connect(search_entry, "changed", G_CALLBACK(on_student_search_changed), NULL);
+    g_signal_connect(search_entry, "activate", G_CALLBACK(on_search_perform_inline), NULL);
 
     GtkWidget *search_find_btn = gtk_button_new_with_label("🔎 Find");
     gtk_widget_set_size_request(search_find_btn, 100, -1);
@@ -597,24 +939,9 @@ void create_student_ui(GtkWidget *container) {
         GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
     gtk_box_pack_start(GTK_BOX(main_box), scroll, TRUE, TRUE, 0);
     
-    GtkListStore *store = gtk_list_store_new(13,
-        G_TYPE_STRING,  // 0: Edit
-        G_TYPE_STRING,  // 1: Delete
-        G_TYPE_INT,     // 2: Student ID
-        G_TYPE_STRING,  // 3: Name
-        G_TYPE_STRING,  // 4: Gender
-        G_TYPE_STRING,  // 5: Father Name
-        G_TYPE_STRING,  // 6: Branch
-        G_TYPE_STRING,  // 7: Year
-        G_TYPE_INT,     // 8: Semester
-        G_TYPE_STRING,  // 9: Roll No
-        G_TYPE_STRING,  // 10: Category
-        G_TYPE_STRING,  // 11: Mobile
-        G_TYPE_STRING   // 12: Email
-    );
-    
-    student_table = gtk_tree_view_new_with_model(GTK_TREE_MODEL(store));
-    g_object_unref(G_OBJECT(store));
+    // The model is attached by refresh_student_table()
+    student_table = gtk_tree_view_new();
+    student_store = gtk_list_store_newv(STUDENT_COLUMNS, (GType *)student_column_types);
     gtk_tree_view_set_grid_lines(GTK_TREE_VIEW(student_table), GTK_TREE_VIEW_GRID_LINES_BOTH);
     gtk_container_add(GTK_CONTAINER(scroll), student_table);
     
@@ -628,17 +955,22 @@ void create_student_ui(GtkWidget *container) {
     };
     int col_widths[] = {40, 40, 40, 120, 70, 120, 70, 50, 45, 110, 90, 110, 150};
     
-    for (int i = 0; i < 13; i++) {
+    for (int i = 0; i < STUDENT_COLUMNS; i++) {
         col = gtk_tree_view_column_new_with_attributes(col_titles[i], renderer, "text", i, NULL);
         gtk_tree_view_column_set_fixed_width(col, col_widths[i]);
         gtk_tree_view_column_set_sizing(col, GTK_TREE_VIEW_COLUMN_FIXED);
         gtk_tree_view_append_column(GTK_TREE_VIEW(student_table), col);
     }
     
+    // Every column is fixed-width, so rows need not be measured: only the
+    // visible pages of the model are ever read
+    gtk_tree_view_set_fixed_height_mode(GTK_TREE_VIEW(student_table), TRUE);
+    
     gtk_widget_show_all(container);
     gtk_widget_hide(form_box);
     gtk_widget_hide(error_label);
-    printf("[INFO] Student Management UI created successfully\n");
+    LOG_INFO("Student Management UI created successfully");
     
     refresh_student_table();
+    student_index_reload();
 }
\ No newline at end of file
@@ -1,19 +1,413 @@
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include "../../include/logger.h"
 
+// ============================================================================
+// RING BUFFERS
+// One single-producer ring per logging thread; the writer thread is the only
+// consumer. A slot is published by advancing head, freed by advancing tail.
+// ============================================================================
+
+#define LOG_RING_SLOTS      256                 // power of two
+#define LOG_RING_MASK       (LOG_RING_SLOTS - 1)
+#define LOG_TEXT_MAX        480
+#define LOG_WRITER_IDLE_US  5000                // writer poll interval
+#define LOG_DRAIN_BATCH     64                  // records copied out per lock hold
+#define LOG_PATH_MAX        1024
+
+typedef struct {
+    guint64 seq;                // global order across threads
+    gint64 time_us;             // wall clock when logged
+    int level;
+    char text[LOG_TEXT_MAX];
+} LogRecord;
+
+typedef struct LogRing {
+    atomic_size_t head;         // next slot to write (producer)
+    atomic_size_t tail;         // next slot to read (writer)
+    atomic_int closed;          // owning thread has exited
+    struct LogRing *next;
+    LogRecord slots[LOG_RING_SLOTS];
+} LogRing;
+
+atomic_int log_runtime_level = LOG_LEVEL_DEBUG;
+
+static const char *log_level_names[] = { "DEBUG", "INFO", "SUCCESS", "WARNING", "ERROR" };
+
+static void log_ring_release(gpointer data);
+
+static GPrivate log_ring_key = G_PRIVATE_INIT(log_ring_release);
+static GMutex log_rings_lock;           // guards the list, not the slots
+static LogRing *log_rings = NULL;
+
+static atomic_uint_fast64_t log_seq = 0;
+static atomic_ulong log_dropped = 0;
+static atomic_int log_running = 0;
+static atomic_int log_stopping = 0;
+static GThread *log_writer = NULL;
+static int log_exit_registered = 0;
+
+// Writer-thread state
+static LogRecord log_batch[LOG_DRAIN_BATCH];
+static FILE *log_file = NULL;
+static long log_file_bytes = 0;
+static char log_file_path[LOG_PATH_MAX];
+
+
+static void log_ring_release(gpointer data) {
+    // The writer frees the ring once it has drained it
+    LogRing *ring = data;
+    atomic_store_explicit(&ring->closed, 1, memory_order_release);
+}
+
+static LogRing* log_ring_get(void) {
+    LogRing *ring = g_private_get(&log_ring_key);
+    if (ring == NULL) {
+        ring = g_new0(LogRing, 1);
+        g_mutex_lock(&log_rings_lock);
+        ring->next = log_rings;
+        log_rings = ring;
+        g_mutex_unlock(&log_rings_lock);
+        g_private_set(&log_ring_key, ring);
+    }
+    return ring;
+}
+
+// Messages are written one per line; drop the newline callers used to add
+static void log_trim_newline(char *text) {
+    size_t len = strlen(text);
+    if (len > 0 && text[len - 1] == '\n') {
+        text[len - 1] = '\0';
+    }
+}
+
+static void log_write_console(int level, const char *text) {
+    FILE *out = level >= LOG_LEVEL_ERROR ? stderr : stdout;
+    fprintf(out, "[%s] %s\n", log_level_names[level], text);
+}
+
+// Used while the writer thread is not running
+static void log_write_direct(int level, const char *format, va_list args) {
+    char text[LOG_TEXT_MAX];
+    vsnprintf(text, sizeof(text), format, args);
+    log_trim_newline(text);
+    log_write_console(level, text);
+}
+
+
+// ============================================================================
+// LOG FILE
+// ============================================================================
+
+static int log_file_open(void) {
+    gchar *dir = g_path_get_dirname(log_file_path);
+    if (g_mkdir_with_parents(dir, 0755) != 0) {
+        fprintf(stderr, "[WARNING] Cannot create log directory %s\n", dir);
+    }
+    g_free(dir);
+
+    log_file = fopen(log_file_path, "a");
+    if (log_file == NULL) {
+        fprintf(stderr, "[WARNING] Cannot open log file %s, logging to the console only\n",
+                log_file_path);
+        return 0;
+    }
+    fseek(log_file, 0, SEEK_END);
+    log_file_bytes = ftell(log_file);
+    return 1;
+}
+
+// log -> log.1 -> log.2 ... ; the oldest kept copy is overwritten
+static void log_file_rotate(void) {
+    char from[LOG_PATH_MAX + 8], to[LOG_PATH_MAX + 8];
+
+    fclose(log_file);
+    log_file = NULL;
+
+    for (int i = LOG_FILE_KEEP - 1; i >= 1; i--) {
+        snprintf(from, sizeof(from), "%s.%d", log_file_path, i);
+        snprintf(to, sizeof(to), "%s.%d", log_file_path, i + 1);
+        remove(to);
+        rename(from, to);
+    }
+    snprintf(to, sizeof(to), "%s.1", log_file_path);
+    remove(to);
+    rename(log_file_path, to);
+
+    log_file_open();
+}
+
+static void log_file_write(const LogRecord *record) {
+    time_t secs = (time_t)(record->time_us / G_USEC_PER_SEC);
+    struct tm local;
+    char stamp[32];
+
+#ifdef G_OS_WIN32
+    localtime_s(&local, &secs);
+#else
+    localtime_r(&secs, &local);
+#endif
+    strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &local);
+
+    int written = fprintf(log_file, "%s.%03d [%s] %s\n", stamp,
+                          (int)(record->time_us % G_USEC_PER_SEC / 1000),
+                          log_level_names[record->level], record->text);
+    if (written > 0) {
+        log_file_bytes += written;
+    }
+    if (log_file_bytes >= LOG_FILE_MAX_BYTES) {
+        log_file_rotate();
+    }
+}
+
+
+// ============================================================================
+// WRITER THREAD
+// ============================================================================
+
+static void log_emit(const LogRecord *record) {
+    log_write_console(record->level, record->text);
+    if (log_file != NULL) {
+        log_file_write(record);
+    }
+}
+
+// Frees the rings of threads that have exited once they are empty.
+// Called with log_rings_lock held.
+static void log_rings_reap(void) {
+    LogRing **link = &log_rings;
+    while (*link != NULL) {
+        LogRing *ring = *link;
+        if (atomic_load_explicit(&ring->closed, memory_order_acquire) &&
+            atomic_load_explicit(&ring->head, memory_order_acquire) ==
+            atomic_load_explicit(&ring->tail, memory_order_relaxed)) {
+            *link = ring->next;
+            g_free(ring);
+        } else {
+            link = &ring->next;
+        }
+    }
+}
+
+// Copies up to LOG_DRAIN_BATCH records into log_batch, oldest first across
+// all rings, and frees their slots. Returns the number copied.
+static int log_collect(void) {
+    int count = 0;
+
+    g_mutex_lock(&log_rings_lock);
+
+    while (count < LOG_DRAIN_BATCH) {
+        LogRing *oldest = NULL;
+        size_t oldest_tail = 0;
+
+        for (LogRing *ring = log_rings; ring != NULL; ring = ring->next) {
+            size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+            size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+            if (tail != head && (oldest == NULL ||
+                ring->slots[tail & LOG_RING_MASK].seq < oldest->slots[oldest_tail & LOG_RING_MASK].seq)) {
+                oldest = ring;
+                oldest_tail = tail;
+            }
+        }
+        if (oldest == NULL) {
+            log_rings_reap();
+            break;
+        }
+
+        log_batch[count++] = oldest->slots[oldest_tail & LOG_RING_MASK];
+        atomic_store_explicit(&oldest->tail, oldest_tail + 1, memory_order_release);
+    }
+
+    g_mutex_unlock(&log_rings_lock);
+    return count;
+}
+
+// Writes everything buffered, oldest first across all rings. Called by the
+// writer thread, or by log_shutdown() once it has stopped. Records are
+// copied out under the lock and written after it is released, so a thread
+// logging for the first time never waits on the console, the file or a
+// rotation. Returns the number of messages written.
+static int log_drain(void) {
+    int written = 0;
+    int count;
+
+    do {
+        count = log_collect();
+        for (int i = 0; i < count; i++) {
+            log_emit(&log_batch[i]);
+        }
+        written += count;
+    } while (count == LOG_DRAIN_BATCH);
+
+    unsigned long dropped = atomic_exchange(&log_dropped, 0);
+    if (dropped > 0) {
+        LogRecord notice = { 0, g_get_real_time(), LOG_LEVEL_WARNING, "" };
+        snprintf(notice.text, sizeof(notice.text),
+                 "%lu log message(s) dropped, log buffer was full", dropped);
+        log_emit(&notice);
+        written++;
+    }
+
+    if (written > 0) {
+        fflush(stdout);
+        if (log_file != NULL) {
+            fflush(log_file);
+        }
+    }
+    return written;
+}
+
+static gpointer log_writer_main(gpointer data) {
+    (void)data;
+
+    for (;;) {
+        int stopping = atomic_load(&log_stopping);
+        if (log_drain() == 0) {
+            if (stopping) {
+                break;
+            }
+            g_usleep(LOG_WRITER_IDLE_US);
+        }
+    }
+    return NULL;
+}
+
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+int log_level_from_name(const char *name) {
+    if (name == NULL) {
+        return -1;
+    }
+    for (int level = LOG_LEVEL_DEBUG; level < LOG_LEVEL_OFF; level++) {
+        if (g_ascii_strcasecmp(name, log_level_names[level]) == 0) {
+            return level;
+        }
+    }
+    if (g_ascii_strcasecmp(name, "off") == 0) {
+        return LOG_LEVEL_OFF;
+    }
+    return -1;
+}
+
+void log_set_level(LogLevel level) {
+    atomic_store(&log_runtime_level, (int)level);
+}
+
+int log_init(const char *file_path) {
+    if (atomic_load(&log_running)) {
+        return 1;
+    }
+
+    const char *env_level = getenv("CFMS_LOG_LEVEL");
+    if (env_level != NULL) {
+        int level = log_level_from_name(env_level);
+        if (level >= 0) {
+            log_set_level((LogLevel)level);
+        } else {
+            fprintf(stderr, "[WARNING] Unknown CFMS_LOG_LEVEL '%s' ignored\n", env_level);
+        }
+    }
+
+    if (file_path == NULL) {
+        file_path = getenv("CFMS_LOG_FILE");
+    }
+    if (file_path == NULL) {
+        file_path = LOG_DEFAULT_FILE;
+    }
+    if (file_path[0] != '\0') {
+        g_strlcpy(log_file_path, file_path, sizeof(log_file_path));
+        log_file_open();
+    }
+
+    atomic_store(&log_stopping, 0);
+    atomic_store(&log_running, 1);
+    log_writer = g_thread_new("logger", log_writer_main, NULL);
+
+    if (!log_exit_registered) {
+        atexit(log_shutdown);
+        log_exit_registered = 1;
+    }
+    return 1;
+}
+
+void log_shutdown(void) {
+    if (!atomic_exchange(&log_running, 0)) {
+        return;
+    }
+
+    atomic_store(&log_stopping, 1);
+    g_thread_join(log_writer);
+    log_writer = NULL;
+
+    // Anything logged while the writer was stopping
+    log_drain();
+
+    if (log_file != NULL) {
+        fclose(log_file);
+        log_file = NULL;
+    }
+}
+
+void log_write(LogLevel level, const char *format, ...) {
+    va_list args;
+
+    if ((int)level < LOG_LEVEL_DEBUG || level >= LOG_LEVEL_OFF) {
+        return;
+    }
+
+    va_start(args, format);
+
+    if (!atomic_load_explicit(&log_running, memory_order_acquire)) {
+        log_write_direct(level, format, args);
+        va_end(args);
+        return;
+    }
+
+    LogRing *ring = log_ring_get();
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+
+    // Full ring: chatter is dropped, warnings and errors wait for the writer
+    while (head - atomic_load_explicit(&ring->tail, memory_order_acquire) >= LOG_RING_SLOTS) {
+        if (level < LOG_LEVEL_WARNING) {
+            atomic_fetch_add(&log_dropped, 1);
+            va_end(args);
+            return;
+        }
+        if (!atomic_load(&log_running)) {
+            log_write_direct(level, format, args);
+            va_end(args);
+            return;
+        }
+        g_thread_yield();
+    }
+
+    LogRecord *record = &ring->slots[head & LOG_RING_MASK];
+    record->seq = atomic_fetch_add_explicit(&log_seq, 1, memory_order_relaxed);
+    record->time_us = g_get_real_time();
+    record->level = level;
+    vsnprintf(record->text, sizeof(record->text), format, args);
+    log_trim_newline(record->text);
+
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+    va_end(args);
+}
+
 void log_info(const char *message) {
-    printf("[INFO] %s\n", message);     
+    LOG_INFO("%s", message);
 }
 
 void log_error(const char *message) {
-    fprintf(stderr, "[ERROR] %s\n", message);
+    LOG_ERROR("%s", message);
 }
 
 void log_debug(const char *message) {
-    #ifdef DEBUG
-    printf("[DEBUG] %s\n", message);
-    #else
-    (void)message;  // Mark as intentionally unused when DEBUG not defined
-    #endif
-}
\ No newline at end of file
+    LOG_DEBUG("%s", message);
+}
@@ -0,0 +1,92 @@
+#include <stdio.h>
+#include <ctype.h>
+#include "../../include/money.h"
+
+// Whole rupees above this would overflow once scaled to paise
+#define MONEY_MAX_RUPEES (INT64_MAX / MONEY_PAISE_PER_RUPEE)
+
+int money_parse(const char *text, Money *out) {
+    if (text == NULL || out == NULL) {
+        return 0;
+    }
+
+    while (isspace((unsigned char)*text)) text++;
+
+    int negative = 0;
+    if (*text == '-' || *text == '+') {
+        negative = (*text == '-');
+        text++;
+    }
+
+    int64_t rupees = 0;
+    int digits = 0;
+    while (isdigit((unsigned char)*text)) {
+        int digit = *text - '0';
+        if (rupees > (MONEY_MAX_RUPEES - digit) / 10) {
+            return 0;
+        }
+        rupees = rupees * 10 + digit;
+        digits++;
+        text++;
+    }
+
+    int paise = 0;
+    if (*text == '.') {
+        text++;
+        for (int place = 0; isdigit((unsigned char)*text); place++, text++) {
+            if (place == 0) {
+                paise += (*text - '0') * 10;
+            } else if (place == 1) {
+                paise += (*text - '0');
+            } else if (*text != '0') {
+                return 0;       // fractions of a paisa
+            }
+            digits++;
+        }
+    }
+
+    while (isspace((unsigned char)*text)) text++;
+
+    if (digits == 0 || *text != '\0') {
+        return 0;
+    }
+
+    // The paise can still carry the largest rupee count past INT64_MAX
+    if (rupees > (INT64_MAX - paise) / MONEY_PAISE_PER_RUPEE) {
+        return 0;
+    }
+
+    Money amount = rupees * MONEY_PAISE_PER_RUPEE + paise;
+    *out = negative ? -amount : amount;
+    return 1;
+}
+
+const char* money_format(Money amount, char *buffer, size_t buffer_size) {
+    snprintf(buffer, buffer_size, MONEY_FMT, MONEY_ARGS(amount));
+    return buffer;
+}
+
+Money money_percent(Money amount, int basis_points) {
+    Money scaled = amount * basis_points;
+    return scaled >= 0 ? (scaled + 5000) / 10000 : -((-scaled + 5000) / 10000);
+}
+
+Money money_divide(Money amount, int divisor) {
+    Money half = divisor / 2;
+    return amount >= 0 ? (amount + half) / divisor : -((-amount + half) / divisor);
+}
+
+Money money_sum(const Money *values, size_t count) {
+    Money total = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        total += values[i];
+    }
+    return total;
+}
+
+void money_add(Money *restrict totals, const Money *restrict values, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        totals[i] += values[i];
+    }
+}
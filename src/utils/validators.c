@@ -219,8 +219,8 @@ int validate_doa(const char *doa) {
 }
 
 // Salary: positive, minimum 15000
-int validate_salary(double salary) {
-    return (salary > 15000 && salary < 10000000) ? 1 : 0;  // Max 1 crore
+int validate_salary(Money salary) {
+    return (salary > MONEY_RUPEES(15000) && salary < MONEY_RUPEES(10000000)) ? 1 : 0;  // Max 1 crore
 }
 
 // Bank account: 10-18 digits
@@ -267,8 +267,8 @@ int validate_fee_type(const char *fee_type) {
 }
 
 // Amount validation: positive, <= 500,000
-int validate_amount(double amount) {
-    return (amount > 0 && amount <= 500000) ? 1 : 0;
+int validate_amount(Money amount) {
+    return (amount > 0 && amount <= MONEY_RUPEES(500000)) ? 1 : 0;
 }
 
 // Fee status: Pending, Paid, Partial, Overdue
@@ -326,13 +326,13 @@ int validate_payroll_year(int year) {
 }
 
 // Allowance validation: positive, <= 500,000
-int validate_allowance(double allowance) {
-    return (allowance >= 0 && allowance <= 500000) ? 1 : 0;
+int validate_allowance(Money allowance) {
+    return (allowance >= 0 && allowance <= MONEY_RUPEES(500000)) ? 1 : 0;
 }
 
 // Deduction validation: positive, <= 500,000
-int validate_deduction(double deduction) {
-    return (deduction >= 0 && deduction <= 500000) ? 1 : 0;
+int validate_deduction(Money deduction) {
+    return (deduction >= 0 && deduction <= MONEY_RUPEES(500000)) ? 1 : 0;
 }
 
 // Payroll status: Pending, Generated, Approved, Rejected